@@ -8,16 +8,23 @@
 #include "config.hpp"
 #include "macro.hpp"
 #include "utils/build.h"
+#include "utils/caps.h"
 #include "utils/cmd_p.h"
 #include "utils/color.h"
 #include "utils/datatypes.h"
 #include "utils/flags.h"
+#include "utils/fs_index.h"
 #include "utils/log.h"
+#include "utils/logfile.h"
 #include "utils/misc.h"
+#include "utils/ota_url.h"
 #include "utils/modules.h"
+#include "utils/msgpack.h"
 #include "utils/stats.h"
 #include "utils/stats_p.h"
 #include "utils/timer.h"
+#include "utils/wheel.h"
+#include "utils/worker.h"
 
 #ifdef GH_ESP_BUILD
 #include <FS.h>
@@ -25,9 +32,7 @@
 #ifdef ESP8266
 #include <ESP8266WiFi.h>
 #ifndef GH_NO_OTA
-#ifndef GH_NO_OTA_URL
-#include <ESP8266httpUpdate.h>
-#endif
+#include <Updater.h>
 #endif
 #endif
 
@@ -35,9 +40,6 @@
 #include <WiFi.h>
 #ifndef GH_NO_OTA
 #include <Update.h>
-#ifndef GH_NO_OTA_URL
-#include <HTTPUpdate.h>
-#endif
 #endif
 #endif
 
@@ -52,18 +54,33 @@
 #ifdef GH_ASYNC
 #include "async/http.h"
 #include "async/mqtt.h"
+#include "async/stream.h"
+#include "async/udp.h"
 #include "async/ws.h"
 #else
 #include "sync/http.h"
 #include "sync/mqtt.h"
+#include "sync/stream.h"
+#include "sync/udp.h"
 #include "sync/ws.h"
 #endif
 
 #endif
 
+#ifdef GH_POSIX_BUILD
+#include <unistd.h>
+
+#include "posix/http.h"
+#include "posix/mqtt.h"
+#include "posix/udp.h"
+#include "posix/ws.h"
+#endif
+
 // ========================== CLASS ==========================
 #ifdef GH_ESP_BUILD
-class GyverHub : public HubBuilder, public HubHTTP, public HubMQTT, public HubWS {
+class GyverHub : public HubBuilder, public HubHTTP, public HubMQTT, public HubWS, public HubUDP, public HubStream {
+#elif defined(GH_POSIX_BUILD)
+class GyverHub : public HubBuilder, public HubHTTP, public HubMQTT, public HubWS, public HubUDP {
 #else
 class GyverHub : public HubBuilder {
 #endif
@@ -73,13 +90,18 @@ class GyverHub : public HubBuilder {
     // настроить префикс, название и иконку. Опционально задать свой ID устройства (для esp он генерируется автоматически)
     GyverHub(const char* prefix = "", const char* name = "", const char* icon = "", uint32_t id = 0) {
         config(prefix, name, icon, id);
+        disc_t.attach(_discoverTimer, this);
+#if defined(GH_ESP_BUILD) && !defined(GH_NO_FS)
+        fs_t.attach(_fsTimeout, this);
+#endif
     }
 
-    // настроить префикс, название и иконку. Опционально задать свой ID устройства (для esp он генерируется автоматически)
+    // настроить префикс, название и иконку. Опционально задать свой ID устройства (для esp и linux он генерируется автоматически)
     void config(const char* nprefix, const char* nname, const char* nicon, uint32_t nid = 0) {
         prefix = nprefix;
         name = nname;
         icon = nicon;
+        disc_s = "";
 #ifdef GH_ESP_BUILD
         if (nid) ultoa((nid <= 0xfffff) ? (nid + 0xfffff) : nid, id, HEX);
         else {
@@ -88,6 +110,9 @@ class GyverHub : public HubBuilder {
             ultoa(*((uint32_t*)(mac + 2)), id, HEX);
         }
 #else
+#ifdef GH_POSIX_BUILD
+        if (!nid) nid = gethostid();
+#endif
         ultoa((nid <= 0x100000) ? (nid + 0x100000) : nid, id, HEX);
 #endif
     }
@@ -96,7 +121,21 @@ class GyverHub : public HubBuilder {
 
     // запустить
     void begin() {
-#ifdef GH_ESP_BUILD
+        if (!arena.size()) {  // один раз на всё время работы
+            arena.begin(GH_ARENA_SIZE);
+#if defined(GH_ESP_BUILD) && !defined(GH_NO_FS)
+            fs_chunk = (char*)arena.alloc(GH_UPL_CHUNK_SIZE + 10);
+#endif
+            arena.keep();
+        }
+#if defined(GH_ESP_BUILD) && !defined(GH_NO_FS)
+        // арены нет или в ней мало места - чанк один раз берётся из кучи
+        if (!fs_chunk) fs_chunk = (char*)malloc(GH_UPL_CHUNK_SIZE + 10);
+#endif
+#ifdef GH_WORKER
+        worker.begin(_jobWork, _jobOut, this);
+#endif
+#ifdef GH_NET_BUILD
 #ifndef GH_NO_WS
         beginWS();
         beginHTTP();
@@ -104,12 +143,20 @@ class GyverHub : public HubBuilder {
 #ifndef GH_NO_MQTT
         beginMQTT();
 #endif
+#ifndef GH_NO_UDP
+        beginUDP();
+#endif
+#ifndef GH_NO_STREAM
+        beginStream();
+#endif
 #ifndef GH_NO_FS
 #ifdef ESP8266
         fs_mounted = GH_FS.begin();
 #else
         fs_mounted = GH_FS.begin(true);
 #endif
+        // токен докачки живёт только в RAM: временные файлы загрузок, прерванных до перезагрузки, не продолжить
+        if (fs_mounted && !upl_path.length()) GH_fsIndex.removeEnding("/", F(".part"), GH_FS_DEPTH);
 #endif
 #endif
         running_f = true;
@@ -118,7 +165,10 @@ class GyverHub : public HubBuilder {
 
     // остановить
     void end() {
-#ifdef GH_ESP_BUILD
+#ifdef GH_WORKER
+        worker.end();  // отправить очередь, пока подключения открыты
+#endif
+#ifdef GH_NET_BUILD
 #ifndef GH_NO_WS
         endWS();
         endHTTP();
@@ -126,6 +176,12 @@ class GyverHub : public HubBuilder {
 #ifndef GH_NO_MQTT
         endMQTT();
 #endif
+#ifndef GH_NO_UDP
+        endUDP();
+#endif
+#ifndef GH_NO_STREAM
+        endStream();
+#endif
 #endif
         running_f = false;
         sendEvent(GH_STOP, GH_SYSTEM);
@@ -134,6 +190,19 @@ class GyverHub : public HubBuilder {
     // установить версию прошивки для отображения в Info и OTA
     void setVersion(const char* v) {
         version = v;
+        disc_s = "";
+    }
+
+    // установить группы устройства для фильтра поиска, список через запятую ("kitchen,light")
+    void setGroup(const char* g) {
+        group = g;
+        disc_s = "";
+    }
+
+    // макс. случайная задержка ответа на широковещательный поиск по MQTT, мс (умолч. 0).
+    // Растягивает ответы множества устройств на одном префиксе во времени
+    void setDiscoverDelay(uint16_t ms) {
+        disc_delay = ms;
     }
 
     // установить размер буфера строки для сборки интерфейса при ручной отправке
@@ -151,6 +220,7 @@ class GyverHub : public HubBuilder {
     // установить пин-код для открытия устройства (значение больше 1000, не может начинаться с 000..)
     void setPIN(uint32_t npin) {
         PIN = npin;
+        disc_s = "";
     }
 
     // прочитать пин-код
@@ -184,7 +254,7 @@ class GyverHub : public HubBuilder {
         _jsBegin(answ);
         _jsID(answ);
         _jsStr(answ, F("type"), F("print"));
-        _jsStr(answ, F("text"), s);
+        _jsText(answ, F("text"), s.c_str());
         _jsVal(answ, F("color"), color, true);
         _jsEnd(answ);
         send(answ);
@@ -207,6 +277,11 @@ class GyverHub : public HubBuilder {
         return running_f;
     }
 
+    // максимум занятой памяти арены временных буферов за время работы, байт (размер - GH_ARENA_SIZE)
+    size_t arenaPeak() {
+        return arena.peak();
+    }
+
     // подключить функцию-обработчик перезагрузки. Будет вызвана перед перезагрузкой
     void onReboot(void (*handler)(GHreason_t r)) {
 #ifdef GH_ESP_BUILD
@@ -223,14 +298,14 @@ class GyverHub : public HubBuilder {
     bool focused() {
         if (!running_f) return 0;
         for (uint8_t i = 0; i < GH_CONN_AMOUNT; i++) {
-            if (focus_arr[i]) return 1;
+            if (focus_t[i].active()) return 1;
         }
         return 0;
     }
 
     // проверить фокус по указанному типу связи
     bool focused(GHconn_t conn) {
-        return focus_arr[conn];
+        return focus_t[conn].active();
     }
 
     // обновить веб-интерфейс. Вызывать внутри обработчика build
@@ -257,7 +332,7 @@ class GyverHub : public HubBuilder {
         _jsBegin(answ);
         _jsID(answ);
         _jsStr(answ, F("type"), F("push"));
-        _jsStr(answ, F("text"), text, true);
+        _jsText(answ, F("text"), text.c_str(), true);
         _jsEnd(answ);
         send(answ, true);
     }
@@ -270,7 +345,7 @@ class GyverHub : public HubBuilder {
         _jsBegin(answ);
         _jsID(answ);
         _jsStr(answ, F("type"), F("notice"));
-        _jsStr(answ, F("text"), text);
+        _jsText(answ, F("text"), text.c_str());
         _jsStr(answ, F("color"), color, true);
         _jsEnd(answ);
         send(answ);
@@ -284,7 +359,7 @@ class GyverHub : public HubBuilder {
         _jsBegin(answ);
         _jsID(answ);
         _jsStr(answ, F("type"), F("alert"));
-        _jsStr(answ, F("text"), text, true);
+        _jsText(answ, F("text"), text.c_str(), true);
         _jsEnd(answ);
         send(answ);
     }
@@ -296,49 +371,54 @@ class GyverHub : public HubBuilder {
         if (!running_f || !focused()) return;
         String answ;
         _updateBegin(answ);
-        answ += '\'';
+        answ += '\"';
         answ += name;
-        answ += F("':'");
-        answ += value;
-        answ += F("'}}\n");
+        answ += F("\":\"");
+        GH_escapeStr(&answ, value.c_str(), false);
+        answ += F("\"}}\n");
         send(answ);
     }
 
     // отправить update по имени компонента (значение будет прочитано в build). Нельзя вызывать из build. Имена можно передать списком через запятую
     void sendUpdate(const String& name) {
         if (!running_f || !build_cb || bptr || !focused()) return;
-        GHbuild build(GH_BUILD_READ);
-        bptr = &build;
+        GHreadList list((char*)name.c_str(), arena);
+        if (!_readList(list)) return;
 
         String answ;
-        sptr = &answ;
         _updateBegin(answ);
-
-        char* str = (char*)name.c_str();
-        char* p = str;
-        GH_splitter(NULL);
-        while ((p = GH_splitter(str)) != NULL) {
-            build.type = GH_BUILD_READ;
-            build.action.name = p;
-            answ += '\'';
-            answ += p;
-            answ += F("':'");
-            answ.reserve(answ.length() + 64);
-            build_cb();
-            answ += F("',");
+        for (uint16_t i = 0; i < list.amount; i++) {
+            if (!list.found[i]) continue;
+            answ += '\"';
+            answ += list.names[i];
+            answ += F("\":\"");
+            answ += list.values[i];
+            answ += F("\",");
         }
-        bptr = nullptr;
-        sptr = nullptr;
         answ[answ.length() - 1] = '}';
         _jsEnd(answ);
         send(answ);
     }
+
+    // прочитать значения всех компонентов из списка за один вызов build. false - ничего не найдено
+    bool _readList(GHreadList& list) {
+        if (!list.amount) return 0;
+        GHbuild build(GH_BUILD_READ);
+        build.action.name = list.names[0];
+        build.reads = &list;
+        bptr = &build;
+        sptr = &list.values[0];
+        build_cb();
+        bptr = nullptr;
+        sptr = nullptr;
+        return list.left < list.amount;
+    }
     void _updateBegin(String& answ) {
         upd_f = 1;
         _jsBegin(answ);
         _jsID(answ);
         _jsStr(answ, F("type"), F("update"));
-        answ += F("'updates':{");
+        answ += F("\"updates\":{");
     }
 
     // ======================= SEND CANVAS ========================
@@ -347,9 +427,9 @@ class GyverHub : public HubBuilder {
         if (!running_f) return;
         String answ;
         _updateBegin(answ);
-        answ += '\'';
+        answ += '\"';
         answ += name;
-        answ += F("':[");
+        answ += F("\":[");
         answ += cv.buf;
         answ += F("]}}\n");
         send(answ);
@@ -361,9 +441,9 @@ class GyverHub : public HubBuilder {
         if (!running_f) return;
         cv.buf = "";
         _updateBegin(cv.buf);
-        cv.buf += '\'';
+        cv.buf += '\"';
         cv.buf += name;
-        cv.buf += F("':[");
+        cv.buf += F("\":[");
     }
 
     // закончить отправку холста
@@ -373,11 +453,33 @@ class GyverHub : public HubBuilder {
         cv.clearBuffer();
     }
 
+    // ======================== SEND LOG =========================
+    // отправить новые строки лога (записанные после прошлой отправки)
+    void sendLog(const String& name, GHlog& log) {
+        if (!running_f || !log.state() || log.sent == log.written()) return;
+        if (!focused()) {
+            log.sent = log.written();
+            return;
+        }
+        String answ;
+        _updateBegin(answ);
+        answ += '\"';
+        answ += name;
+        answ += F("\":{\"from\":");
+        answ += log.since(log.sent);
+        answ += F(",\"add\":\"");
+        log.sent = log.readSince(&answ, log.sent);
+        answ += F("\",\"to\":");
+        answ += log.sent;
+        answ += F("}}}\n");
+        send(answ);
+    }
+
     // ======================== SEND GET =========================
 
     // автоматически отправлять новое состояние на get-топик при изменении через set (умолч. false)
     void sendGetAuto(bool v) {
-#ifdef GH_ESP_BUILD
+#ifdef GH_NET_BUILD
         auto_f = v;
 #endif
     }
@@ -385,7 +487,7 @@ class GyverHub : public HubBuilder {
     // отправить имя-значение на get-топик (MQTT)
     void sendGet(const String& name, const String& value) {
         if (!running_f) return;
-#ifdef GH_ESP_BUILD
+#ifdef GH_NET_BUILD
 #ifndef GH_NO_MQTT
         String topic(prefix);
         topic += F("/hub/");
@@ -399,26 +501,15 @@ class GyverHub : public HubBuilder {
 
     // отправить значение по имени компонента на get-топик (MQTT) (значение будет прочитано в build). Имена можно передать списком через запятую
     void sendGet(const String& name) {
-#ifdef GH_ESP_BUILD
+#ifdef GH_NET_BUILD
 #ifndef GH_NO_MQTT
         if (!running_f || !build_cb || bptr) return;
-        GHbuild build(GH_BUILD_READ);
-        bptr = &build;
-
-        String value;
-        sptr = &value;
-
-        char* str = (char*)name.c_str();
-        char* p = str;
-        GH_splitter(NULL);
-        while ((p = GH_splitter(str)) != NULL) {
-            build.type = GH_BUILD_READ;
-            build.action.name = p;
-            build_cb();
-            if (build.type == GH_BUILD_NONE) sendGet(p, value);
+        GHreadList list((char*)name.c_str(), arena);
+        list.get = 1;
+        if (!_readList(list)) return;
+        for (uint16_t i = 0; i < list.amount; i++) {
+            if (list.found[i]) sendGet(list.names[i], list.values[i]);
         }
-        bptr = nullptr;
-        sptr = nullptr;
 #endif
 #endif
     }
@@ -449,16 +540,28 @@ class GyverHub : public HubBuilder {
 
     // парсить строку вида PREFIX/ID/HUB_ID/CMD/NAME с отдельным value
     void parse(char* url, char* value, GHconn_t conn, bool manual = true) {
-#if defined(GH_ESP_BUILD) && !defined(GH_NO_FS) && !defined(GH_NO_OTA) && !defined(GH_NO_OTA_URL)
-        if (ota_url_f) return;
-#endif
         if (!running_f) return;
+        GHarenaScope scope(arena);  // временные буферы запроса возвращаются при выходе
         if (strncmp(url, prefix, strlen(prefix))) return sendEvent(GH_UNKNOWN, conn);
 
         if (!strcmp(url, prefix)) {  // == prefix
+            char* query = strchr(value, '?');  // HUB_ID?фильтр
+            if (query) *query = 0;
             GHhub hub(conn, value, manual);
-            hub_ptr = &hub;
-            answerDiscover();
+            bool match = !query || _discoverFilter(query + 1);
+            if (query) *query = '?';
+            if (!match) return;
+            if (conn == GH_MQTT && disc_delay) {
+                if (disc_t.active()) {  // предыдущий ответ не ждёт
+                    hub_ptr = &disc_hub;
+                    answerDiscover();
+                }
+                disc_hub = hub;
+                wheel.start(disc_t, random(disc_delay + 1));
+            } else {
+                hub_ptr = &hub;
+                answerDiscover();
+            }
             return sendEvent(GH_DISCOVER_ALL, conn);
         }
 
@@ -479,7 +582,7 @@ class GyverHub : public HubBuilder {
         hub_ptr = &hub;
 
         if (p.size == 4) {
-#ifdef GH_ESP_BUILD
+#ifdef GH_NET_BUILD
 #ifndef GH_NO_MQTT
             // MQTT HOOK
             if (conn == GH_MQTT && build_cb) {
@@ -505,6 +608,7 @@ class GyverHub : public HubBuilder {
 
             switch (GH_getCmd(p.str[3])) {
                 case 0:  // focus
+                    caps.set(hub, value);
                     answerUI();
                     return sendEvent(GH_FOCUS, conn);
 
@@ -538,6 +642,7 @@ class GyverHub : public HubBuilder {
                     if (modules.read(GH_MOD_FORMAT)) {
                         GH_FS.format();
                         GH_FS.end();
+                        GH_fsIndex.reset();
                         fs_mounted = GH_FS.begin();
                         answerFsbr();
                     } else answerType(F("ERR"));
@@ -555,7 +660,7 @@ class GyverHub : public HubBuilder {
 
                 case 7:  // fetch_chunk
 #ifndef GH_NO_FS
-                    fs_tmr = millis();
+                    wheel.start(fs_t, GH_CONN_TOUT * 1000ul);
                     if (!file_d || fs_hub != hub || !modules.read(GH_MOD_DOWNLOAD)) {
                         answerType(F("fetch_err"));
                         return sendEvent(GH_DOWNLOAD_ERROR, conn);
@@ -592,7 +697,7 @@ class GyverHub : public HubBuilder {
                     upd_f = refresh_f = 0;
                     build_cb();
                     bptr = nullptr;
-#ifdef GH_ESP_BUILD
+#ifdef GH_NET_BUILD
                     if (auto_f) sendGet(name, value);
 #endif
                     if (refresh_f) answerUI();
@@ -628,7 +733,10 @@ class GyverHub : public HubBuilder {
             // delete
             case 3:
 #ifndef GH_NO_FS
-                if (modules.read(GH_MOD_DELETE) && GH_FS.remove(name)) answerFsbr();
+                if (modules.read(GH_MOD_DELETE) && GH_FS.remove(name)) {
+                    GH_fsIndex.removed(name);
+                    answerFsbr();
+                }
                 else answerType(F("ERR"));
 #else
                 answerType(F("ERR"));
@@ -638,47 +746,73 @@ class GyverHub : public HubBuilder {
             // rename
             case 4:
 #ifndef GH_NO_FS
-                if (modules.read(GH_MOD_RENAME) && GH_FS.rename(name, value)) answerFsbr();
+                if (modules.read(GH_MOD_RENAME) && GH_FS.rename(name, value)) {
+                    GH_fsIndex.renamed(name, value);
+                    answerFsbr();
+                }
                 else answerType(F("ERR"));
 #else
                 answerType(F("ERR"));
 #endif
                 return sendEvent(GH_RENAME, conn);
 
-            // fetch
+            // fetch, value - позиция для докачки
             case 5:
 #ifndef GH_NO_FS
-                if (!file_d && !file_u && !ota_f && modules.read(GH_MOD_DOWNLOAD)) {
+                // докачка тем же клиентом: прошлая сессия ещё не закрыта по таймауту. Чужую передачу не трогаем
+                if (value[0] && file_d && fs_state == GH_IDLE && fs_hub == hub) file_d.close();
+                if (!_fsBusy() && modules.read(GH_MOD_DOWNLOAD)) {
                     file_d = GH_FS.open(name, "r");
                     if (file_d) {
-                        fs_hub = hub;
-                        fs_tmr = millis();
-                        dwn_chunk_count = 0;
-                        dwn_chunk_amount = (file_d.size() + GH_DOWN_CHUNK_SIZE - 1) / GH_DOWN_CHUNK_SIZE;  // round up
-                        answerType(F("fetch_start"));
-                        return sendEvent(GH_DOWNLOAD, conn);
+                        uint32_t offset = strtoul(value, nullptr, 10);
+                        uint32_t size = file_d.size();
+                        if (offset <= size && file_d.seek(offset)) {
+                            char* opt = strchr(value, ',');  // OFFSET,lz - сжатие
+                            _lzBegin(opt ? opt + 1 : nullptr, true);
+                            fs_hub = hub;
+                            wheel.start(fs_t, GH_CONN_TOUT * 1000ul);
+                            dwn_chunk_count = offset / GH_DOWN_CHUNK_SIZE;
+                            dwn_chunk_amount = dwn_chunk_count + max((size - offset + GH_DOWN_CHUNK_SIZE - 1) / GH_DOWN_CHUNK_SIZE, (uint32_t)1);  // round up
+                            _answerTransfer(F("fetch_start"), offset, size);
+                            return sendEvent(GH_DOWNLOAD, conn);
+                        }
+                        file_d.close();
                     }
                 }
 #endif
                 answerType(F("fetch_err"));
                 return sendEvent(GH_DOWNLOAD_ERROR, conn);
 
-            // upload
+            // upload, value - токен сессии для докачки
             case 6:
 #ifndef GH_NO_FS
-                if (!file_d && !file_u && !ota_f && !fs_buffer && modules.read(GH_MOD_UPLOAD)) {
-                    file_u = GH_FS.open(name, "w");
+            {
+                uint32_t token = strtoul(value, nullptr, 16);
+                bool resume = token && token == upl_token && upl_path == name;
+                if (resume && file_u && fs_state == GH_IDLE) _uplClose();  // прошлая сессия ещё не закрыта по таймауту
+                if (!_fsBusy() && modules.read(GH_MOD_UPLOAD)) {
+                    if (!resume) {
+                        _uplDrop();
+                        upl_path = name;
+                        upl_token = random(1, 0x7fffffff);
+                    }
+                    file_u = GH_FS.open(_uplTemp(), resume ? "a" : "w");
                     if (file_u) {
-                        fs_buffer = (char*)malloc(GH_UPL_CHUNK_SIZE + 10);
+                        fs_buffer = fs_chunk;  // nullptr - не хватило памяти в begin()
                         if (fs_buffer) {
+                            char* opt = strchr(value, ',');  // TOKEN,lz - сжатие
+                            _lzBegin(opt ? opt + 1 : nullptr, false);
+                            GH_fsIndex.added(file_u);
                             fs_hub = hub;
-                            fs_tmr = millis();
-                            answerType(F("upload_start"));
+                            wheel.start(fs_t, GH_CONN_TOUT * 1000ul);
+                            _answerTransfer(F("upload_start"), file_u.size(), 0, upl_token);
                             sendEvent(GH_UPLOAD, conn);
                             return;
                         }
+                        file_u.close();
                     }
                 }
+            }
 #endif
                 answerType(F("upload_err"));
                 return sendEvent(GH_UPLOAD_ERROR, conn);
@@ -704,14 +838,16 @@ class GyverHub : public HubBuilder {
             // ota
             case 8:
 #if !defined(GH_NO_FS) && !defined(GH_NO_OTA)
-                if (!file_d && !file_u && !ota_f && !fs_buffer && modules.read(GH_MOD_OTA)) {
+                if (!_fsBusy() && modules.read(GH_MOD_OTA)) {
                     int ota_type = 0;
                     if (!strcmp_P(name, PSTR("flash"))) ota_type = 1;
                     else if (!strcmp_P(name, PSTR("fs"))) ota_type = 2;
+                    else if (!strcmp_P(name, PSTR("delta"))) ota_type = 3;
 
                     if (ota_type) {
                         size_t ota_size;
-                        if (ota_type == 1) {
+                        bool delta = (ota_type == 3);
+                        if (ota_type != 2) {  // патч собирает новую прошивку на месте обычной
                             ota_type = U_FLASH;
                             ota_size = (size_t)((ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000);
                         } else {
@@ -724,13 +860,15 @@ class GyverHub : public HubBuilder {
                             ota_size = UPDATE_SIZE_UNKNOWN;
 #endif
                         }
-                        if (Update.begin(ota_size, ota_type)) {
-                            fs_buffer = (char*)malloc(GH_UPL_CHUNK_SIZE + 10);
+                        if (delta) fs_delta = new GHdelta(GH_readSketch, GH_update);
+                        if ((!delta || fs_delta) && Update.begin(ota_size, ota_type)) {
+                            fs_buffer = fs_chunk;  // nullptr - не хватило памяти в begin()
                             if (fs_buffer) {
+                                _lzBegin(value, false);
                                 fs_hub = hub;
                                 ota_f = true;
-                                fs_tmr = millis();
-                                answerType(F("ota_start"));
+                                wheel.start(fs_t, GH_CONN_TOUT * 1000ul);
+                                _answerTransfer(F("ota_start"), 0, 0);
                                 return sendEvent(GH_OTA, conn);
                             }
                         }
@@ -761,18 +899,31 @@ class GyverHub : public HubBuilder {
             // ota_url
             case 10:
 #if !defined(GH_NO_FS) && !defined(GH_NO_OTA) && !defined(GH_NO_OTA_URL)
-                if (!file_d && !file_u && !ota_f && !fs_buffer && modules.read(GH_MOD_OTA_URL)) {
-                    if (!strcmp_P(name, PSTR("flash"))) ota_url_fs = 0;
-                    else if (!strcmp_P(name, PSTR("fs"))) ota_url_fs = 1;
-                    ota_url = value;
+                if (!_fsBusy() && modules.read(GH_MOD_OTA_URL) && ota_url.begin(value, !strcmp_P(name, PSTR("fs")))) {
+                    fs_hub = hub;
                     answerType();
-                    fs_state = GH_OTA_URL;
                     return sendEvent(GH_OTA_URL, conn);
                 }
 #endif
                 answerType(F("ERR"));
                 return sendEvent(GH_OTA_URL, conn);
 
+            // fsbr/dir, value - номер страницы
+            case 11:
+#ifndef GH_NO_FS
+                if (modules.read(GH_MOD_FSBR)) {
+                    if (fs_mounted) {
+                        String dir(name);
+                        if (!dir.startsWith("/")) dir = String('/') + dir;
+                        if (!dir.endsWith("/")) dir += '/';
+                        answerFsbrDir(dir, atoi(value));
+                    } else answerType(F("fs_error"));
+                } else answerType(F("ERR"));
+#else
+                answerType(F("ERR"));
+#endif
+                return sendEvent(GH_FSBR, conn);
+
 #endif
             default:
                 clearFocus(conn);
@@ -785,15 +936,14 @@ class GyverHub : public HubBuilder {
     // тикер, вызывать в loop
     bool tick() {
         if (!running_f) return 0;
+        GHarenaScope scope(arena);
 
-        if ((uint16_t)((uint16_t)millis() - focus_tmr) >= 1000) {
-            focus_tmr = millis();
-            for (uint8_t i = 0; i < GH_CONN_AMOUNT; i++) {
-                if (focus_arr[i]) focus_arr[i]--;
-            }
-        }
+        wheel.tick();
+#ifdef GH_WORKER
+        worker.flush();
+#endif
 
-#ifdef GH_ESP_BUILD
+#ifdef GH_NET_BUILD
 #ifndef GH_NO_WS
         tickWS();
         tickHTTP();
@@ -801,94 +951,105 @@ class GyverHub : public HubBuilder {
 #ifndef GH_NO_MQTT
         tickMQTT();
 #endif
+#ifndef GH_NO_UDP
+        tickUDP();
+#endif
+#ifndef GH_NO_STREAM
+        tickStream();
+#endif
+#endif
 
+#ifdef GH_ESP_BUILD
 #ifndef GH_NO_FS
-        if ((file_d || file_u || ota_f) && (uint16_t)millis() - fs_tmr >= (GH_CONN_TOUT * 1000)) {
-            if (file_d) fs_state = GH_DOWNLOAD_ABORTED;
-            if (file_u) fs_state = GH_UPLOAD_ABORTED;
-            if (ota_f) fs_state = GH_OTA_ABORTED;
-            if (fs_buffer) {
-                delete fs_buffer;
-                fs_buffer = nullptr;
+#if !defined(GH_NO_OTA) && !defined(GH_NO_OTA_URL)
+        if (ota_url.running()) {
+            switch (ota_url.tick()) {
+                case GHotaUrl::GH_OTAU_CHUNK:
+                    sendEvent(GH_OTA_URL_CHUNK, fs_hub.conn);
+                    break;
+                case GHotaUrl::GH_OTAU_DONE:
+                    reboot_f = GH_REB_OTA_URL;
+                    hub_ptr = &fs_hub;
+                    answerType(F("ota_url_ok"));
+                    sendEvent(GH_OTA_URL_FINISH, fs_hub.conn);
+                    break;
+                case GHotaUrl::GH_OTAU_ERR:
+                    hub_ptr = &fs_hub;
+                    answerType(F("ota_url_err"));
+                    sendEvent(GH_OTA_URL_ERROR, fs_hub.conn);
+                    break;
+                default:
+                    break;
             }
         }
+#endif
 
         if (fs_state != GH_IDLE) {
             switch (fs_state) {
-#ifndef GH_NO_OTA_URL
-                case GH_OTA_URL: {
-                    bool ok = 0;
-                    ota_url_f = 1;
-#ifdef ESP8266
-                    ESPhttpUpdate.rebootOnUpdate(false);
-                    BearSSL::WiFiClientSecure client;
-                    if (ota_url.startsWith(F("https"))) client.setInsecure();
-                    if (ota_url_fs) ESPhttpUpdate.updateFS(client, ota_url);
-                    else ok = ESPhttpUpdate.update(client, ota_url);
-#else
-                    httpUpdate.rebootOnUpdate(false);
-                    WiFiClientSecure client;
-                    if (ota_url.startsWith(F("https"))) client.setInsecure();
-                    if (ota_url_fs) ok = httpUpdate.updateSpiffs(client, ota_url);
-                    else ok = httpUpdate.update(client, ota_url);
-#endif
-                    hub_ptr = &fs_hub;
-                    if (ok) {
-                        reboot_f = GH_REB_OTA_URL;
-                        answerType(F("ota_url_ok"));
-                    } else {
-                        ota_url = "";
-                        ota_url_f = 0;
-                        answerType(F("ota_url_err"));
-                    }
-                } break;
-#endif
-
                 case GH_DOWNLOAD_ABORTED:
                     file_d.close();
                     sendEvent(GH_DOWNLOAD_ABORTED, fs_hub.conn);
                     break;
 
                 case GH_UPLOAD_CHUNK:
-                    GH_B64toFile(file_u, fs_buffer);
                     hub_ptr = &fs_hub;
-                    answerType(F("upload_next_chunk"));
-                    fs_tmr = millis();
-                    sendEvent(GH_UPLOAD_CHUNK, fs_hub.conn);
+                    if (GH_B64toFile(file_u, fs_buffer, fs_lz)) {
+                        answerType(F("upload_next_chunk"));
+                        wheel.start(fs_t, GH_CONN_TOUT * 1000ul);
+                        sendEvent(GH_UPLOAD_CHUNK, fs_hub.conn);
+                    } else {
+                        _uplDrop();
+                        answerType(F("upload_err"));
+                        sendEvent(GH_UPLOAD_ERROR, fs_hub.conn);
+                    }
                     break;
 
                 case GH_UPLOAD_FINISH:
-                    GH_B64toFile(file_u, fs_buffer);
-                    delete fs_buffer;
-                    fs_buffer = nullptr;
-                    file_u.close();
                     hub_ptr = &fs_hub;
-                    answerType(F("upload_end"));
-                    sendEvent(GH_UPLOAD_FINISH, fs_hub.conn);
+                    if (GH_B64toFile(file_u, fs_buffer, fs_lz)) {
+                        _uplClose();
+                        if (_uplCommit()) {
+                            answerType(F("upload_end"));
+                            sendEvent(GH_UPLOAD_FINISH, fs_hub.conn);
+                            break;
+                        }
+                    }
+                    _uplDrop();
+                    answerType(F("upload_err"));
+                    sendEvent(GH_UPLOAD_ERROR, fs_hub.conn);
                     break;
 
-                case GH_UPLOAD_ABORTED:
-                    file_u.close();
+                case GH_UPLOAD_ABORTED:  // временный файл остаётся для докачки
+                    _uplClose();
                     sendEvent(GH_UPLOAD_ABORTED, fs_hub.conn);
                     break;
 #ifndef GH_NO_OTA
                 case GH_OTA_CHUNK:
-                    GH_B64toUpdate(fs_buffer);
                     hub_ptr = &fs_hub;
-                    answerType(F("ota_next_chunk"));
-                    fs_tmr = millis();
-                    sendEvent(GH_OTA_CHUNK, fs_hub.conn);
+                    if (GH_B64toUpdate(fs_buffer, fs_lz, fs_delta)) {
+                        answerType(F("ota_next_chunk"));
+                        wheel.start(fs_t, GH_CONN_TOUT * 1000ul);
+                        sendEvent(GH_OTA_CHUNK, fs_hub.conn);
+                    } else {
+                        Update.end();
+                        fs_buffer = nullptr;
+                        ota_f = false;
+                        answerType(F("ota_err"));
+                        sendEvent(GH_OTA_ERROR, fs_hub.conn);
+                    }
                     break;
 
                 case GH_OTA_FINISH:
-                    GH_B64toUpdate(fs_buffer);
-                    delete fs_buffer;
+                    hub_ptr = &fs_hub;
+                    // патч: новая прошивка собрана полностью и CRC совпал
+                    if (GH_B64toUpdate(fs_buffer, fs_lz, fs_delta) && (!fs_delta || fs_delta->end()) && Update.end(true)) answerType(F("ota_end"));
+                    else {
+                        Update.end();
+                        answerType(F("ota_err"));
+                    }
                     fs_buffer = nullptr;
                     ota_f = false;
                     reboot_f = GH_REB_OTA;
-                    hub_ptr = &fs_hub;
-                    if (Update.end(true)) answerType(F("ota_end"));
-                    else answerType(F("ota_err"));
                     sendEvent(GH_OTA_FINISH, fs_hub.conn);
                     break;
 
@@ -903,6 +1064,10 @@ class GyverHub : public HubBuilder {
             }
             fs_state = GH_IDLE;
         }
+        if ((fs_lz || fs_delta) && !_fsBusy()) {
+            _lzEnd();
+            _deltaEnd();
+        }
 #endif
         if (reboot_f) {
             if (reboot_cb) reboot_cb(reboot_f);
@@ -913,6 +1078,18 @@ class GyverHub : public HubBuilder {
         return 1;
     }
 
+    // ========================== TIMERS ==========================
+
+    // запустить таймер через ms мс (periodic - повторять). Обработчик таймера вызывается в tick()
+    void startTimer(GHwheelTimer& t, uint32_t ms, bool periodic = false) {
+        wheel.start(t, ms, periodic);
+    }
+
+    // мс до ближайшего таймера (в т.ч. внутренних). Столько можно спать между вызовами tick(), не считая сетевых событий
+    uint32_t nextDeadline() {
+        return wheel.nextDeadline();
+    }
+
     // =========================================================================================
     // ======================================= PRIVATE =========================================
     // =========================================================================================
@@ -923,6 +1100,95 @@ class GyverHub : public HubBuilder {
     const char* getID() {
         return id;
     }
+    GHwheel& getWheel() {
+        return wheel;
+    }
+
+    // отложенный ответ на discover all
+    static void _discoverTimer(void* self) {
+        GyverHub* hub = (GyverHub*)self;
+        hub->hub_ptr = &hub->disc_hub;
+        hub->answerDiscover();
+    }
+
+#if defined(GH_ESP_BUILD) && !defined(GH_NO_FS)
+    // идёт передача файла или ОТА
+    bool _fsBusy() {
+#if !defined(GH_NO_OTA) && !defined(GH_NO_OTA_URL)
+        if (ota_url.running()) return 1;
+#endif
+        return file_d || file_u || ota_f || fs_buffer;
+    }
+
+    // сжатие передачи, если клиент его запросил (opt = "lz")
+    void _lzBegin(const char* opt, bool encode) {
+        _lzEnd();
+        if (!opt || strcmp_P(opt, PSTR("lz"))) return;
+        fs_lz = new GHlz;
+        if (fs_lz && !(encode ? fs_lz->beginEncode() : fs_lz->beginDecode())) _lzEnd();
+    }
+
+    void _lzEnd() {
+        if (!fs_lz) return;
+        delete fs_lz;
+        fs_lz = nullptr;
+    }
+
+    void _deltaEnd() {
+        if (!fs_delta) return;
+        delete fs_delta;
+        fs_delta = nullptr;
+    }
+
+    // временный файл загрузки
+    String _uplTemp() {
+        return upl_path + F(".part");
+    }
+
+    // закрыть временный файл загрузки
+    void _uplClose() {
+        fs_buffer = nullptr;
+        if (!file_u) return;
+        GH_fsIndex.added(file_u);
+        file_u.close();
+    }
+
+    // заменить файл загруженным
+    bool _uplCommit() {
+        String tmp = _uplTemp();
+        bool ok = GH_FS.rename(tmp, upl_path);  // LittleFS заменяет файл атомарно
+        if (!ok && GH_FS.exists(tmp)) {
+            GH_FS.remove(upl_path);  // SPIFFS не переименовывает поверх существующего
+            ok = GH_FS.rename(tmp, upl_path);
+        }
+        if (ok) {
+            GH_fsIndex.renamed(tmp, upl_path);
+            upl_path = "";
+            upl_token = 0;
+        }
+        return ok;
+    }
+
+    // удалить незавершённую загрузку
+    void _uplDrop() {
+        if (!upl_path.length()) return;
+        _uplClose();
+        String tmp = _uplTemp();
+        if (GH_FS.remove(tmp)) GH_fsIndex.removed(tmp);
+        upl_path = "";
+        upl_token = 0;
+    }
+
+    // таймаут передачи файла или ОТА: прерывание обрабатывается в tick()
+    static void _fsTimeout(void* self) {
+        GyverHub* hub = (GyverHub*)self;
+        if (!hub->file_d && !hub->file_u && !hub->ota_f) return;
+        if (hub->file_d) hub->fs_state = GH_DOWNLOAD_ABORTED;
+        if (hub->file_u) hub->fs_state = GH_UPLOAD_ABORTED;
+        if (hub->ota_f) hub->fs_state = GH_OTA_ABORTED;
+        hub->fs_buffer = nullptr;
+    }
+#endif
     void _afterComponent() {
         switch (buf_mode) {
             case GH_NORMAL:
@@ -944,7 +1210,7 @@ class GyverHub : public HubBuilder {
     void _power(FSTR mode) {
         if (!running_f) return;
 
-#ifdef GH_ESP_BUILD
+#ifdef GH_NET_BUILD
 #ifndef GH_NO_MQTT
         String topic(prefix);
         topic += F("/hub/");
@@ -962,7 +1228,7 @@ class GyverHub : public HubBuilder {
         _jsBegin(answ);
         _jsID(answ);
         _jsStr(answ, F("type"), F("info"));
-        answ += F("'info':[");
+        answ += F("\"info\":[");
         _jsArr(answ, GH_VERSION);
         _jsArr(answ, version);
 #ifdef GH_ESP_BUILD
@@ -990,8 +1256,11 @@ class GyverHub : public HubBuilder {
         build.hub = *hub_ptr;
         bptr = &build;
         bool chunked = buf_size;
+        uint8_t cflags = caps.get(build.hub);
+        ui_def = cflags & GH_CAP_DEF;
+        ui_short = cflags & GH_CAP_SK;
 
-#ifdef GH_ESP_BUILD
+#ifdef GH_NET_BUILD
         if (build.hub.conn == GH_WS || build.hub.conn == GH_MQTT) chunked = false;
 #endif
 
@@ -1007,7 +1276,7 @@ class GyverHub : public HubBuilder {
 
         String answ;
         answ.reserve((chunked ? buf_size : buf_count) + 100);
-        answ = F("\n{'controls':[");
+        answ = F("\n{\"controls\":[");
         buf_mode = chunked ? GH_CHUNKED : GH_NORMAL;
         build.type = GH_BUILD_UI;
         sptr = &answ;
@@ -1041,19 +1310,51 @@ class GyverHub : public HubBuilder {
     void answerFsbr() {
 #ifdef GH_ESP_BUILD
 #ifndef GH_NO_FS
-        uint16_t count = 0;
+        uint32_t count = 0;
         String answ;
         answ.reserve(100);
-        GH_showFiles(answ, "/", GH_FS_DEPTH, &count);
-        answ.reserve(count + 50);
-        answ = F("\n{'fs':{'/':0,");
-        GH_showFiles(answ, "/", GH_FS_DEPTH);
+        GH_fsIndex.tree(answ, "/", GH_FS_DEPTH, &count);
+        answ.reserve(count + 150);
+        answ = F("\n{\"fs\":{\"/\":0,");
+        GH_fsIndex.tree(answ, "/", GH_FS_DEPTH);
         answ[answ.length() - 1] = '}';  // ',' = '}'
         answ += ',';
 
         _jsID(answ);
         _jsStr(answ, F("type"), F("fsbr"));
+        _answerFsInfo(answ);
+#endif
+#else
+        answerType(F("ERR"));
+#endif
+    }
+
+    // страница каталога dir ("/" или "/path/")
+    void answerFsbrDir(const String& dir, uint16_t page) {
+#if defined(GH_ESP_BUILD) && !defined(GH_NO_FS)
+        String answ;
+        answ.reserve(GH_FS_PAGE * 24 + 150);
+        answ = F("\n{\"fs\":{");
+        uint16_t pages = GH_fsIndex.page(answ, dir, page);
+        if (!pages) return answerType(F("fs_error"));
+        if (answ[answ.length() - 1] == ',') answ[answ.length() - 1] = '}';  // ',' = '}'
+        else answ += '}';
+        answ += ',';
 
+        _jsID(answ);
+        _jsStr(answ, F("type"), F("fsbr_dir"));
+        _jsText(answ, F("dir"), dir.c_str());
+        _jsVal(answ, F("page"), page);
+        _jsVal(answ, F("pages"), pages);
+        _answerFsInfo(answ);
+#else
+        answerType(F("ERR"));
+#endif
+    }
+
+#if defined(GH_ESP_BUILD) && !defined(GH_NO_FS)
+    // gzip, размер ФС и отправка ответа
+    void _answerFsInfo(String& answ) {
 #ifdef ATOMIC_FS_UPDATE
         _jsVal(answ, F("gzip"), 1);
 #else
@@ -1071,14 +1372,54 @@ class GyverHub : public HubBuilder {
 #endif
         _jsEnd(answ);
         answer(answ);
-#endif
-#else
-        answerType(F("ERR"));
-#endif
     }
+#endif
 
     // ======================= DISCOVER ========================
     void answerDiscover() {
+        if (!disc_s.length()) _buildDiscover();
+        answer(disc_s, true, false, true);
+    }
+
+    // запрос поиска по UDP: PREFIX или PREFIX=?фильтр
+    String* discoverUDP(char* req) {
+        if (!running_f) return nullptr;
+        char* value = strchr(req, '=');
+        if (value) *value++ = 0;
+        if (strcmp(req, prefix)) return nullptr;
+        if (value && value[0] == '?' && !_discoverFilter(value + 1)) return nullptr;
+        if (!disc_s.length()) _buildDiscover();
+        sendEvent(GH_DISCOVER_ALL, GH_WS);
+        return &disc_s;
+    }
+
+    // фильтр поиска вида id=1a&name=Kitchen*&ver=1.?&group=light&from=100000&to=1fffff, все условия должны выполняться
+    bool _discoverFilter(char* q) {
+        uint32_t nid = strtoul(id, nullptr, 16);
+        bool ok = true;
+        while (ok && q && *q) {
+            char* amp = strchr(q, '&');
+            char* eq = strchr(q, '=');
+            if (amp) *amp = 0;
+            if (eq && (!amp || eq < amp)) {
+                *eq = 0;
+                const char* v = eq + 1;
+                if (!strcmp_P(q, PSTR("id"))) ok = !strncmp(id, v, strlen(v));
+                else if (!strcmp_P(q, PSTR("name"))) ok = GH_glob(v, name ? name : "");
+                else if (!strcmp_P(q, PSTR("ver"))) ok = GH_glob(v, version ? version : "");
+                else if (!strcmp_P(q, PSTR("group"))) ok = GH_inList(group, v);
+                else if (!strcmp_P(q, PSTR("from"))) ok = nid >= strtoul(v, nullptr, 16);
+                else if (!strcmp_P(q, PSTR("to"))) ok = nid <= strtoul(v, nullptr, 16);
+                *eq = '=';
+            }
+            if (amp) *amp = '&';
+            q = amp ? amp + 1 : nullptr;
+        }
+        return ok;
+    }
+
+    // пакет собирается один раз и пересобирается после изменения имени, иконки, версии, группы или пин-кода
+    void _buildDiscover() {
         uint32_t hash = 0;
         if (PIN > 999) {
             char pin_s[11];
@@ -1089,39 +1430,60 @@ class GyverHub : public HubBuilder {
             }
         }
 
-        String answ;
-        answ.reserve(120);
-        _jsBegin(answ);
-        _jsID(answ);
-        _jsStr(answ, F("type"), F("discover"));
-        _jsStr(answ, F("name"), name);
-        _jsStr(answ, F("icon"), icon);
-        _jsVal(answ, F("PIN"), hash);
-        _jsStr(answ, F("version"), version);
-        _jsVal(answ, F("max_upl"), GH_UPL_CHUNK_SIZE);
+        disc_s = "";
+        disc_s.reserve(120);
+        _jsBegin(disc_s);
+        _jsID(disc_s);
+        _jsStr(disc_s, F("type"), F("discover"));
+        _jsText(disc_s, F("name"), name);
+        _jsText(disc_s, F("icon"), icon);
+        _jsVal(disc_s, F("PIN"), hash);
+        _jsText(disc_s, F("version"), version);
+        _jsVal(disc_s, F("max_upl"), GH_UPL_CHUNK_SIZE);
+        if (group) _jsText(disc_s, F("group"), group);
+#if defined(GH_NET_BUILD) && !defined(GH_NO_MSGPACK)
+        _jsStr(disc_s, F("bin"), F("mp"));
+#endif
 #ifdef GH_ESP_BUILD
-        _jsStr(answ, F("esp"), 1, true);
+        _jsStr(disc_s, F("esp"), 1, true);
 #else
-        _jsStr(answ, F("esp"), 0, true);
+        _jsStr(disc_s, F("esp"), 0, true);
 #endif
-        _jsEnd(answ);
-        answer(answ, true);
+        _jsEnd(disc_s);
     }
 
     // ======================= CHUNK ========================
+#if defined(GH_ESP_BUILD) && !defined(GH_NO_FS)
+    // начало передачи файла: позиция для докачки, размер, токен сессии
+    void _answerTransfer(FSTR type, uint32_t offset, uint32_t size, uint32_t token = 0) {
+        String answ;
+        answ.reserve(100);
+        _jsBegin(answ);
+        _jsID(answ);
+        _jsVal(answ, F("offset"), offset);
+        if (size) _jsVal(answ, F("size"), size);
+        if (token) _jsStr(answ, F("token"), String(token, HEX));
+        if (fs_lz) _jsStr(answ, F("comp"), F("lz"));
+        _jsStr(answ, F("type"), type, true);
+        _jsEnd(answ);
+        answer(answ);
+    }
+#endif
+
     void answerChunk() {
 #ifdef GH_ESP_BUILD
 #ifndef GH_NO_FS
         String answ;
-        answ.reserve(GH_DOWN_CHUNK_SIZE + 100);
+        answ.reserve((fs_lz ? GH_DOWN_CHUNK_SIZE * 3 / 2 : GH_DOWN_CHUNK_SIZE) + 100);
         _jsBegin(answ);
         _jsID(answ);
         _jsStr(answ, F("type"), F("fetch_next_chunk"));
         _jsVal(answ, F("chunk"), dwn_chunk_count);
         _jsVal(answ, F("amount"), dwn_chunk_amount);
-        answ += F("'data':'");
-        GH_fileToB64(file_d, answ);
-        answ += '\'';
+        _jsVal(answ, F("offset"), file_d.position());
+        answ += F("\"data\":\"");
+        GH_fileToB64(file_d, answ, fs_lz);
+        answ += '\"';
         _jsEnd(answ);
         answer(answ);
 #endif
@@ -1129,18 +1491,14 @@ class GyverHub : public HubBuilder {
     }
 
     // ======================= ANSWER ========================
-    void answer(String& answ, bool close = true) {
+    // bin = false - только текстом (например discover). keep = true - текст нужен после вызова (иначе очередь отправки может его забрать)
+    void answer(String& answ, bool close = true, bool bin = true, bool keep = false) {
         if (!hub_ptr) return;
         if (hub_ptr->manual) {
             if (manual_cb) manual_cb(answ, hub_ptr->conn, false);
         } else {
-#ifdef GH_ESP_BUILD
-#ifndef GH_NO_WS
-            if (hub_ptr->conn == GH_WS) answerWS(answ);
-#endif
-#ifndef GH_NO_MQTT
-            if (hub_ptr->conn == GH_MQTT) answerMQTT(answ, hub_ptr->id);
-#endif
+#ifdef GH_NET_BUILD
+            _post(answ, hub_ptr->conn, GH_JOB_ANSWER | (bin ? _binFlags(*hub_ptr) : 0), hub_ptr->id, keep);
 #endif
         }
         if (close) hub_ptr = nullptr;
@@ -1152,52 +1510,154 @@ class GyverHub : public HubBuilder {
             if (manual_cb) manual_cb(answ, (GHconn_t)i, broadcast);
         }
 
-#ifdef GH_ESP_BUILD
+#ifdef GH_NET_BUILD
+        bool ws = 0, mqtt = 0;
 #ifndef GH_NO_WS
-        if (focus_arr[GH_WS]) sendWS(answ);
+        ws = focus_t[GH_WS].active();
 #endif
 #ifndef GH_NO_MQTT
-        if ((focus_arr[GH_MQTT] || broadcast)) sendMQTT(answ);
+        mqtt = focus_t[GH_MQTT].active() || broadcast;
 #endif
+        // рассылку получают все клиенты, в т.ч. без упаковки - только текстом. Текст забирает последняя отправка
+        if (ws) _post(answ, GH_WS, 0, nullptr, mqtt);
+        if (mqtt) _post(answ, GH_MQTT, 0);
+#endif
+    }
+
+#ifdef GH_NET_BUILD
+    // упаковка ответа, как запросил клиент hub
+    uint8_t _binFlags(GHhub& hub) {
+        if (!focus_t[hub.conn].active()) return 0;
+        uint8_t cflags = caps.get(hub);
+        uint8_t flags = 0;
+        if (cflags & GH_CAP_MP) flags |= GH_JOB_MP;
+        if (cflags & GH_CAP_LZ) flags |= GH_JOB_LZ;
+        return flags;
+    }
+
+    // отправить пакет: сразу или через фоновую задачу. keep = false - текст переносится в очередь без копии, answ очищается
+    void _post(String& answ, GHconn_t conn, uint8_t flags, const char* hubID = nullptr, bool keep = false) {
+        uint32_t client = 0;
+#ifndef GH_NO_WS
+        client = clientWS();
+#endif
+#ifdef GH_WORKER
+        if (worker.running()) {
+            GHjob* job = worker.claim();
+            if (job) {
+                if (keep) job->data = answ;
+                else job->data = std::move(answ);
+                job->conn = conn;
+                job->flags = flags;
+                job->client = client;
+                if (hubID) strcpy(job->id, hubID);
+                worker.commit();
+                return;
+            }
+            if (!(flags & GH_JOB_ANSWER)) return;  // очередь заполнена - рассылка отброшена, loop не ждёт
+            // ответ клиенту не отбрасываем: упаковать и отправить здесь же, в обход очереди
+        }
 #endif
+        String packed;
+        bool bin = _encode(answ, packed, flags);
+        _transmit(bin ? packed : answ, bin, conn, flags, hubID, client);
     }
 
+    // упаковать: MessagePack, затем сжатие длинных. false - отправлять текстом
+    static bool _encode(const String& answ, String& bin, uint8_t flags) {
+        bool mp = 0;
+#ifndef GH_NO_MSGPACK
+        mp = (flags & GH_JOB_MP) && GH_toMsgpack(answ, bin);
+#endif
+        const String& src = mp ? bin : answ;
+        if ((flags & GH_JOB_LZ) && src.length() > GH_LZ_ANSWER) {
+            String lz;
+            if (GH_lzPack(src, lz)) {
+                bin = lz;
+                return 1;
+            }
+        }
+        return mp;
+    }
+
+    void _transmit(const String& data, bool bin, GHconn_t conn, uint8_t flags, const char* hubID, uint32_t client) {
+#ifndef GH_NO_WS
+        if (conn == GH_WS) {
+            if (flags & GH_JOB_ANSWER) answerWS(data, bin, client);
+            else sendWS(data, bin);
+        }
+#endif
+#ifndef GH_NO_MQTT
+        if (conn == GH_MQTT) {
+            if (flags & GH_JOB_ANSWER) answerMQTT(data, hubID);
+            else sendMQTT(data);
+        }
+#endif
+    }
+
+#ifdef GH_WORKER
+    // в фоновой задаче: только упаковка. Сетевые библиотеки (и AsyncMqttClient) не потокобезопасны
+    static void _jobWork(void* self, GHjob& job) {
+        String packed;
+        if (_encode(job.data, packed, job.flags)) {
+            job.data = packed;
+            job.flags |= GH_JOB_BIN;
+        }
+    }
+
+    // в loop (worker.flush в tick): отправка упакованного
+    static void _jobOut(void* self, GHjob& job) {
+        ((GyverHub*)self)->_transmit(job.data, job.flags & GH_JOB_BIN, (GHconn_t)job.conn, job.flags, job.id, job.client);
+    }
+#endif
+#endif
+
     // ========================== MISC ==========================
     void setFocus(GHconn_t conn) {
-        focus_arr[conn] = GH_CONN_TOUT;
+        wheel.start(focus_t[conn], GH_CONN_TOUT * 1000ul);
     }
     void clearFocus(GHconn_t conn) {
-        focus_arr[conn] = 0;
+        focus_t[conn].stop();
+        if (hub_ptr) caps.set(*hub_ptr, nullptr);  // возможности остальных клиентов подключения не трогаем
         hub_ptr = nullptr;
     }
 
     // ========================== ADDER ==========================
     void _jsVal(String& s, FSTR key, uint32_t value, bool last = false) {
-        s += '\'';
+        s += '\"';
         s += key;
-        s += F("':");
+        s += F("\":");
         s += value;
         if (!last) s += ',';
     }
     template <typename T>
     void _jsStr(String& s, FSTR key, T value, bool last = false) {
-        s += '\'';
+        s += '\"';
         s += key;
-        s += F("':'");
+        s += F("\":\"");
         s += value;
-        s += '\'';
+        s += '\"';
+        if (!last) s += ',';
+    }
+    // строка с экранированием (пользовательский текст)
+    void _jsText(String& s, FSTR key, const char* value, bool last = false) {
+        s += '\"';
+        s += key;
+        s += F("\":\"");
+        GH_escapeStr(&s, value, false);
+        s += '\"';
         if (!last) s += ',';
     }
     void _jsArr(String& s, const String& value, bool last = false) {
-        s += '\'';
-        s += value;
-        s += '\'';
+        s += '\"';
+        GH_escapeStr(&s, value.c_str(), false);
+        s += '\"';
         if (!last) s += ',';
     }
     void _jsID(String& s, bool last = false) {
-        s += F("'id':'");
+        s += F("\"id\":\"");
         s += id;
-        s += '\'';
+        s += '\"';
         if (!last) s += ',';
     }
     void _jsBegin(String& s) {
@@ -1212,6 +1672,7 @@ class GyverHub : public HubBuilder {
     const char* name = nullptr;
     const char* icon = nullptr;
     const char* version = nullptr;
+    const char* group = nullptr;
     uint32_t PIN = 0;
     char id[9];
 
@@ -1234,30 +1695,47 @@ class GyverHub : public HubBuilder {
     uint16_t buf_size = 0;
     uint16_t buf_count = 0;
 
-    uint16_t focus_tmr = 0;
-    int8_t focus_arr[GH_CONN_AMOUNT] = {};
+    GHwheel wheel;
+    GHarena arena;
+    GHwheelTimer focus_t[GH_CONN_AMOUNT];
+    GHcaps caps;
+
+    String disc_s;
+    GHhub disc_hub;
+    GHwheelTimer disc_t;
+    uint16_t disc_delay = 0;
+
+#ifdef GH_NET_BUILD
+    bool auto_f = 0;
+#endif
 
 #ifdef GH_ESP_BUILD
     void (*reboot_cb)(GHreason_t r) = nullptr;
-    bool auto_f = 0;
     GHreason_t reboot_f = GH_REB_NONE;
 
 #ifndef GH_NO_FS
-#ifndef GH_NO_OTA_URL
-    String ota_url;
-    bool ota_url_f = 0;
-    bool ota_url_fs = 0;
+#if !defined(GH_NO_OTA) && !defined(GH_NO_OTA_URL)
+    GHotaUrl ota_url;
 #endif
     bool fs_mounted = 0;
     GHhub fs_hub;
     GHevent_t fs_state = GH_IDLE;
-    char* fs_buffer = nullptr;
+    char* fs_buffer = nullptr;  // чанк загрузки в работе (= fs_chunk)
+    char* fs_chunk = nullptr;   // постоянный буфер чанка (в арене или в куче)
     File file_d, file_u;
+    String upl_path;
+    uint32_t upl_token = 0;
+    GHlz* fs_lz = nullptr;
+    GHdelta* fs_delta = nullptr;
     bool ota_f = false;
     uint16_t dwn_chunk_count = 0;
     uint16_t dwn_chunk_amount = 0;
-    uint16_t fs_tmr = 0;
+    GHwheelTimer fs_t;
+#endif
 #endif
+
+#ifdef GH_WORKER
+    GHworker worker;  // последним: при удалении отправляет очередь через остальные поля
 #endif
 };
 #endif
\ No newline at end of file
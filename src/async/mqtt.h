@@ -13,7 +13,9 @@ class HubMQTT {
 #include <Arduino.h>
 #include <AsyncMqttClient.h>
 
+#include "../utils/inbox.h"
 #include "../utils/stats.h"
+#include "../utils/wheel.h"
 
 class HubMQTT {
     // ============ PUBLIC =============
@@ -40,7 +42,9 @@ class HubMQTT {
     virtual const char* getPrefix() = 0;
     virtual const char* getID() = 0;
     virtual void sendEvent(GHevent_t state, GHconn_t conn) = 0;
+    virtual GHwheel& getWheel() = 0;
 
+    // обработчики работают в задаче async tcp: пакеты и события складываются в очередь, разбираются в tick
     void beginMQTT() {
         mqtt.onConnect([this](GH_UNUSED bool pres) {
             String sub_topic(getPrefix());
@@ -60,23 +64,19 @@ class HubMQTT {
 
             String online(F("online"));
             sendMQTT(status, online);
-            sendEvent(GH_CONNECTED, GH_MQTT);
-            mqtt_tmr = millis();
+            mq_inbox.push(GH_MQTT, GH_CONNECTED);
         });
 
         mqtt.onDisconnect([this](GH_UNUSED AsyncMqttClientDisconnectReason reason) {
             String m_id("DEV-");
             m_id += String(random(0xffffff), HEX);
             mqtt.setClientId(m_id.c_str());
-            sendEvent(GH_DISCONNECTED, GH_MQTT);
-            mqtt_tmr = millis();
+            mq_inbox.push(GH_MQTT, GH_DISCONNECTED);
+            mq_lost = true;  // обработчик в задаче async tcp, колесо трогаем только из tick
         });
 
         mqtt.onMessage([this](char* topic, char* data, GH_UNUSED AsyncMqttClientMessageProperties prop, size_t len, GH_UNUSED size_t index, GH_UNUSED size_t total) {
-            char data_c[len + 1];
-            if (len) strncpy(data_c, (char*)data, len);
-            data_c[len] = 0;
-            parse(topic, data_c, GH_MQTT, false);
+            mq_inbox.push(GH_MQTT, 0, topic, strlen(topic), data, len);
         });
     }
 
@@ -85,8 +85,18 @@ class HubMQTT {
     }
 
     void tickMQTT() {
-        if (mq_configured && !mqtt.connected() && (!mqtt_tmr || millis() - mqtt_tmr > GH_MQTT_RECONNECT)) {
-            mqtt_tmr = millis();
+        GHinbox::Frame f;
+        for (uint8_t i = 0; i < GH_INBOX_SIZE && mq_inbox.peek(f); i++) {
+            if (f.event) sendEvent((GHevent_t)f.event, GH_MQTT);
+            else parse(f.url, f.value, GH_MQTT, false);
+            mq_inbox.pop();
+        }
+        if (mq_lost) {
+            mq_lost = false;
+            getWheel().start(mq_reconn, GH_MQTT_RECONNECT);
+        }
+        if (mq_configured && !mqtt.connected() && !mq_reconn.active()) {
+            getWheel().start(mq_reconn, GH_MQTT_RECONNECT);
             sendEvent(GH_CONNECTING, GH_MQTT);
             mqtt.connect();
         }
@@ -123,7 +133,9 @@ class HubMQTT {
 
     AsyncMqttClient mqtt;
     bool mq_configured = false;
-    uint32_t mqtt_tmr = 0;
+    GHwheelTimer mq_reconn;
+    volatile bool mq_lost = false;
+    GHinbox mq_inbox;
     uint8_t qos = 0;
     bool ret = 0;
 };
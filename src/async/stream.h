@@ -0,0 +1,106 @@
+#pragma once
+#include "../config.hpp"
+#include "../macro.hpp"
+
+#ifdef GH_ESP_BUILD
+#ifdef GH_NO_STREAM
+class HubStream {
+   public:
+    bool setupStream(size_t size, const char* mime = nullptr) { return 0; }
+    void onStream(size_t (*handler)(uint8_t* buf, size_t size)) {}
+    bool streamFrame(const uint8_t* data, size_t len) { return 0; }
+    uint8_t streamClients() { return 0; }
+};
+#else
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+#include "../utils/frames.h"
+
+class HubStream {
+    // ============ PUBLIC =============
+   public:
+    HubStream() : stream_server(GH_HTTPD_PORT) {}
+
+    // включить стрим, указать макс. размер кадра в байтах и тип данных (умолч. image/jpeg). Вызывать до begin()
+    bool setupStream(size_t size, const char* mime = nullptr) {
+        stream_mime = mime;
+        return frames.begin(size);
+    }
+
+    // подключить функцию-источник кадров вида size_t f(uint8_t* buf, size_t size). Вернуть длину записанного в buf кадра или 0
+    void onStream(size_t (*handler)(uint8_t* buf, size_t size)) {
+        stream_cb = *handler;
+    }
+
+    // отправить кадр в стрим. false - кадр пропущен
+    bool streamFrame(const uint8_t* data, size_t len) {
+        return frames.push(data, len);
+    }
+
+    // количество подключенных к стриму клиентов
+    uint8_t streamClients() {
+        return stream_clients;
+    }
+
+    // ============ PROTECTED =============
+   protected:
+    void beginStream() {
+        if (!frames.state()) return;
+        stream_server.on("/", HTTP_GET, [this](AsyncWebServerRequest* request) {
+            if (stream_clients >= GH_STREAM_CLIENTS) {
+                request->send(request->beginResponse(503));
+                return;
+            }
+            GHframeSender* c = new GHframeSender;
+            stream_clients++;
+            request->client()->setAckTimeout(GH_STREAM_TIMEOUT);  // клиент не принимает данные - AsyncTCP отключит его
+            request->onDisconnect([this, c]() {
+                c->reset(frames);
+                delete c;
+                stream_clients--;
+            });
+            AsyncWebServerResponse* response = request->beginChunkedResponse(F("multipart/x-mixed-replace;boundary=" GH_STREAM_BOUNDARY), [this, c](uint8_t* buf, size_t maxLen, GH_UNUSED size_t index) -> size_t {
+                size_t len = c->send(frames, stream_mime, maxLen, _copy, &buf);
+                return len ? len : RESPONSE_TRY_AGAIN;  // нового кадра нет - попробовать позже
+            });
+            response->addHeader(F("Access-Control-Allow-Origin"), F("*"));
+            response->addHeader(F("Cache-Control"), F("no-cache"));
+            request->send(response);
+        });
+        stream_server.begin();
+    }
+
+    void endStream() {
+        if (frames.state()) stream_server.end();
+    }
+
+    void tickStream() {
+        if (!frames.state() || !stream_cb || !stream_clients) return;
+        uint8_t* buf = frames.claim();
+        if (buf) {
+            size_t len = stream_cb(buf, frames.capacity());
+            if (len) frames.commit(len);
+            else frames.cancel();
+        }
+    }
+
+    // ============ PRIVATE =============
+   private:
+    // запись в буфер ответа
+    static size_t _copy(void* arg, const uint8_t* data, size_t len) {
+        uint8_t*& buf = *(uint8_t**)arg;
+        memcpy(buf, data, len);
+        buf += len;
+        return len;
+    }
+
+    AsyncWebServer stream_server;
+    GHframes frames;
+    volatile uint8_t stream_clients = 0;
+    size_t (*stream_cb)(uint8_t* buf, size_t size) = nullptr;
+    const char* stream_mime = nullptr;
+};
+#endif
+#endif
@@ -0,0 +1,3 @@
+#pragma once
+// UDP опрашивается из tick(), отдельная async реализация не нужна
+#include "../sync/udp.h"
@@ -12,6 +12,7 @@ class HubWS {
 #include <Arduino.h>
 #include <ESPAsyncWebServer.h>
 
+#include "../utils/inbox.h"
 #include "../utils/stats.h"
 
 class HubWS {
@@ -24,26 +25,26 @@ class HubWS {
     virtual void parse(char* url, GHconn_t conn, bool manual) = 0;
     virtual void sendEvent(GHevent_t state, GHconn_t conn) = 0;
 
+    // обработчик работает в задаче async tcp: пакеты и события складываются в очередь, разбираются в tick
     void beginWS() {
         ws.onEvent([this](GH_UNUSED AsyncWebSocket* server, GH_UNUSED AsyncWebSocketClient* client, AwsEventType etype, void* arg, uint8_t* data, size_t len) {
             switch (etype) {
                 case WS_EVT_CONNECT:
-                    sendEvent(GH_CONNECTED, GH_WS);
+                    ws_inbox.push(GH_WS, GH_CONNECTED);
                     break;
 
                 case WS_EVT_DISCONNECT:
-                    sendEvent(GH_DISCONNECTED, GH_WS);
+                    ws_inbox.push(GH_WS, GH_DISCONNECTED);
                     break;
-                    
+
                 case WS_EVT_ERROR:
-                    sendEvent(GH_ERROR, GH_WS);
+                    ws_inbox.push(GH_WS, GH_ERROR);
                     break;
 
                 case WS_EVT_DATA: {
                     AwsFrameInfo* ws_info = (AwsFrameInfo*)arg;
                     if (ws_info->final && ws_info->index == 0 && ws_info->len == len && ws_info->opcode == WS_TEXT) {
-                        clientID = client->id();
-                        parse((char*)data, GH_WS, false);
+                        ws_inbox.push(GH_WS, client->id(), (char*)data, len);
                     }
                 } break;
 
@@ -60,15 +61,32 @@ class HubWS {
     }
 
     void tickWS() {
+        GHinbox::Frame f;
+        for (uint8_t i = 0; i < GH_INBOX_SIZE && ws_inbox.peek(f); i++) {
+            if (f.event) {
+                sendEvent((GHevent_t)f.event, GH_WS);
+            } else {
+                clientID = f.id;
+                parse(f.url, GH_WS, false);
+            }
+            ws_inbox.pop();
+        }
         ws.cleanupClients();
     }
 
-    void sendWS(const String& answ) {
-        ws.textAll(answ.c_str());
+    void sendWS(const String& answ, bool bin = false) {
+        if (bin) ws.binaryAll((uint8_t*)answ.c_str(), answ.length());
+        else ws.textAll(answ.c_str());
+    }
+
+    // клиент последнего входящего пакета
+    uint32_t clientWS() {
+        return clientID;
     }
 
-    void answerWS(String& answ) {
-        ws.text(clientID, answ.c_str());
+    void answerWS(const String& answ, bool bin, uint32_t client) {
+        if (bin) ws.binary(client, (uint8_t*)answ.c_str(), answ.length());
+        else ws.text(client, answ.c_str());
     }
 
     // ============ PRIVATE =============
@@ -76,6 +94,7 @@ class HubWS {
     AsyncWebServer server;
     AsyncWebSocket ws;
     uint32_t clientID = 0;
+    GHinbox ws_inbox;
 };
 #endif
 #endif
\ No newline at end of file
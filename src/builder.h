@@ -4,12 +4,14 @@
 #include "canvas.h"
 #include "config.hpp"
 #include "macro.hpp"
+#include "utils/bind.h"
 #include "utils/build.h"
 #include "utils/color.h"
 #include "utils/datatypes.h"
 #include "utils/log.h"
 #include "utils/misc.h"
 #include "utils/pos.h"
+#include "utils/series.h"
 
 class HubBuilder {
    public:
@@ -17,15 +19,15 @@ class HubBuilder {
     void BeginWidgets(int height = 0) {
         if (_isUI()) {
             tab_width = 100;
-            _add(F("{'type':'widget_b','height':"));
-            *sptr += height;
+            _begin(F("widget_b"));
+            _int(F("height"), F("h"), height, 0);
             _end();
         }
     }
     void EndWidgets() {
         tab_width = 0;
         if (_isUI()) {
-            _add(F("{'type':'widget_e'"));
+            _begin(F("widget_e"));
             _end();
         }
     }
@@ -35,466 +37,534 @@ class HubBuilder {
 
     // ========================== DUMMY ===========================
     bool Dummy(FSTR name, void* value = nullptr, GHdata_t type = GH_NULL) {
-        return _dummy(true, name, value, type);
+        return _dummy<GHpgm>(name, GHvar(value, type));
     }
     bool Dummy(CSREF name, void* value = nullptr, GHdata_t type = GH_NULL) {
-        return _dummy(false, name.c_str(), value, type);
+        return _dummy<GHram>(name.c_str(), GHvar(value, type));
+    }
+    template <typename T>
+    bool Dummy(FSTR name, T* value) {
+        return _dummy<GHpgm>(name, GHvar(value));
+    }
+    template <typename T>
+    bool Dummy(CSREF name, T* value) {
+        return _dummy<GHram>(name.c_str(), GHvar(value));
     }
 
-    bool _dummy(bool fstr, VSPTR name, void* value, GHdata_t type) {
+    template <typename S>
+    bool _dummy(VSPTR name, const GHvar& var) {
         if (_isRead()) {
-            if (_checkName(name, fstr)) GHtypeToStr(sptr, value, type);
+            if (_checkName<S>(name)) var.toStr(sptr);
         } else if (bptr->type == GH_BUILD_ACTION) {
-            return bptr->parseSet(name, value, type, fstr);
+            return bptr->parseSet<S>(name, var);
         }
         return 0;
     }
 
     // ========================== BUTTON ==========================
     bool Button(FSTR name, bool* value = nullptr, FSTR label = nullptr, uint32_t color = GH_DEFAULT, int size = 22) {
-        return _button(true, F("button"), name, value, label, color, size);
+        return _button<GHpgm>(F("button"), name, value, label, color, size, 22);
     }
     bool Button(CSREF name, bool* value = nullptr, CSREF label = "", uint32_t color = GH_DEFAULT, int size = 22) {
-        return _button(false, F("button"), name.c_str(), value, label.c_str(), color, size);
+        return _button<GHram>(F("button"), name.c_str(), value, label.c_str(), color, size, 22);
     }
 
     bool ButtonIcon(FSTR name, bool* value = nullptr, FSTR label = nullptr, uint32_t color = GH_DEFAULT, int size = 50) {
-        return _button(true, F("button_i"), name, value, label, color, size);
+        return _button<GHpgm>(F("button_i"), name, value, label, color, size, 50);
     }
     bool ButtonIcon(CSREF name, bool* value = nullptr, CSREF label = "", uint32_t color = GH_DEFAULT, int size = 50) {
-        return _button(false, F("button_i"), name.c_str(), value, label.c_str(), color, size);
+        return _button<GHram>(F("button_i"), name.c_str(), value, label.c_str(), color, size, 50);
     }
 
-    bool _button(bool fstr, FSTR tag, VSPTR name, bool* value, VSPTR label, uint32_t color, int size) {
+    template <typename S>
+    bool _button(FSTR tag, VSPTR name, bool* value, VSPTR label, uint32_t color, int size, int defsize) {
         if (_isUI()) {
             _begin(tag);
-            _name(name, fstr);
-            _label(label, fstr);
+            _name<S>(name);
+            _label<S>(label);
             _color(color);
-            _size(size);
+            _size(size, defsize);
             _tabw();
             _end();
         } else if (bptr->type == GH_BUILD_ACTION) {
-            return bptr->parseClick(name, value, fstr);
+            return bptr->parseClick<S>(name, value);
         }
         return 0;
     }
 
     // ========================== LABEL ==========================
     void Label(FSTR name, const String& value = "", FSTR label = nullptr, uint32_t color = GH_DEFAULT, int size = 40) {
-        _label(true, name, value, label, color, size);
+        _label<GHpgm>(name, value, label, color, size);
     }
     void Label(CSREF name, const String& value = "", CSREF label = "", uint32_t color = GH_DEFAULT, int size = 40) {
-        _label(false, name.c_str(), value, label.c_str(), color, size);
+        _label<GHram>(name.c_str(), value, label.c_str(), color, size);
     }
-    void _label(bool fstr, VSPTR name, const String& value, VSPTR label, uint32_t color, int size) {
+    template <typename S>
+    void _label(VSPTR name, const String& value, VSPTR label, uint32_t color, int size) {
         if (_isUI()) {
             _begin(F("label"));
-            _name(name, fstr);
-            _value();
-            _quot();
-            *sptr += value;
-            _quot();
-            _label(label, fstr);
+            _name<S>(name);
+            _value<GHram>(value.c_str());
+            _label<S>(label);
             _color(color);
-            _size(size);
+            _size(size, 40);
             _tabw();
             _end();
         } else if (_isRead()) {
-            if (_checkName(name, fstr)) *sptr += value;
+            if (_checkName<S>(name)) GHram::escape(sptr, value.c_str());
         }
     }
 
     // ========================== TITLE ==========================
     void Title(FSTR label) {
-        _title(true, label);
+        _title<GHpgm>(label);
     }
     void Title(CSREF label) {
-        _title(false, label.c_str());
+        _title<GHram>(label.c_str());
     }
-    void _title(bool fstr, VSPTR label) {
+    template <typename S>
+    void _title(VSPTR label) {
         if (_isUI()) {
             _begin(F("title"));
-            _label(label, fstr);
+            _label<S>(label);
             _end();
         }
     }
 
     // ========================== LOG ==========================
     void Log(FSTR name, GHlog* log, FSTR label = nullptr) {
-        _log(true, name, log, label);
+        _log<GHpgm>(name, log, label);
     }
     void Log(CSREF name, GHlog* log, CSREF label = "") {
-        _log(false, name.c_str(), log, label.c_str());
+        _log<GHram>(name.c_str(), log, label.c_str());
     }
-    void _log(bool fstr, VSPTR name, GHlog* log, VSPTR label) {
+    template <typename S>
+    void _log(VSPTR name, GHlog* log, VSPTR label) {
         if (_isUI()) {
             _begin(F("log"));
-            _name(name, fstr);
+            _name<S>(name);
             _text();
             _quot();
-            log->read(sptr);
+            uint32_t seq = log->readSince(sptr, 0);
             _quot();
-            _label(label, fstr);
+            _key(F("seq"), F("q"));
+            *sptr += seq;
+            _label<S>(label);
             _tabw();
             _end();
         } else if (_isRead()) {
-            if (_checkName(name, fstr)) GH_escapeStr(sptr, log->read().c_str(), false);
+            if (_checkName<S>(name)) log->read(sptr);  // read() уже экранирует
         }
     }
 
     // ========================== DISPLAY ==========================
     void Display(FSTR name, FSTR value = nullptr, FSTR label = nullptr, uint32_t color = GH_DEFAULT, int rows = 2, int size = 40) {
-        _display(true, name, value, label, color, rows, size);
+        _display<GHpgm>(name, value, label, color, rows, size);
     }
     void Display(CSREF name, const String& value = "", CSREF label = "", uint32_t color = GH_DEFAULT, int rows = 2, int size = 40) {
-        _display(false, name.c_str(), value.c_str(), label.c_str(), color, rows, size);
+        _display<GHram>(name.c_str(), value.c_str(), label.c_str(), color, rows, size);
     }
-    void _display(bool fstr, VSPTR name, VSPTR value, VSPTR label, uint32_t color, int rows, int size) {
+    template <typename S>
+    void _display(VSPTR name, VSPTR value, VSPTR label, uint32_t color, int rows, int size) {
         if (_isUI()) {
             _begin(F("display"));
-            _name(name, fstr);
-            _value();
-            _quot();
-            GH_escapeStr(sptr, value, fstr);
-            _quot();
-            _label(label, fstr);
+            _name<S>(name);
+            _value<S>(value);
+            _label<S>(label);
             _color(color);
-            _add(F(",'rows':"));
-            *sptr += rows;
-            _size(size);
+            _int(F("rows"), F("r"), rows, 2);
+            _size(size, 40);
             _tabw();
             _end();
         } else if (_isRead()) {
-            if (_checkName(name, fstr)) GH_escapeStr(sptr, value, fstr);
+            if (_checkName<S>(name)) _escape<S>(value);
         }
     }
 
     // ========================== HTML ==========================
     void HTML(FSTR name, FSTR value = nullptr, FSTR label = nullptr) {
-        _html(true, name, value, label);
+        _html<GHpgm>(name, value, label);
     }
     void HTML(CSREF name, const String& value = "", CSREF label = "") {
-        _html(false, name.c_str(), value.c_str(), label.c_str());
+        _html<GHram>(name.c_str(), value.c_str(), label.c_str());
     }
-    void _html(bool fstr, VSPTR name, VSPTR value, VSPTR label) {
+    template <typename S>
+    void _html(VSPTR name, VSPTR value, VSPTR label) {
         if (_isUI()) {
             _begin(F("html"));
-            _name(name, fstr);
-            _value();
-            _quot();
-            GH_escapeStr(sptr, value, fstr);
-            _quot();
-            _label(label, fstr);
+            _name<S>(name);
+            _value<S>(value);
+            _label<S>(label);
             _tabw();
             _end();
         } else if (_isRead()) {
-            if (_checkName(name, fstr)) GH_escapeStr(sptr, value, fstr);
+            if (_checkName<S>(name)) _escape<S>(value);
         }
     }
 
     // =========================== JS ===========================
     void JS(FSTR value = nullptr) {
-        _js(true, value);
+        _js<GHpgm>(value);
     }
     void JS(const String& value = "") {
-        _js(false, value.c_str());
+        _js<GHram>(value.c_str());
     }
-    void _js(bool fstr, VSPTR value) {
+    template <typename S>
+    void _js(VSPTR value) {
         if (_isUI()) {
             _begin(F("js"));
-            _value();
-            _quot();
-            GH_escapeStr(sptr, value, fstr);
-            _quot();
+            _value<S>(value);
             _end();
         }
     }
 
     // ========================== INPUT ==========================
     bool Input(FSTR name, void* value = nullptr, GHdata_t type = GH_NULL, FSTR label = nullptr, int maxv = 0, FSTR regex = nullptr, uint32_t color = GH_DEFAULT) {
-        return _input(true, F("input"), name, value, type, label, maxv, regex, color);
+        return _input<GHpgm>(F("input"), name, GHvar(value, type), label, maxv, regex, color);
     }
     bool Input(CSREF name, void* value = nullptr, GHdata_t type = GH_NULL, CSREF label = "", int maxv = 0, CSREF regex = "", uint32_t color = GH_DEFAULT) {
-        return _input(false, F("input"), name.c_str(), value, type, label.c_str(), maxv, regex.c_str(), color);
+        return _input<GHram>(F("input"), name.c_str(), GHvar(value, type), label.c_str(), maxv, regex.c_str(), color);
+    }
+    template <typename T>
+    bool Input(FSTR name, T* value, FSTR label = nullptr, int maxv = 0, FSTR regex = nullptr, uint32_t color = GH_DEFAULT) {
+        return _input<GHpgm>(F("input"), name, GHvar(value), label, maxv, regex, color);
+    }
+    template <typename T>
+    bool Input(CSREF name, T* value, CSREF label = "", int maxv = 0, CSREF regex = "", uint32_t color = GH_DEFAULT) {
+        return _input<GHram>(F("input"), name.c_str(), GHvar(value), label.c_str(), maxv, regex.c_str(), color);
     }
 
     // ========================== PASS ==========================
     bool Pass(FSTR name, void* value = nullptr, GHdata_t type = GH_NULL, FSTR label = nullptr, int maxv = 0, uint32_t color = GH_DEFAULT) {
-        return _input(true, F("pass"), name, value, type, label, maxv, nullptr, color);
+        return _input<GHpgm>(F("pass"), name, GHvar(value, type), label, maxv, nullptr, color);
     }
     bool Pass(CSREF name, void* value = nullptr, GHdata_t type = GH_NULL, CSREF label = "", int maxv = 0, uint32_t color = GH_DEFAULT) {
-        return _input(false, F("pass"), name.c_str(), value, type, label.c_str(), maxv, "", color);
+        return _input<GHram>(F("pass"), name.c_str(), GHvar(value, type), label.c_str(), maxv, "", color);
+    }
+    template <typename T>
+    bool Pass(FSTR name, T* value, FSTR label = nullptr, int maxv = 0, uint32_t color = GH_DEFAULT) {
+        return _input<GHpgm>(F("pass"), name, GHvar(value), label, maxv, nullptr, color);
+    }
+    template <typename T>
+    bool Pass(CSREF name, T* value, CSREF label = "", int maxv = 0, uint32_t color = GH_DEFAULT) {
+        return _input<GHram>(F("pass"), name.c_str(), GHvar(value), label.c_str(), maxv, "", color);
     }
 
-    bool _input(bool fstr, FSTR tag, VSPTR name, void* value, GHdata_t type, VSPTR label, int maxv, VSPTR regex, uint32_t color) {
+    template <typename S>
+    bool _input(FSTR tag, VSPTR name, const GHvar& var, VSPTR label, int maxv, VSPTR regex, uint32_t color) {
         if (_isUI()) {
             _begin(tag);
-            _name(name, fstr);
-            _value();
-            _quot();
-            GHtypeToStr(sptr, value, type);
-            _quot();
-            _label(label, fstr);
+            _name<S>(name);
+            _value(var);
+            _label<S>(label);
             if (maxv) _maxv((long)maxv);
-            _add(F(",'regex':'"));
-            GH_escapeStr(sptr, regex, fstr);
-            _quot();
+            _str<S>(F("regex"), F("re"), regex);
             _color(color);
             _tabw();
             _end();
         } else if (_isRead()) {
-            if (_checkName(name, fstr)) GHtypeToStr(sptr, value, type);
+            if (_checkName<S>(name)) var.toStr(sptr);
         } else if (bptr->type == GH_BUILD_ACTION) {
-            return bptr->parseSet(name, value, type, fstr);
+            return bptr->parseSet<S>(name, var);
         }
         return 0;
     }
 
     // ========================== SLIDER ==========================
     bool Slider(FSTR name, void* value = nullptr, GHdata_t type = GH_NULL, FSTR label = nullptr, float minv = 0, float maxv = 100, float step = 1, uint32_t color = GH_DEFAULT) {
-        return _spinner(true, F("slider"), name, value, type, label, minv, maxv, step, color);
+        return _spinner<GHpgm>(F("slider"), name, GHvar(value, type), label, minv, maxv, step, color);
     }
     bool Slider(CSREF name, void* value = nullptr, GHdata_t type = GH_NULL, CSREF label = "", float minv = 0, float maxv = 100, float step = 1, uint32_t color = GH_DEFAULT) {
-        return _spinner(false, F("slider"), name.c_str(), value, type, label.c_str(), minv, maxv, step, color);
+        return _spinner<GHram>(F("slider"), name.c_str(), GHvar(value, type), label.c_str(), minv, maxv, step, color);
+    }
+    template <typename T>
+    bool Slider(FSTR name, T* value, FSTR label = nullptr, float minv = 0, float maxv = 100, float step = 1, uint32_t color = GH_DEFAULT) {
+        return _spinner<GHpgm>(F("slider"), name, GHvar(value), label, minv, maxv, step, color);
+    }
+    template <typename T>
+    bool Slider(CSREF name, T* value, CSREF label = "", float minv = 0, float maxv = 100, float step = 1, uint32_t color = GH_DEFAULT) {
+        return _spinner<GHram>(F("slider"), name.c_str(), GHvar(value), label.c_str(), minv, maxv, step, color);
     }
 
     // ========================== SPINNER ==========================
     bool Spinner(FSTR name, void* value = nullptr, GHdata_t type = GH_NULL, FSTR label = nullptr, float minv = 0, float maxv = 100, float step = 1, uint32_t color = GH_DEFAULT) {
-        return _spinner(true, F("spinner"), name, value, type, label, minv, maxv, step, color);
+        return _spinner<GHpgm>(F("spinner"), name, GHvar(value, type), label, minv, maxv, step, color);
     }
     bool Spinner(CSREF name, void* value = nullptr, GHdata_t type = GH_NULL, CSREF label = "", float minv = 0, float maxv = 100, float step = 1, uint32_t color = GH_DEFAULT) {
-        return _spinner(false, F("spinner"), name.c_str(), value, type, label.c_str(), minv, maxv, step, color);
+        return _spinner<GHram>(F("spinner"), name.c_str(), GHvar(value, type), label.c_str(), minv, maxv, step, color);
+    }
+    template <typename T>
+    bool Spinner(FSTR name, T* value, FSTR label = nullptr, float minv = 0, float maxv = 100, float step = 1, uint32_t color = GH_DEFAULT) {
+        return _spinner<GHpgm>(F("spinner"), name, GHvar(value), label, minv, maxv, step, color);
+    }
+    template <typename T>
+    bool Spinner(CSREF name, T* value, CSREF label = "", float minv = 0, float maxv = 100, float step = 1, uint32_t color = GH_DEFAULT) {
+        return _spinner<GHram>(F("spinner"), name.c_str(), GHvar(value), label.c_str(), minv, maxv, step, color);
     }
 
-    bool _spinner(bool fstr, FSTR tag, VSPTR name, void* value, GHdata_t type, VSPTR label, float minv, float maxv, float step, uint32_t color) {
+    template <typename S>
+    bool _spinner(FSTR tag, VSPTR name, const GHvar& var, VSPTR label, float minv, float maxv, float step, uint32_t color) {
         if (_isUI()) {
             _begin(tag);
-            _name(name, fstr);
+            _name<S>(name);
             _value();
-            GHtypeToStr(sptr, value, type);
-            _label(label, fstr);
-            _minv(minv);
-            _maxv(maxv);
-            _step(step);
+            var.toStr(sptr);
+            _label<S>(label);
+            _range(minv, maxv, step);
             _color(color);
             _tabw();
             _end();
         } else if (_isRead()) {
-            if (_checkName(name, fstr)) GHtypeToStr(sptr, value, type);
+            if (_checkName<S>(name)) var.toStr(sptr);
         } else if (bptr->type == GH_BUILD_ACTION) {
-            return bptr->parseSet(name, value, type, fstr);
+            return bptr->parseSet<S>(name, var);
         }
         return 0;
     }
 
     // ========================== GAUGE ===========================
     void Gauge(FSTR name, float value = 0, FSTR text = nullptr, FSTR label = nullptr, float minv = 0, float maxv = 100, float step = 1, uint32_t color = GH_DEFAULT) {
-        _gauge(true, name, value, text, label, minv, maxv, step, color);
+        _gauge<GHpgm>(name, value, text, label, minv, maxv, step, color);
     }
     void Gauge(CSREF name, float value = 0, CSREF text = "", CSREF label = "", float minv = 0, float maxv = 100, float step = 1, uint32_t color = GH_DEFAULT) {
-        _gauge(false, name.c_str(), value, text.c_str(), label.c_str(), minv, maxv, step, color);
+        _gauge<GHram>(name.c_str(), value, text.c_str(), label.c_str(), minv, maxv, step, color);
     }
 
-    void _gauge(bool fstr, VSPTR name, float value, VSPTR text, VSPTR label, float minv, float maxv, float step, uint32_t color) {
+    template <typename S>
+    void _gauge(VSPTR name, float value, VSPTR text, VSPTR label, float minv, float maxv, float step, uint32_t color) {
         if (_isUI()) {
             _begin(F("gauge"));
-            _name(name, fstr);
+            _name<S>(name);
             _value();
             *sptr += value;
-            _text(text, fstr);
-            _label(label, fstr);
-            _minv(minv);
-            _maxv(maxv);
-            _step(step);
+            _text<S>(text);
+            _label<S>(label);
+            _range(minv, maxv, step);
+            _color(color);
+            _tabw();
+            _end();
+        } else if (_isRead()) {
+            if (_checkName<S>(name)) *sptr += value;
+        }
+    }
+
+    // ========================== CHART ===========================
+    void Chart(FSTR name, GHseriesBase* series, FSTR label = nullptr, uint32_t color = GH_DEFAULT, uint16_t width = 100, uint8_t mode = GH_SERIES_LTTB) {
+        _chart<GHpgm>(name, series, label, color, width, mode);
+    }
+    void Chart(CSREF name, GHseriesBase* series, CSREF label = "", uint32_t color = GH_DEFAULT, uint16_t width = 100, uint8_t mode = GH_SERIES_LTTB) {
+        _chart<GHram>(name.c_str(), series, label.c_str(), color, width, mode);
+    }
+
+    template <typename S>
+    void _chart(VSPTR name, GHseriesBase* series, VSPTR label, uint32_t color, uint16_t width, uint8_t mode) {
+        if (_isUI()) {
+            _begin(F("chart"));
+            _name<S>(name);
+            _value();
+            _quot();
+            series->read(sptr, width, mode);
+            _quot();
+            _key(F("size"), F("s"));
+            *sptr += series->capacity();
+            _label<S>(label);
             _color(color);
             _tabw();
             _end();
         } else if (_isRead()) {
-            if (_checkName(name, fstr)) *sptr += value;
+            if (_checkName<S>(name)) {
+                uint32_t& sent = bptr->reads->get ? series->sent_get : series->sent;
+                sent = series->readSince(sptr, sent);
+            }
         }
     }
 
     // ========================== SWITCH ==========================
     bool Switch(FSTR name, bool* value = nullptr, FSTR label = nullptr, uint32_t color = GH_DEFAULT) {
-        return _switch(true, F("switch"), name, value, label, color, nullptr);
+        return _switch<GHpgm>(F("switch"), name, value, label, color, nullptr);
     }
     bool Switch(CSREF name, bool* value = nullptr, CSREF label = "", uint32_t color = GH_DEFAULT) {
-        return _switch(false, F("switch"), name.c_str(), value, label.c_str(), color, nullptr);
+        return _switch<GHram>(F("switch"), name.c_str(), value, label.c_str(), color, nullptr);
     }
 
     bool SwitchIcon(FSTR name, bool* value = nullptr, FSTR label = nullptr, FSTR text = nullptr, uint32_t color = GH_DEFAULT) {
-        return _switch(true, F("switch_i"), name, value, label, color, text);
+        return _switch<GHpgm>(F("switch_i"), name, value, label, color, text);
     }
     bool SwitchIcon(CSREF name, bool* value = nullptr, CSREF label = "", CSREF text = "", uint32_t color = GH_DEFAULT) {
-        return _switch(false, F("switch_i"), name.c_str(), value, label.c_str(), color, text.c_str());
+        return _switch<GHram>(F("switch_i"), name.c_str(), value, label.c_str(), color, text.c_str());
     }
 
     bool SwitchText(FSTR name, bool* value = nullptr, FSTR label = nullptr, FSTR text = nullptr, uint32_t color = GH_DEFAULT) {
-        return _switch(true, F("switch_t"), name, value, label, color, text);
+        return _switch<GHpgm>(F("switch_t"), name, value, label, color, text);
     }
     bool SwitchText(CSREF name, bool* value = nullptr, CSREF label = "", CSREF text = "", uint32_t color = GH_DEFAULT) {
-        return _switch(false, F("switch_t"), name.c_str(), value, label.c_str(), color, text.c_str());
+        return _switch<GHram>(F("switch_t"), name.c_str(), value, label.c_str(), color, text.c_str());
     }
 
-    bool _switch(bool fstr, FSTR tag, VSPTR name, bool* value, VSPTR label, uint32_t color, VSPTR text) {
+    template <typename S>
+    bool _switch(FSTR tag, VSPTR name, bool* value, VSPTR label, uint32_t color, VSPTR text) {
         if (_isUI()) {
             _begin(tag);
-            _name(name, fstr);
+            _name<S>(name);
             _value();
-            GHtypeToStr(sptr, value, GH_BOOL);
-            _label(label, fstr);
+            GHvar(value).toStr(sptr);
+            _label<S>(label);
             _color(color);
-            _text(text, fstr);
+            _text<S>(text);
             _tabw();
             _end();
         } else if (_isRead()) {
-            if (_checkName(name, fstr)) GHtypeToStr(sptr, value, GH_BOOL);
+            if (_checkName<S>(name)) GHvar(value).toStr(sptr);
         } else if (bptr->type == GH_BUILD_ACTION) {
-            return bptr->parseSet(name, value, GH_BOOL, fstr);
+            return bptr->parseSet<S>(name, GHvar(value));
         }
         return 0;
     }
 
     // ========================== DATETIME ==========================
     bool Date(FSTR name, void* value, FSTR label = nullptr, uint32_t color = GH_DEFAULT) {
-        return _date(true, F("date"), name, value, label, color);
+        return _date<GHpgm>(F("date"), name, value, label, color);
     }
     bool Date(CSREF name, void* value, CSREF label = "", uint32_t color = GH_DEFAULT) {
-        return _date(false, F("date"), name.c_str(), value, label.c_str(), color);
+        return _date<GHram>(F("date"), name.c_str(), value, label.c_str(), color);
     }
 
     bool Time(FSTR name, void* value, FSTR label = nullptr, uint32_t color = GH_DEFAULT) {
-        return _date(true, F("time"), name, value, label, color);
+        return _date<GHpgm>(F("time"), name, value, label, color);
     }
     bool Time(CSREF name, void* value, CSREF label = "", uint32_t color = GH_DEFAULT) {
-        return _date(false, F("time"), name.c_str(), value, label.c_str(), color);
+        return _date<GHram>(F("time"), name.c_str(), value, label.c_str(), color);
     }
 
     bool DateTime(FSTR name, void* value, FSTR label = nullptr, uint32_t color = GH_DEFAULT) {
-        return _date(true, F("datetime"), name, value, label, color);
+        return _date<GHpgm>(F("datetime"), name, value, label, color);
     }
     bool DateTime(CSREF name, void* value, CSREF label = "", uint32_t color = GH_DEFAULT) {
-        return _date(false, F("datetime"), name.c_str(), value, label.c_str(), color);
+        return _date<GHram>(F("datetime"), name.c_str(), value, label.c_str(), color);
     }
 
-    bool _date(bool fstr, FSTR tag, VSPTR name, void* value, VSPTR label, uint32_t color) {
+    template <typename S>
+    bool _date(FSTR tag, VSPTR name, void* value, VSPTR label, uint32_t color) {
         if (_isUI()) {
             _begin(tag);
-            _name(name, fstr);
-            _label(label, fstr);
+            _name<S>(name);
+            _label<S>(label);
             _value();
-            GHtypeToStr(sptr, value, GH_UINT32);
+            GHvar((uint32_t*)value).toStr(sptr);
             _color(color);
             _tabw();
             _end();
         } else if (_isRead()) {
-            if (_checkName(name, fstr)) GHtypeToStr(sptr, value, GH_UINT32);
+            if (_checkName<S>(name)) GHvar((uint32_t*)value).toStr(sptr);
         } else if (bptr->type == GH_BUILD_ACTION) {
-            return bptr->parseSet(name, value, GH_UINT32, fstr);
+            return bptr->parseSet<S>(name, GHvar((uint32_t*)value));
         }
         return 0;
     }
 
     // ========================== SELECT ==========================
     bool Select(FSTR name, uint8_t* value, FSTR text, FSTR label = nullptr, uint32_t color = GH_DEFAULT) {
-        return _select(true, name, value, text, label, color);
+        return _select<GHpgm>(name, value, text, label, color);
     }
     bool Select(CSREF name, uint8_t* value, CSREF text, CSREF label = "", uint32_t color = GH_DEFAULT) {
-        return _select(false, name.c_str(), value, text.c_str(), label.c_str(), color);
+        return _select<GHram>(name.c_str(), value, text.c_str(), label.c_str(), color);
     }
 
-    bool _select(bool fstr, VSPTR name, uint8_t* value, VSPTR text, VSPTR label, uint32_t color) {
+    template <typename S>
+    bool _select(VSPTR name, uint8_t* value, VSPTR text, VSPTR label, uint32_t color) {
         if (_isUI()) {
             _begin(F("select"));
-            _name(name, fstr);
+            _name<S>(name);
             _value();
-            GHtypeToStr(sptr, value, GH_UINT8);
-            _text(text, fstr);
-            _label(label, fstr);
+            GHvar(value).toStr(sptr);
+            _text<S>(text);
+            _label<S>(label);
             _color(color);
             _tabw();
             _end();
         } else if (_isRead()) {
-            if (_checkName(name, fstr)) GHtypeToStr(sptr, value, GH_UINT8);
+            if (_checkName<S>(name)) GHvar(value).toStr(sptr);
         } else if (bptr->type == GH_BUILD_ACTION) {
-            return bptr->parseSet(name, value, GH_UINT8, fstr);
+            return bptr->parseSet<S>(name, GHvar(value));
         }
         return 0;
     }
 
     // ========================== FLAGS ==========================
     bool Flags(FSTR name, GHflags* value = nullptr, FSTR text = nullptr, FSTR label = nullptr, uint32_t color = GH_DEFAULT) {
-        return _flags(true, name, value, text, label, color);
+        return _flags<GHpgm>(name, value, text, label, color);
     }
     bool Flags(CSREF name, GHflags* value = nullptr, CSREF text = "", CSREF label = "", uint32_t color = GH_DEFAULT) {
-        return _flags(false, name.c_str(), value, text.c_str(), label.c_str(), color);
+        return _flags<GHram>(name.c_str(), value, text.c_str(), label.c_str(), color);
     }
 
-    bool _flags(bool fstr, VSPTR name, GHflags* value, VSPTR text, VSPTR label, uint32_t color) {
+    template <typename S>
+    bool _flags(VSPTR name, GHflags* value, VSPTR text, VSPTR label, uint32_t color) {
         if (_isUI()) {
             _begin(F("flags"));
-            _name(name, fstr);
+            _name<S>(name);
             _value();
-            GHtypeToStr(sptr, value, GH_FLAGS);
-            _text(text, fstr);
-            _label(label, fstr);
+            GHvar(value).toStr(sptr);
+            _text<S>(text);
+            _label<S>(label);
             _color(color);
             _tabw();
             _end();
         } else if (_isRead()) {
-            if (_checkName(name, fstr)) GHtypeToStr(sptr, value, GH_FLAGS);
+            if (_checkName<S>(name)) GHvar(value).toStr(sptr);
         } else if (bptr->type == GH_BUILD_ACTION) {
-            return bptr->parseSet(name, value, GH_FLAGS, fstr);
+            return bptr->parseSet<S>(name, GHvar(value));
         }
         return 0;
     }
 
     // ========================== COLOR ==========================
     bool Color(FSTR name, GHcolor* value = nullptr, FSTR label = nullptr) {
-        return _color(true, name, value, label);
+        return _color<GHpgm>(name, value, label);
     }
     bool Color(CSREF name, GHcolor* value = nullptr, CSREF label = "") {
-        return _color(false, name.c_str(), value, label.c_str());
+        return _color<GHram>(name.c_str(), value, label.c_str());
     }
 
-    bool _color(bool fstr, VSPTR name, GHcolor* value, VSPTR label) {
+    template <typename S>
+    bool _color(VSPTR name, GHcolor* value, VSPTR label) {
         if (_isUI()) {
             _begin(F("color"));
-            _name(name, fstr);
+            _name<S>(name);
             _value();
-            GHtypeToStr(sptr, value, GH_COLOR);
-            _label(label, fstr);
+            GHvar(value).toStr(sptr);
+            _label<S>(label);
             _tabw();
             _end();
         } else if (_isRead()) {
-            if (_checkName(name, fstr)) GHtypeToStr(sptr, value, GH_COLOR);
+            if (_checkName<S>(name)) GHvar(value).toStr(sptr);
         } else if (bptr->type == GH_BUILD_ACTION) {
-            return bptr->parseSet(name, value, GH_COLOR, fstr);
+            return bptr->parseSet<S>(name, GHvar(value));
         }
         return 0;
     }
 
     // ========================== LED ==========================
     void LED(FSTR name, bool value = 0, FSTR label = nullptr, FSTR icon = nullptr) {
-        _led(true, name, value, label, icon);
+        _led<GHpgm>(name, value, label, icon);
     }
     void LED(CSREF name, bool value = 0, CSREF label = "", CSREF icon = "") {
-        _led(false, name.c_str(), value, label.c_str(), icon.c_str());
+        _led<GHram>(name.c_str(), value, label.c_str(), icon.c_str());
     }
 
-    void _led(bool fstr, VSPTR name, bool value, VSPTR label, VSPTR text) {
+    template <typename S>
+    void _led(VSPTR name, bool value, VSPTR label, VSPTR text) {
         if (_isUI()) {
             _begin(F("led"));
-            _name(name, fstr);
+            _name<S>(name);
             _value();
             *sptr += value;
-            _label(label, fstr);
-            _text(text, fstr);
+            _label<S>(label);
+            _text<S>(text);
             _tabw();
             _end();
         } else if (_isRead()) {
-            if (_checkName(name, fstr)) *sptr += value;
+            if (_checkName<S>(name)) *sptr += value;
         }
     }
 
@@ -502,8 +572,7 @@ class HubBuilder {
     void Space(int height = 0) {
         if (_isUI()) {
             _begin(F("spacer"));
-            _add(F(",'height':"));
-            *sptr += height;
+            _int(F("height"), F("h"), height, 0);
             _tabw();
             _end();
         }
@@ -511,32 +580,33 @@ class HubBuilder {
 
     // ========================== MENU ==========================
     bool Menu(FSTR text) {
-        return _tabs(true, F("menu"), F("_menu"), &menu, text, nullptr);
+        return _tabs<GHpgm>(F("menu"), F("_menu"), &menu, text, nullptr);
     }
     bool Menu(CSREF text) {
-        return _tabs(false, F("menu"), "_menu", &menu, text.c_str(), nullptr);
+        return _tabs<GHram>(F("menu"), "_menu", &menu, text.c_str(), nullptr);
     }
 
     // ========================== TABS ==========================
     bool Tabs(FSTR name, uint8_t* value, FSTR text, FSTR label = nullptr) {
-        return _tabs(true, F("tabs"), name, value, text, label);
+        return _tabs<GHpgm>(F("tabs"), name, value, text, label);
     }
     bool Tabs(CSREF name, uint8_t* value, CSREF text, CSREF label = "") {
-        return _tabs(false, F("tabs"), name.c_str(), value, text.c_str(), label.c_str());
+        return _tabs<GHram>(F("tabs"), name.c_str(), value, text.c_str(), label.c_str());
     }
 
-    bool _tabs(bool fstr, FSTR tag, VSPTR name, uint8_t* value, VSPTR text, VSPTR label) {
+    template <typename S>
+    bool _tabs(FSTR tag, VSPTR name, uint8_t* value, VSPTR text, VSPTR label) {
         if (_isUI()) {
             _begin(tag);
-            _name(name, fstr);
+            _name<S>(name);
             _value();
             *sptr += *value;
-            _text(text, fstr);
-            _label(label, fstr);
+            _text<S>(text);
+            _label<S>(label);
             _tabw();
             _end();
         } else if (bptr->type == GH_BUILD_ACTION) {
-            bool act = bptr->parseSet(name, value, GH_UINT8, fstr);
+            bool act = bptr->parseSet<S>(name, GHvar(value));
             if (act) refresh();
             return act;
         }
@@ -545,36 +615,35 @@ class HubBuilder {
 
     // ========================= CANVAS =========================
     bool Canvas(FSTR name, int width = 400, int height = 300, GHcanvas* cv = nullptr, GHpos* pos = nullptr, FSTR label = nullptr) {
-        return _canvas(true, name, width, height, cv, label, pos, false);
+        return _canvas<GHpgm>(name, width, height, cv, label, pos, false);
     }
     bool Canvas(CSREF name, int width = 400, int height = 300, GHcanvas* cv = nullptr, GHpos* pos = nullptr, CSREF label = "") {
-        return _canvas(false, name.c_str(), width, height, cv, label.c_str(), pos, false);
+        return _canvas<GHram>(name.c_str(), width, height, cv, label.c_str(), pos, false);
     }
     bool BeginCanvas(FSTR name, int width = 400, int height = 300, GHcanvas* cv = nullptr, GHpos* pos = nullptr, FSTR label = nullptr) {
-        return _canvas(true, name, width, height, cv, label, pos, true);
+        return _canvas<GHpgm>(name, width, height, cv, label, pos, true);
     }
     bool BeginCanvas(CSREF name, int width = 400, int height = 300, GHcanvas* cv = nullptr, GHpos* pos = nullptr, CSREF label = "") {
-        return _canvas(false, name.c_str(), width, height, cv, label.c_str(), pos, true);
+        return _canvas<GHram>(name.c_str(), width, height, cv, label.c_str(), pos, true);
     }
 
-    bool _canvas(bool fstr, VSPTR name, int width, int height, GHcanvas* cv, VSPTR label, GHpos* pos, bool begin) {
+    template <typename S>
+    bool _canvas(VSPTR name, int width, int height, GHcanvas* cv, VSPTR label, GHpos* pos, bool begin) {
         if (!_isUI() && cv) cv->extBuffer(nullptr);
 
         if (_isUI()) {
             _begin(F("canvas"));
-            _name(name, fstr);
-            _add(F(",'width':"));
-            *sptr += width;
-            _add(F(",'height':"));
-            *sptr += height;
-            _label(label, fstr);
-            if (pos) _add(F(",'active':1"));
+            _name<S>(name);
+            _int(F("width"), F("wd"), width, 400);
+            _int(F("height"), F("h"), height, 300);
+            _label<S>(label);
+            if (pos) _int(F("active"), F("ac"), 1, 0);
             _value();
             *sptr += '[';
             if (begin && cv) cv->extBuffer(sptr);
             else EndCanvas();
         } else if (bptr->type == GH_BUILD_ACTION) {
-            return bptr->parseSet(name, pos, GH_POS, fstr);
+            return bptr->parseSet<S>(name, pos, GH_POS);
         }
         return 0;
     }
@@ -589,18 +658,18 @@ class HubBuilder {
 
     // ========================= IMAGE =========================
     void Image(FSTR url, int prd = 0, FSTR label = nullptr) {
-        _image(true, url, prd, label);
+        _image<GHpgm>(url, prd, label);
     }
     void Image(CSREF url, int prd = 0, CSREF label = "") {
-        _image(false, url.c_str(), prd, label.c_str());
+        _image<GHram>(url.c_str(), prd, label.c_str());
     }
-    void _image(bool fstr, VSPTR url, int prd, VSPTR label) {
+    template <typename S>
+    void _image(VSPTR url, int prd, VSPTR label) {
         if (_isUI()) {
             _begin(F("image"));
-            _value(url, fstr);
-            _label(label, fstr);
-            _add(F(",'prd':"));
-            *sptr += prd;
+            _value<S>(url);
+            _label<S>(label);
+            _int(F("prd"), F("p"), prd, 0);
             _tabw();
             _end();
         }
@@ -610,6 +679,8 @@ class HubBuilder {
     void Stream() {
         if (_isUI()) {
             _begin(F("stream"));
+            _key(F("port"), F("pt"));
+            *sptr += GH_HTTPD_PORT;
             _tabw();
             _end();
         }
@@ -617,26 +688,25 @@ class HubBuilder {
 
     // =========================== JOY ===========================
     bool Joystick(FSTR name, GHpos* pos, bool autoc = 1, bool exp = 0, FSTR label = nullptr, uint32_t color = GH_DEFAULT) {
-        return _joy(true, name, pos, autoc, exp, label, color);
+        return _joy<GHpgm>(name, pos, autoc, exp, label, color);
     }
     bool Joystick(CSREF name, GHpos* pos, bool autoc = 1, bool exp = 0, CSREF label = "", uint32_t color = GH_DEFAULT) {
-        return _joy(false, name.c_str(), pos, autoc, exp, label.c_str(), color);
+        return _joy<GHram>(name.c_str(), pos, autoc, exp, label.c_str(), color);
     }
 
-    bool _joy(bool fstr, VSPTR name, GHpos* pos, bool autoc, bool exp, VSPTR label, uint32_t color) {
+    template <typename S>
+    bool _joy(VSPTR name, GHpos* pos, bool autoc, bool exp, VSPTR label, uint32_t color) {
         if (_isUI()) {
             _begin(F("joy"));
-            _name(name, fstr);
-            _add(F(",'auto':"));
-            *sptr += autoc;
-            _add(F(",'exp':"));
-            *sptr += exp;
-            _label(label, fstr);
+            _name<S>(name);
+            _int(F("auto"), F("au"), autoc, 1);
+            _int(F("exp"), F("e"), exp, 0);
+            _label<S>(label);
             _color(color);
             _tabw();
             _end();
         } else if (bptr->type == GH_BUILD_ACTION) {
-            bool act = bptr->parseSet(name, pos, GH_POS, fstr);
+            bool act = bptr->parseSet<S>(name, pos, GH_POS);
             if (act) {
                 pos->x -= 255;
                 pos->y -= 255;
@@ -648,44 +718,51 @@ class HubBuilder {
 
     // ======================= CONFIRM ========================
     bool Confirm(FSTR name, bool* value = nullptr, FSTR label = nullptr) {
-        return _confirm(true, name, value, label);
+        return _confirm<GHpgm>(name, value, label);
     }
     bool Confirm(CSREF name, bool* value = nullptr, CSREF label = "") {
-        return _confirm(false, name.c_str(), value, label.c_str());
+        return _confirm<GHram>(name.c_str(), value, label.c_str());
     }
 
-    bool _confirm(bool fstr, VSPTR name, bool* value, VSPTR label) {
+    template <typename S>
+    bool _confirm(VSPTR name, bool* value, VSPTR label) {
         if (_isUI()) {
             _begin(F("confirm"));
-            _name(name, fstr);
-            _label(label, fstr);
+            _name<S>(name);
+            _label<S>(label);
             _end();
         } else if (bptr->type == GH_BUILD_ACTION) {
-            return bptr->parseSet(name, value, GH_BOOL, fstr);
+            return bptr->parseSet<S>(name, GHvar(value));
         }
         return 0;
     }
 
     // ========================= PROMPT ========================
     bool Prompt(FSTR name, void* value = nullptr, GHdata_t type = GH_NULL, FSTR label = nullptr) {
-        return _prompt(true, name, value, type, label);
+        return _prompt<GHpgm>(name, GHvar(value, type), label);
     }
     bool Prompt(CSREF name, void* value = nullptr, GHdata_t type = GH_NULL, CSREF label = "") {
-        return _prompt(false, name.c_str(), value, type, label.c_str());
+        return _prompt<GHram>(name.c_str(), GHvar(value, type), label.c_str());
+    }
+    template <typename T>
+    bool Prompt(FSTR name, T* value, FSTR label = nullptr) {
+        return _prompt<GHpgm>(name, GHvar(value), label);
+    }
+    template <typename T>
+    bool Prompt(CSREF name, T* value, CSREF label = "") {
+        return _prompt<GHram>(name.c_str(), GHvar(value), label.c_str());
     }
 
-    bool _prompt(bool fstr, VSPTR name, void* value, GHdata_t type, VSPTR label) {
+    template <typename S>
+    bool _prompt(VSPTR name, const GHvar& var, VSPTR label) {
         if (_isUI()) {
             _begin(F("prompt"));
-            _name(name, fstr);
-            _value();
-            _quot();
-            GHtypeToStr(sptr, value, type);
-            _quot();
-            _label(label, fstr);
+            _name<S>(name);
+            _value(var);
+            _label<S>(label);
             _end();
         } else if (bptr->type == GH_BUILD_ACTION) {
-            return bptr->parseSet(name, value, type, fstr);
+            return bptr->parseSet<S>(name, var);
         }
         return 0;
     }
@@ -699,11 +776,22 @@ class HubBuilder {
     virtual void _afterComponent() = 0;
     virtual void refresh() = 0;
     int tab_width = 0;
+    bool ui_def = 0;    // клиент знает значения по умолчанию, их можно не выводить
+    bool ui_short = 0;  // клиент понимает короткие ключи
 
     // ========================= PRIVATE =========================
    private:
-    bool _checkName(VSPTR name, bool fstr = true) {
-        if (fstr ? (!strcmp_P(bptr->action.name, (PGM_P)name)) : (!strcmp(bptr->action.name, (PGM_P)name))) {
+    // вид строки S (GHpgm, GHram) задан при компиляции во всех помощниках ниже
+    template <typename S>
+    bool _checkName(VSPTR name) {
+        if (bptr->reads) {
+            int16_t i = bptr->reads->take<S>(name);
+            if (i < 0) return false;
+            sptr = &bptr->reads->values[i];
+            if (!bptr->reads->left) bptr->type = GH_BUILD_NONE;
+            return true;
+        }
+        if (bptr->nameEq<S>(name)) {
             bptr->type = GH_BUILD_NONE;
             return true;
         }
@@ -717,14 +805,18 @@ class HubBuilder {
     }
 
     // ================
-    void _add(VSPTR str, bool fstr = true) {
-        if (str) {
-            if (fstr) *sptr += (FSTR)str;
-            else *sptr += (PGM_P)str;
-        }
+    template <typename S>
+    void _add(VSPTR str) {
+        if (str) S::add(sptr, str);
+    }
+    template <typename S>
+    void _escape(VSPTR str) {
+        if (str) S::escape(sptr, str);
     }
     void _begin(FSTR type) {
-        _add(F("{'type':'"));
+        *sptr += F("{\"");
+        *sptr += ui_short ? F("t") : F("type");
+        *sptr += F("\":\"");
         *sptr += type;
         _quot();
     }
@@ -734,70 +826,106 @@ class HubBuilder {
         *sptr += ',';
     }
     void _quot() {
-        *sptr += '\'';
+        *sptr += '\"';
     }
     void _tabw() {
         if (tab_width) {
-            _add(F(",'tab_w':"));
+            _key(F("tab_w"), F("w"));
             *sptr += tab_width;
         }
     }
 
+    // ================
+    // ключ поля, короткий вариант - для ui_short
+    void _key(FSTR key, FSTR skey) {
+        *sptr += F(",\"");
+        *sptr += ui_short ? skey : key;
+        *sptr += F("\":");
+    }
+    // число, равное значению по умолчанию в приложении, не выводится
+    void _int(FSTR key, FSTR skey, long val, long def) {
+        if (ui_def && val == def) return;
+        _key(key, skey);
+        *sptr += val;
+    }
+    // строка, пустая не выводится
+    template <typename S>
+    void _str(FSTR key, FSTR skey, VSPTR str) {
+        if (ui_def && S::empty(str)) return;
+        _key(key, skey);
+        _quot();
+        _escape<S>(str);
+        _quot();
+    }
+
     // ================
     void _value() {
-        *sptr += F(",'value':");
+        _key(F("value"), F("v"));
     }
-    void _value(VSPTR value, bool fstr = true) {
+    template <typename S>
+    void _value(VSPTR value) {
+        _str<S>(F("value"), F("v"), value);
+    }
+    // строка из переменной: пустую убираем после вывода
+    void _value(const GHvar& var) {
+        unsigned int from = sptr->length();
         _value();
         _quot();
-        _add(value, fstr);
+        unsigned int len = sptr->length();
+        var.toStr(sptr);
+        if (ui_def && sptr->length() == len) sptr->remove(from);
+        else _quot();
+    }
+    template <typename S>
+    void _name(VSPTR name) {
+        _key(F("name"), F("n"));
         _quot();
-    }
-    void _name(VSPTR name, bool fstr = true) {
-        _add(F(",'name':'"));
-        _add(name, fstr);
+        _add<S>(name);
         _quot();
     }
-    void _label(VSPTR label, bool fstr = true) {
-        _add(F(",'label':'"));
-        _add(label, fstr);
-        _quot();
+    template <typename S>
+    void _label(VSPTR label) {
+        _str<S>(F("label"), F("l"), label);
     }
     void _text() {
-        _add(F(",'text':"));
+        _key(F("text"), F("x"));
     }
-    void _text(VSPTR text, bool fstr = true) {
-        _text();
-        _quot();
-        _add(text, fstr);
-        _quot();
+    template <typename S>
+    void _text(VSPTR text) {
+        _str<S>(F("text"), F("x"), text);
     }
 
     // ================
     void _color(uint32_t& col) {
         if (col == GH_DEFAULT) return;
-        _add(F(",'color':"));
+        _key(F("color"), F("c"));
         *sptr += col;
     }
-    void _size(int& val) {
-        _add(F(",'size':"));
-        *sptr += val;
+    void _size(int val, int def) {
+        _int(F("size"), F("s"), val, def);
     }
 
     // ================
     void _minv(float val) {
-        _add(F(",'min':"));
+        _key(F("min"), F("mn"));
         *sptr += val;
     }
 
     void _maxv(float val) {
-        _add(F(",'max':"));
+        _key(F("max"), F("mx"));
         *sptr += val;
     }
 
     void _step(float val) {
-        _add(F(",'step':"));
+        _key(F("step"), F("st"));
         if (val < 0.01) *sptr += String(val, 4);
         else *sptr += val;
     }
+
+    // по умолчанию 0..100, шаг 1
+    void _range(float minv, float maxv, float step) {
+        if (!ui_def || minv != 0) _minv(minv);
+        if (!ui_def || maxv != 100) _maxv(maxv);
+        if (!ui_def || step != 1) _step(step);
+    }
 };
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include <Arduino.h>
 
+#include "config.hpp"
 #include "macro.hpp"
 #include "utils/misc.h"
 
@@ -59,18 +60,26 @@ class GHcanvas {
     // подключить внешний буфер
     void extBuffer(String* sptr) {
         ps = sptr;
+        full = 0;
     }
 
-    // очистить буфер (внутренний)
+    // очистить буфер (внутренний). Память буфера остаётся для следующих команд
     void clearBuffer() {
         first = 1;
+        full = 0;
         buf = "";
     }
 
+    // внутренний буфер заполнен (GH_CANVAS_BUF), новые команды пропускаются до clearBuffer()
+    bool overflow() {
+        return full;
+    }
+
     // добавить строку кода на js
     void custom(const String& s) {
         if (!ps) return;
         _checkFirst();
+        if (full) return;
         _quot();
         GH_escapeStr(ps, s.c_str(), false);
         _quot();
@@ -78,6 +87,7 @@ class GHcanvas {
     void custom(FSTR s) {
         if (!ps) return;
         _checkFirst();
+        if (full) return;
         _quot();
         GH_escapeStr(ps, s, true);
         _quot();
@@ -618,9 +628,11 @@ class GHcanvas {
    private:
     template <typename T>
     void _add(T v) {
-        if (ps) *ps += v;
+        if (ps && !full) *ps += v;
     }
+    // начало команды: внутренний буфер не растёт дальше GH_CANVAS_BUF, команда пропускается целиком
     void _checkFirst() {
+        if (ps == &buf && buf.length() >= GH_CANVAS_BUF) full = 1;
         if (first) first = 0;
         else _add(',');
     }
@@ -633,7 +645,7 @@ class GHcanvas {
         _add(':');
     }
     void _quot() {
-        _add('\'');
+        _add('\"');
     }
     void _dquot() {
         _add("\\");
@@ -669,6 +681,7 @@ class GHcanvas {
 
     String* ps = nullptr;
     bool first = 1;
+    bool full = 0;
     bool strokeF = 1;
     bool fillF = 1;
     const char* fname = "Arial";
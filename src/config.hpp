@@ -5,13 +5,68 @@
 #define GH_HTTP_PORT 80         // http порт
 #define GH_WS_PORT 81           // websocket порт
 #define GH_HTTPD_PORT 82        // httpd порт (stream)
+#define GH_STREAM_CLIENTS 2     // макс. количество клиентов стрима
+#define GH_STREAM_CHUNK 1436    // размер порции кадра стрима за один тик (esp32)
+#define GH_STREAM_TIMEOUT 5000  // отключить клиента стрима, не принимающего кадр дольше, мс
 #define GH_DOWN_CHUNK_SIZE 512  // размер чанка при скачивании с платы
 #define GH_UPL_CHUNK_SIZE 200   // размер чанка при загрузке на плату
-#define GH_FS_DEPTH 5           // глубина сканирования файловой системы (esp32)
+#define GH_FS_DEPTH 5           // глубина сканирования файловой системы
+#define GH_FS_PAGE 50           // записей на странице fsbr каталога
+#define GH_FS_INDEX_SIZE 256    // макс. записей в кеше каталогов ФС
 #define GH_FS LittleFS          // файловая система
 #define GH_MQTT_RECONNECT 5000  // период переподключения MQTT
+#define GH_MQTT_KEEPALIVE 15    // период keepalive MQTT, с (linux)
 #define GH_CACHE_PRD "max-age=604800"   // период кеширования файлов для портала
+#define GH_WS_CLIENTS 8         // макс. количество WS клиентов (linux)
+#define GH_UDP_PORT 52025       // UDP порт поиска устройств
+#define GH_UDP_GROUP 239, 255, 72, 66   // multicast группа поиска устройств
+#define GH_UDP_REQ_SIZE 128     // макс. размер UDP запроса поиска
+#define GH_OTA_URL_TICK 4096    // макс. байт OTA по URL за один тик
+#define GH_OTA_URL_RETRY 3      // попыток докачки OTA по URL после обрыва
+#define GH_CAPS_CLIENTS 4       // макс. клиентов с возможностями из focus (mp, def, sk, lz)
+#define GH_LZ_ANSWER 512        // сжимать ответы длиннее, байт (клиент с возможностью lz)
+#define GH_INBOX_SIZE 8         // макс. входящих пакетов в очереди до tick (async, на каждое подключение)
+#define GH_INBOX_BUF 1024       // буфер данных входящих пакетов, байт (async, на каждое подключение)
+#define GH_READ_LIST 64         // макс. имён в одном списке sendUpdate/sendGet, остальные отбрасываются
+#define GH_ARENA_SIZE 1024      // арена временных буферов запроса, байт (выделяется в begin, только esp и linux)
+#define GH_CANVAS_BUF 4096      // макс. размер внутреннего буфера холста, байт
+#define GH_WORKER_QUEUE 8       // пакетов в очереди фоновой задачи отправки (GH_WORKER)
+#define GH_WORKER_STACK 4096    // стек фоновой задачи отправки, байт (GH_WORKER, esp32)
 
 #if (defined(ESP8266) || defined(ESP32))
 #define GH_ESP_BUILD
-#endif
\ No newline at end of file
+
+// linux: сервер HTTP/WS и клиент MQTT на сокетах. Файловая система, OTA, стрим и портал не поддерживаются
+#elif !defined(ARDUINO) && defined(__linux__)
+#define GH_POSIX_BUILD
+#ifndef GH_NO_FS
+#define GH_NO_FS
+#endif
+#ifndef GH_NO_OTA
+#define GH_NO_OTA
+#endif
+#ifndef GH_NO_STREAM
+#define GH_NO_STREAM
+#endif
+#ifndef GH_NO_PORTAL
+#define GH_NO_PORTAL
+#endif
+#endif
+
+// сборка с сетевыми модулями (WS, MQTT)
+#if defined(GH_ESP_BUILD) || defined(GH_POSIX_BUILD)
+#define GH_NET_BUILD
+#endif
+
+// на AVR и прочих платах без сети арена не выделяется: RAM мало, а списки чтения короткие и берутся из кучи
+#ifndef GH_NET_BUILD
+#undef GH_ARENA_SIZE
+#define GH_ARENA_SIZE 0
+#endif
+
+// фоновая задача отправки: второе ядро esp32 или поток linux
+#if defined(ESP32) || defined(GH_POSIX_BUILD)
+#define GH_WORKER_BUILD
+#elif defined(GH_WORKER)
+#undef GH_WORKER
+#endif
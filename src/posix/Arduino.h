@@ -0,0 +1,5 @@
+#pragma once
+// Arduino API для сборки под linux на основе ArduinoCore-API (https://github.com/arduino/ArduinoCore-API).
+// В пути поиска заголовков добавить папку ArduinoCore-API и эту папку (src/posix), к проекту добавить
+// api/*.cpp из ArduinoCore-API и src/posix/core.cpp
+#include <api/ArduinoAPI.h>
@@ -0,0 +1,65 @@
+// функции платформы, которые ArduinoCore-API ожидает от ядра (сборка под linux)
+#include "../config.hpp"
+
+#ifdef GH_POSIX_BUILD
+#include <Arduino.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t _GH_us() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static const uint64_t _GH_start = _GH_us();
+
+static char* _GH_utoa(unsigned long v, char* s, int radix, bool neg) {
+    char buf[33];
+    char* p = buf + sizeof(buf) - 1;
+    *p = 0;
+    if (radix < 2 || radix > 36) radix = 10;
+    do {
+        uint8_t d = v % radix;
+        *--p = d < 10 ? '0' + d : 'a' + d - 10;
+        v /= radix;
+    } while (v);
+    char* out = s;
+    if (neg) *out++ = '-';
+    strcpy(out, p);
+    return s;
+}
+
+extern "C" {
+unsigned long millis() {
+    return (_GH_us() - _GH_start) / 1000;
+}
+unsigned long micros() {
+    return _GH_us() - _GH_start;
+}
+void delay(unsigned long ms) {
+    usleep(ms * 1000);
+}
+void delayMicroseconds(unsigned int us) {
+    usleep(us);
+}
+void yield() {}
+
+char* ultoa(unsigned long v, char* s, int radix) {
+    return _GH_utoa(v, s, radix, false);
+}
+char* utoa(unsigned int v, char* s, int radix) {
+    return _GH_utoa(v, s, radix, false);
+}
+char* ltoa(long v, char* s, int radix) {
+    if (v < 0 && radix == 10) return _GH_utoa(0ul - (unsigned long)v, s, radix, true);
+    return _GH_utoa(v, s, radix, false);
+}
+char* itoa(int v, char* s, int radix) {
+    if (v < 0 && radix == 10) return _GH_utoa(0u - (unsigned)v, s, radix, true);
+    return _GH_utoa((unsigned)v, s, radix, false);
+}
+}
+
+#include <api/deprecated-avr-comp/avr/dtostrf.c.impl>
+#endif
@@ -0,0 +1,127 @@
+#pragma once
+#include "../config.hpp"
+#include "../macro.hpp"
+
+#ifdef GH_POSIX_BUILD
+#ifdef GH_NO_WS
+class HubHTTP {
+   public:
+};
+#else
+
+#include <Arduino.h>
+
+#include "net.h"
+
+// HTTP сервер на epoll: только ответ на поиск устройств /hub_discover_all (портал не поддерживается)
+class HubHTTP {
+   protected:
+    ~HubHTTP() {
+        endHTTP();
+    }
+
+    void beginHTTP() {
+        endHTTP();
+        ep = epoll_create1(EPOLL_CLOEXEC);
+        lfd = GH_sockListen(GH_HTTP_PORT);
+        if (ep < 0 || lfd < 0 || !GH_epollAdd(ep, lfd, nullptr)) endHTTP();
+    }
+
+    void endHTTP() {
+        for (uint8_t i = 0; i < HTTP_CLIENTS; i++) _drop(clients[i]);
+        if (lfd >= 0) close(lfd);
+        if (ep >= 0) close(ep);
+        lfd = ep = -1;
+    }
+
+    void tickHTTP() {
+        if (ep < 0) return;
+        epoll_event evs[HTTP_CLIENTS + 1];
+        int n = epoll_wait(ep, evs, HTTP_CLIENTS + 1, 0);
+        for (int i = 0; i < n; i++) {
+            Client* c = (Client*)evs[i].data.ptr;
+            if (!c) _accept();
+            else if (c->fd >= 0) _read(*c);
+        }
+        for (uint8_t i = 0; i < HTTP_CLIENTS; i++) {
+            if (clients[i].fd >= 0 && millis() - clients[i].tmr >= GH_CONN_TOUT * 1000ul) _drop(clients[i]);
+        }
+    }
+
+   private:
+    static const uint8_t HTTP_CLIENTS = 4;
+
+    struct Client {
+        int fd = -1;
+        uint32_t tmr = 0;
+        GHnetBuf in;
+    };
+
+    void _accept() {
+        int fd;
+        while ((fd = GH_sockAccept(lfd)) >= 0) {
+            Client* c = nullptr;
+            for (uint8_t i = 0; i < HTTP_CLIENTS; i++) {
+                if (clients[i].fd < 0) {
+                    c = &clients[i];
+                    break;
+                }
+            }
+            if (!c || !GH_epollAdd(ep, fd, c)) {
+                close(fd);
+                continue;
+            }
+            c->fd = fd;
+            c->tmr = millis();
+        }
+    }
+
+    void _drop(Client& c) {
+        if (c.fd < 0) return;
+        close(c.fd);
+        c.fd = -1;
+        c.in.clear();
+    }
+
+    void _read(Client& c) {
+        bool alive = c.in.recvFrom(c.fd, 4097);
+        char* req = (char*)c.in.buf;
+        char* end = req ? (char*)memmem(req, c.in.len, "\r\n\r\n", 4) : nullptr;
+        if (!end) {  // ждём заголовок целиком
+            if (!alive || c.in.len > 4096) _drop(c);
+            return;
+        }
+        *end = 0;
+
+        const char* resp;
+        if (!strncmp(req, "OPTIONS ", 8)) {
+            resp =
+                "HTTP/1.1 204 No Content\r\n"
+                "Access-Control-Allow-Origin: *\r\n"
+                "Access-Control-Allow-Methods: GET, OPTIONS\r\n"
+                "Access-Control-Allow-Headers: *\r\n"
+                "Connection: close\r\n\r\n";
+        } else if (!strncmp(req, "GET /hub_discover_all ", 22) || !strncmp(req, "GET /hub_discover_all?", 22)) {
+            resp =
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Type: text/plain\r\n"
+                "Content-Length: 2\r\n"
+                "Access-Control-Allow-Origin: *\r\n"
+                "Connection: close\r\n\r\nOK";
+        } else {
+            resp =
+                "HTTP/1.1 404 Not Found\r\n"
+                "Content-Length: 0\r\n"
+                "Access-Control-Allow-Origin: *\r\n"
+                "Connection: close\r\n\r\n";
+        }
+        send(c.fd, resp, strlen(resp), MSG_NOSIGNAL);
+        _drop(c);
+    }
+
+    Client clients[HTTP_CLIENTS];
+    int ep = -1;
+    int lfd = -1;
+};
+#endif
+#endif
@@ -0,0 +1,347 @@
+#pragma once
+#include "../config.hpp"
+#include "../macro.hpp"
+
+#ifdef GH_POSIX_BUILD
+#ifdef GH_NO_MQTT
+class HubMQTT {
+   public:
+    void setupMQTT(const char* host, uint16_t port, const char* login = nullptr, const char* pass = nullptr, uint8_t nqos = 0, bool nret = 0) {}
+};
+#else
+
+#include <Arduino.h>
+#include <poll.h>
+
+#include "../utils/stats.h"
+#include "../utils/wheel.h"
+#include "net.h"
+
+// MQTT 3.1.1 клиент на неблокирующем сокете. Публикация с QoS 0, подписка с заданным QoS
+class HubMQTT {
+    // ============ PUBLIC =============
+   public:
+    // настроить MQTT (хост брокера, порт, логин, пароль, QoS, retained)
+    void setupMQTT(const char* host, uint16_t port, const char* login = nullptr, const char* pass = nullptr, uint8_t nqos = 0, bool nret = 0) {
+        if (!strlen(host)) return;
+        mq_host = host;
+        mq_port = port;
+        qos = nqos;
+        ret = nret;
+        mq_login = login;
+        mq_pass = pass;
+        mq_configured = true;
+    }
+
+    // MQTT подключен
+    bool online() {
+        return mq_state == MQ_ONLINE;
+    }
+
+    // ============ PROTECTED =============
+   protected:
+    virtual void parse(char* url, char* value, GHconn_t conn, bool manual) = 0;
+    virtual const char* getPrefix() = 0;
+    virtual const char* getID() = 0;
+    virtual void sendEvent(GHevent_t state, GHconn_t conn) = 0;
+    virtual GHwheel& getWheel() = 0;
+
+    ~HubMQTT() {
+        if (fd >= 0) close(fd);
+    }
+
+    void beginMQTT() {}
+
+    void endMQTT() {
+        if (mq_state == MQ_ONLINE) {
+            uint8_t disc[2] = {0xE0, 0};
+            out.add(disc, 2);
+            out.sendTo(fd);
+        }
+        _close();
+    }
+
+    void tickMQTT() {
+        if (!mq_configured) return;
+        switch (mq_state) {
+            case MQ_IDLE:
+                if (!mq_reconn.active()) {
+                    getWheel().start(mq_reconn, GH_MQTT_RECONNECT);
+                    getWheel().start(mq_tout, GH_CONN_TOUT * 1000ul);
+                    sendEvent(GH_CONNECTING, GH_MQTT);
+                    if (!_connect()) sendEvent(GH_ERROR, GH_MQTT);
+                }
+                break;
+
+            case MQ_TCP: {
+                pollfd pfd = {fd, POLLOUT, 0};
+                if (poll(&pfd, 1, 0) > 0) {
+                    int err = 0;
+                    socklen_t elen = sizeof(err);
+                    getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &elen);
+                    if (err) return _fail();
+                    _sendConnect();
+                    mq_state = MQ_CONNACK;
+                } else if (!mq_tout.active()) {
+                    _fail();
+                }
+            } break;
+
+            case MQ_CONNACK:
+            case MQ_ONLINE:
+                if (!in.recvFrom(fd)) return _fail();
+                while (_packet()) {
+                    if (mq_state == MQ_IDLE) return;
+                }
+                if (mq_state == MQ_CONNACK && !mq_tout.active()) return _fail();
+                if (mq_state == MQ_ONLINE) {
+                    if (millis() - rx_tmr > GH_MQTT_KEEPALIVE * 1500ul) return _fail();
+                    if (millis() - tx_tmr > GH_MQTT_KEEPALIVE * 1000ul) {
+                        uint8_t ping[2] = {0xC0, 0};
+                        _write(ping, 2);
+                    }
+                }
+                if (!out.sendTo(fd)) _fail();
+                break;
+        }
+    }
+
+    void sendMQTT(const String& topic, const String& msg) {
+        if (mq_state != MQ_ONLINE) return;
+        _publish(topic.c_str(), msg.c_str(), msg.length(), ret);
+        if (!out.sendTo(fd)) _fail();
+    }
+
+    void sendMQTT(const String& msg) {
+        String topic(getPrefix());
+        topic += F("/hub");
+        sendMQTT(topic, msg);
+    }
+
+    void answerMQTT(const String& msg, const char* hubID) {
+        String topic(getPrefix());
+        topic += F("/hub/");
+        topic += hubID;
+        topic += '/';
+        topic += getID();
+        sendMQTT(topic, msg);
+    }
+
+    // ============ PRIVATE =============
+   private:
+    enum MQstate_t {
+        MQ_IDLE,
+        MQ_TCP,
+        MQ_CONNACK,
+        MQ_ONLINE,
+    };
+
+    // начать подключение. Имя хоста разрешается блокирующе
+    bool _connect() {
+        _close();
+        addrinfo hints = {};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* res = nullptr;
+        char port[6];
+        ultoa(mq_port, port, 10);
+        if (getaddrinfo(mq_host, port, &hints, &res) || !res) return 0;
+        fd = socket(res->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        bool ok = fd >= 0 && (!connect(fd, res->ai_addr, res->ai_addrlen) || errno == EINPROGRESS);
+        freeaddrinfo(res);
+        if (!ok) {
+            _close();
+            return 0;
+        }
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        mq_state = MQ_TCP;
+        return 1;
+    }
+
+    void _close() {
+        if (fd >= 0) close(fd);
+        fd = -1;
+        mq_state = MQ_IDLE;
+        in.clear();
+        out.clear();
+    }
+
+    void _fail() {
+        bool was = (mq_state == MQ_ONLINE);
+        _close();
+        sendEvent(was ? GH_DISCONNECTED : GH_ERROR, GH_MQTT);
+    }
+
+    String _status() {
+        String s(getPrefix());
+        s += F("/hub/");
+        s += getID();
+        s += F("/status");
+        return s;
+    }
+
+    void _sendConnect() {
+        String m_id("DEV-");
+        m_id += String(random(0xffffff), HEX);
+        String status = _status();
+        const char* offline = "offline";
+
+        size_t len = 10 + 2 + m_id.length() + 2 + status.length() + 2 + strlen(offline);
+        uint8_t flags = 0x02 | 0x04 | (qos << 3) | (ret << 5);  // clean session, will
+        if (mq_login) {
+            flags |= 0x80;
+            len += 2 + strlen(mq_login);
+            if (mq_pass) {
+                flags |= 0x40;
+                len += 2 + strlen(mq_pass);
+            }
+        }
+        _header(0x10, len);
+        uint8_t vh[10] = {0, 4, 'M', 'Q', 'T', 'T', 4, flags, 0, GH_MQTT_KEEPALIVE};
+        out.add(vh, 10);
+        _str(m_id.c_str(), m_id.length());
+        _str(status.c_str(), status.length());
+        _str(offline, strlen(offline));
+        if (mq_login) {
+            _str(mq_login, strlen(mq_login));
+            if (mq_pass) _str(mq_pass, strlen(mq_pass));
+        }
+        out.sendTo(fd);
+        tx_tmr = rx_tmr = millis();
+    }
+
+    void _online() {
+        mq_state = MQ_ONLINE;
+        mq_tout.stop();
+        _publish(_status().c_str(), "online", 6, ret);
+
+        String sub(getPrefix());
+        String sub_id(sub);
+        sub_id += '/';
+        sub_id += getID();
+        sub_id += "/#";
+        _header(0x82, 2 + 2 + sub.length() + 1 + 2 + sub_id.length() + 1);
+        uint8_t pid[2] = {0, 1};
+        out.add(pid, 2);
+        _str(sub.c_str(), sub.length());
+        out.add(&qos, 1);
+        _str(sub_id.c_str(), sub_id.length());
+        out.add(&qos, 1);
+        tx_tmr = millis();
+        sendEvent(GH_CONNECTED, GH_MQTT);
+    }
+
+    // разобрать один пакет из буфера. Вернёт false, если пакет получен не целиком
+    bool _packet() {
+        if (in.len < 2) return 0;
+        uint32_t len = 0;
+        uint8_t hlen = 1;
+        for (uint8_t shift = 0;; shift += 7) {
+            if (hlen >= in.len) return 0;
+            uint8_t b = in.buf[hlen++];
+            len |= (uint32_t)(b & 0x7f) << shift;
+            if (!(b & 0x80)) break;
+            if (hlen > 4) {
+                _fail();
+                return 0;
+            }
+        }
+        if (in.len < hlen + len) return 0;
+        rx_tmr = millis();
+
+        uint8_t type = in.buf[0] >> 4;
+        uint8_t* p = in.buf + hlen;
+        switch (type) {
+            case 2:  // CONNACK
+                if (len < 2 || p[1]) {
+                    _fail();
+                    return 0;
+                }
+                _online();
+                break;
+
+            case 3: {  // PUBLISH
+                uint8_t pqos = (in.buf[0] >> 1) & 3;
+                uint16_t tlen = ((uint16_t)p[0] << 8) | p[1];
+                uint32_t off = 2 + tlen + (pqos ? 2 : 0);
+                if (off > len) break;
+                if (pqos) {
+                    uint8_t ack[4] = {(uint8_t)(pqos == 1 ? 0x40 : 0x50), 2, p[2 + tlen], p[3 + tlen]};
+                    _write(ack, 4);
+                }
+                char* buf = (char*)malloc(tlen + 1 + len - off + 1);
+                if (!buf) break;
+                memcpy(buf, p + 2, tlen);
+                buf[tlen] = 0;
+                char* value = buf + tlen + 1;
+                memcpy(value, p + off, len - off);
+                value[len - off] = 0;
+                in.shift(hlen + len);  // обработчик может отправлять данные
+                parse(buf, value, GH_MQTT, false);
+                free(buf);
+                return 1;
+            }
+
+            case 6:  // PUBREL
+                if (len >= 2) {
+                    uint8_t comp[4] = {0x70, 2, p[0], p[1]};
+                    _write(comp, 4);
+                }
+                break;
+
+            default:  // SUBACK, PUBACK, PINGRESP...
+                break;
+        }
+        in.shift(hlen + len);
+        return 1;
+    }
+
+    void _publish(const char* topic, const char* msg, size_t len, bool retain) {
+        size_t tlen = strlen(topic);
+        _header(0x30 | retain, 2 + tlen + len);
+        _str(topic, tlen);
+        out.add(msg, len);
+        tx_tmr = millis();
+    }
+
+    void _header(uint8_t type, size_t len) {
+        uint8_t h[5] = {type};
+        uint8_t n = 1;
+        do {
+            h[n] = len & 0x7f;
+            len >>= 7;
+            if (len) h[n] |= 0x80;
+            n++;
+        } while (len && n < 5);
+        out.add(h, n);
+    }
+
+    void _str(const char* s, size_t len) {
+        uint8_t l[2] = {(uint8_t)(len >> 8), (uint8_t)len};
+        out.add(l, 2);
+        out.add(s, len);
+    }
+
+    void _write(const uint8_t* data, size_t len) {
+        out.add(data, len);
+        tx_tmr = millis();
+    }
+
+    GHnetBuf in, out;
+    int fd = -1;
+    MQstate_t mq_state = MQ_IDLE;
+    bool mq_configured = false;
+    GHwheelTimer mq_reconn;
+    GHwheelTimer mq_tout;
+    uint32_t tx_tmr = 0;
+    uint32_t rx_tmr = 0;
+    uint8_t qos = 0;
+    bool ret = 0;
+    const char* mq_host = nullptr;
+    uint16_t mq_port = 1883;
+    const char* mq_login = nullptr;
+    const char* mq_pass = nullptr;
+};
+#endif
+#endif
@@ -0,0 +1,141 @@
+#pragma once
+#include "../config.hpp"
+
+#ifdef GH_POSIX_BUILD
+#include <Arduino.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// перевести сокет в неблокирующий режим
+static inline bool GH_sockNB(int fd) {
+    int fl = fcntl(fd, F_GETFL, 0);
+    return fl >= 0 && fcntl(fd, F_SETFL, fl | O_NONBLOCK) == 0;
+}
+
+// открыть неблокирующий слушающий сокет на порту. Вернёт -1 при ошибке
+static inline int GH_sockListen(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (sockaddr*)&addr, sizeof(addr)) || listen(fd, 16) || !GH_sockNB(fd)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// принять клиента (неблокирующий, без задержки Нейгла). Вернёт -1, если клиентов нет
+static inline int GH_sockAccept(int lfd) {
+    int fd = accept4(lfd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return -1;
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    return fd;
+}
+
+// добавить сокет в epoll. ptr - данные события
+static inline bool GH_epollAdd(int ep, int fd, void* ptr, uint32_t events = EPOLLIN) {
+    epoll_event ev = {};
+    ev.events = events;
+    ev.data.ptr = ptr;
+    return !epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+}
+
+// изменить события сокета в epoll
+static inline void GH_epollMod(int ep, int fd, void* ptr, uint32_t events) {
+    epoll_event ev = {};
+    ev.events = events;
+    ev.data.ptr = ptr;
+    epoll_ctl(ep, EPOLL_CTL_MOD, fd, &ev);
+}
+
+// ====================== BUFFER =======================
+// байтовый буфер сокета: накопление входящих данных и очередь на отправку
+class GHnetBuf {
+   public:
+    ~GHnetBuf() {
+        free(buf);
+    }
+
+    // добавить данные
+    bool add(const void* data, size_t n) {
+        if (!n) return 1;
+        if (len + n > cap) {
+            size_t ncap = cap ? cap : 256;
+            while (ncap < len + n) ncap *= 2;
+            uint8_t* nbuf = (uint8_t*)realloc(buf, ncap);
+            if (!nbuf) return 0;
+            buf = nbuf;
+            cap = ncap;
+        }
+        memcpy(buf + len, data, n);
+        len += n;
+        return 1;
+    }
+
+    // убрать n байт из начала
+    void shift(size_t n) {
+        if (n >= len) {
+            len = 0;
+            return;
+        }
+        memmove(buf, buf + n, len - n);
+        len -= n;
+    }
+
+    // прочитать из сокета всё доступное, но не копить больше max байт (0 - без ограничения): остаток ждёт в сокете
+    // до следующего тика. Вернёт false, если соединение закрыто или ошибка
+    bool recvFrom(int fd, size_t max = 0) {
+        uint8_t tmp[1024];
+        while (!max || len < max) {
+            size_t room = max ? min(sizeof(tmp), max - len) : sizeof(tmp);
+            ssize_t n = recv(fd, tmp, room, 0);
+            if (n > 0) {
+                if (!add(tmp, n)) return 0;
+                continue;
+            }
+            if (n == 0) return 0;
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        return 1;
+    }
+
+    // отправить в сокет сколько получится. Вернёт false при ошибке
+    bool sendTo(int fd) {
+        while (len) {
+            ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+            if (n > 0) {
+                shift(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+        return 1;
+    }
+
+    // очистить и освободить память
+    void clear() {
+        free(buf);
+        buf = nullptr;
+        len = cap = 0;
+    }
+
+    uint8_t* buf = nullptr;
+    size_t len = 0;
+    size_t cap = 0;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// SHA-1 для рукопожатия WebSocket (RFC 3174)
+class GHsha1 {
+   public:
+    GHsha1() {
+        h[0] = 0x67452301;
+        h[1] = 0xEFCDAB89;
+        h[2] = 0x98BADCFE;
+        h[3] = 0x10325476;
+        h[4] = 0xC3D2E1F0;
+    }
+
+    void update(const void* data, size_t n) {
+        const uint8_t* p = (const uint8_t*)data;
+        total += n;
+        while (n--) {
+            block[blen++] = *p++;
+            if (blen == 64) _process();
+        }
+    }
+
+    // получить хеш (20 байт)
+    void final(uint8_t* out) {
+        uint64_t bits = total * 8;
+        uint8_t pad = 0x80;
+        update(&pad, 1);
+        pad = 0;
+        while (blen != 56) update(&pad, 1);
+        for (int i = 7; i >= 0; i--) block[blen++] = bits >> (i * 8);
+        _process();
+        for (uint8_t i = 0; i < 20; i++) out[i] = h[i / 4] >> (24 - (i % 4) * 8);
+    }
+
+   private:
+    static uint32_t _rol(uint32_t v, uint8_t n) {
+        return (v << n) | (v >> (32 - n));
+    }
+
+    void _process() {
+        uint32_t w[80];
+        for (uint8_t i = 0; i < 16; i++) {
+            w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) | ((uint32_t)block[i * 4 + 2] << 8) | block[i * 4 + 3];
+        }
+        for (uint8_t i = 16; i < 80; i++) w[i] = _rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (uint8_t i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t t = _rol(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = _rol(b, 30);
+            b = a;
+            a = t;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+        blen = 0;
+    }
+
+    uint32_t h[5];
+    uint8_t block[64];
+    uint8_t blen = 0;
+    uint64_t total = 0;
+};
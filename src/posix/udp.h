@@ -0,0 +1,70 @@
+#pragma once
+#include "../config.hpp"
+#include "../macro.hpp"
+
+#ifdef GH_POSIX_BUILD
+#ifdef GH_NO_UDP
+class HubUDP {
+   public:
+};
+#else
+
+#include <Arduino.h>
+
+#include "../utils/stats.h"
+#include "net.h"
+
+// ответ на поиск устройств широковещательной/multicast UDP датаграммой на порт GH_UDP_PORT
+class HubUDP {
+   protected:
+    // вернёт пакет discover для ответа или nullptr
+    virtual String* discoverUDP(char* req) = 0;
+
+    ~HubUDP() {
+        endUDP();
+    }
+
+    void beginUDP() {
+        endUDP();
+        fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) return;
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(GH_UDP_PORT);
+        if (bind(fd, (sockaddr*)&addr, sizeof(addr))) return endUDP();
+
+        uint8_t group[4] = {GH_UDP_GROUP};
+        ip_mreq mreq = {};
+        memcpy(&mreq.imr_multiaddr.s_addr, group, 4);
+        mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+        setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq));  // без сети multicast не нужен
+    }
+
+    void endUDP() {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+
+    void tickUDP() {
+        if (fd < 0) return;
+        char req[GH_UDP_REQ_SIZE + 1];
+        sockaddr_in from;
+        socklen_t flen = sizeof(from);
+        ssize_t len;
+        while ((len = recvfrom(fd, req, GH_UDP_REQ_SIZE, 0, (sockaddr*)&from, &flen)) > 0) {
+            req[len] = 0;
+            String* answ = discoverUDP(req);
+            if (answ) sendto(fd, answ->c_str(), answ->length(), 0, (sockaddr*)&from, flen);
+            flen = sizeof(from);
+        }
+    }
+
+   private:
+    int fd = -1;
+};
+#endif
+#endif
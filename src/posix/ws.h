@@ -0,0 +1,325 @@
+#pragma once
+#include "../config.hpp"
+#include "../macro.hpp"
+
+#ifdef GH_POSIX_BUILD
+#ifdef GH_NO_WS
+class HubWS {
+   public:
+};
+#else
+
+#include <Arduino.h>
+
+#include "../utils/b64.h"
+#include "../utils/stats.h"
+#include "net.h"
+#include "sha1.h"
+
+// WebSocket сервер (RFC 6455) на epoll, подпротокол "hub". Только текстовые сообщения
+class HubWS {
+    // ============ PROTECTED =============
+   protected:
+    virtual void parse(char* url, GHconn_t conn, bool manual) = 0;
+    virtual void sendEvent(GHevent_t state, GHconn_t conn) = 0;
+
+    ~HubWS() {
+        for (uint8_t i = 0; i < GH_WS_CLIENTS; i++) {
+            if (clients[i].fd >= 0) close(clients[i].fd);
+        }
+        if (lfd >= 0) close(lfd);
+        if (ep >= 0) close(ep);
+    }
+
+    void beginWS() {
+        endWS();
+        ep = epoll_create1(EPOLL_CLOEXEC);
+        lfd = GH_sockListen(GH_WS_PORT);
+        if (ep < 0 || lfd < 0 || !GH_epollAdd(ep, lfd, nullptr)) {
+            endWS();
+            sendEvent(GH_ERROR, GH_WS);
+        }
+    }
+
+    void endWS() {
+        for (uint8_t i = 0; i < GH_WS_CLIENTS; i++) _drop(clients[i]);
+        if (lfd >= 0) close(lfd);
+        if (ep >= 0) close(ep);
+        lfd = ep = -1;
+    }
+
+    void tickWS() {
+        if (ep < 0) return;
+        epoll_event evs[GH_WS_CLIENTS + 1];
+        int n = epoll_wait(ep, evs, GH_WS_CLIENTS + 1, 0);
+        for (int i = 0; i < n; i++) {
+            Client* c = (Client*)evs[i].data.ptr;
+            if (!c) {
+                _accept();
+                continue;
+            }
+            if (c->state == WS_FREE || c->dead) continue;
+            if (evs[i].events & EPOLLOUT) _flush(*c);
+            if (evs[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                bool alive = c->in.recvFrom(c->fd, WS_MAX_IN);
+                if (c->state == WS_HANDSHAKE) _handshake(*c);
+                if (c->state == WS_OPEN) _frames(*c);
+                if (!alive || c->in.len >= WS_MAX_IN) c->dead = true;  // кадр не помещается в буфер
+            }
+        }
+        for (uint8_t i = 0; i < GH_WS_CLIENTS; i++) {
+            Client& c = clients[i];
+            if (c.state == WS_HANDSHAKE && millis() - c.tmr >= GH_CONN_TOUT * 1000ul) c.dead = true;
+            if (c.dead) _drop(c);
+        }
+    }
+
+    void sendWS(const String& answ, bool bin = false) {
+        for (uint8_t i = 0; i < GH_WS_CLIENTS; i++) {
+            if (clients[i].state == WS_OPEN) _send(clients[i], bin ? 0x2 : 0x1, answ.c_str(), answ.length());
+        }
+    }
+
+    // клиент последнего входящего пакета
+    uint32_t clientWS() {
+        return clientID;
+    }
+
+    void answerWS(const String& answ, bool bin, uint32_t client) {
+        if (client < GH_WS_CLIENTS && clients[client].state == WS_OPEN) _send(clients[client], bin ? 0x2 : 0x1, answ.c_str(), answ.length());
+    }
+
+    // ============ PRIVATE =============
+   private:
+    enum WSstate_t {
+        WS_FREE,
+        WS_HANDSHAKE,
+        WS_OPEN,
+    };
+
+    struct Client {
+        int fd = -1;
+        WSstate_t state = WS_FREE;
+        bool dead = 0;
+        bool bin = 0;
+        bool pollout = 0;
+        uint32_t tmr = 0;
+        GHnetBuf in, out, msg;
+    };
+
+    // макс. размер сообщения, входящего буфера (кадр с макс. заголовком) и очереди на отправку
+    static const size_t WS_MAX_MSG = 16384;
+    static const size_t WS_MAX_IN = WS_MAX_MSG + 14;
+    static const size_t WS_MAX_OUT = 262144;
+
+    void _accept() {
+        int fd;
+        while ((fd = GH_sockAccept(lfd)) >= 0) {
+            Client* c = nullptr;
+            for (uint8_t i = 0; i < GH_WS_CLIENTS; i++) {
+                if (clients[i].state == WS_FREE) {
+                    c = &clients[i];
+                    break;
+                }
+            }
+            if (!c || !GH_epollAdd(ep, fd, c)) {
+                close(fd);
+                continue;
+            }
+            c->fd = fd;
+            c->state = WS_HANDSHAKE;
+            c->tmr = millis();
+        }
+    }
+
+    void _drop(Client& c) {
+        if (c.state == WS_FREE) return;
+        close(c.fd);
+        bool open = (c.state == WS_OPEN);
+        c.fd = -1;
+        c.state = WS_FREE;
+        c.dead = c.bin = c.pollout = 0;
+        c.in.clear();
+        c.out.clear();
+        c.msg.clear();
+        if (open) sendEvent(GH_DISCONNECTED, GH_WS);
+    }
+
+    void _handshake(Client& c) {
+        char* hdr = (char*)c.in.buf;
+        char* end = nullptr;
+        for (size_t i = 3; i < c.in.len; i++) {
+            if (hdr[i] == '\n' && hdr[i - 1] == '\r' && hdr[i - 2] == '\n' && hdr[i - 3] == '\r') {
+                end = hdr + i - 3;
+                break;
+            }
+        }
+        if (!end) {
+            if (c.in.len > 4096) c.dead = true;
+            return;
+        }
+        size_t hlen = end - hdr + 4;
+        *end = 0;
+
+        const char* key = strcasestr(hdr, "\nSec-WebSocket-Key:");
+        if (!key) {
+            const char* resp = "HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n";
+            c.out.add(resp, strlen(resp));
+            _flush(c);
+            c.dead = true;
+            return;
+        }
+        key += 19;
+        while (*key == ' ') key++;
+        size_t klen = 0;
+        while (key[klen] && key[klen] != '\r') klen++;
+
+        GHsha1 sha;
+        sha.update(key, klen);
+        sha.update("258EAFA5-E914-47DA-95CA-C5AB0DC85B11", 36);
+        uint8_t hash[20];
+        sha.final(hash);
+        char acc[29];
+        _b64(hash, 20, acc);
+
+        String resp(F("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: "));
+        resp += acc;
+        resp += F("\r\n");
+        const char* proto = strcasestr(hdr, "\nSec-WebSocket-Protocol:");
+        if (proto && strstr(proto, "hub")) resp += F("Sec-WebSocket-Protocol: hub\r\n");
+        resp += F("\r\n");
+
+        c.in.shift(hlen);
+        c.out.add(resp.c_str(), resp.length());
+        _flush(c);
+        c.state = WS_OPEN;
+        sendEvent(GH_CONNECTED, GH_WS);
+    }
+
+    void _frames(Client& c) {
+        while (!c.dead && c.in.len >= 2) {
+            uint8_t* b = c.in.buf;
+            bool fin = b[0] & 0x80;
+            uint8_t op = b[0] & 0x0f;
+            if (!(b[1] & 0x80)) {  // кадры клиента должны быть маскированы
+                c.dead = true;
+                return;
+            }
+            uint64_t plen = b[1] & 0x7f;
+            size_t hlen = 2;
+            if (plen == 126) {
+                if (c.in.len < 4) return;
+                plen = ((uint16_t)b[2] << 8) | b[3];
+                hlen = 4;
+            } else if (plen == 127) {
+                if (c.in.len < 10) return;
+                plen = 0;
+                for (uint8_t i = 0; i < 8; i++) plen = (plen << 8) | b[2 + i];
+                hlen = 10;
+            }
+            if (plen > WS_MAX_MSG) {
+                uint8_t code[2] = {0x03, 0xf1};  // 1009 message too big
+                _send(c, 0x8, code, 2);
+                c.dead = true;
+                return;
+            }
+            if (c.in.len < hlen + 4 + plen) return;
+
+            uint8_t* mask = b + hlen;
+            uint8_t* data = mask + 4;
+            for (size_t i = 0; i < plen; i++) data[i] ^= mask[i & 3];
+
+            switch (op) {
+                case 0x0:  // continuation
+                case 0x1:  // text
+                case 0x2:  // binary
+                    if (op) {
+                        c.msg.len = 0;
+                        c.bin = (op == 0x2);
+                    }
+                    if (c.bin) break;
+                    if (c.msg.len + plen > WS_MAX_MSG || !c.msg.add(data, plen)) {
+                        c.dead = true;
+                        return;
+                    }
+                    if (fin) {
+                        c.msg.add("", 1);
+                        clientID = &c - clients;
+                        parse((char*)c.msg.buf, GH_WS, false);
+                        if (c.state != WS_OPEN) return;  // остановлен в обработчике
+                        c.msg.len = 0;
+                    }
+                    break;
+
+                case 0x8:  // close
+                    _send(c, 0x8, data, min(plen, (uint64_t)2));
+                    c.dead = true;
+                    break;
+
+                case 0x9:  // ping
+                    _send(c, 0xA, data, plen);
+                    break;
+
+                default:  // pong
+                    break;
+            }
+            c.in.shift(hlen + 4 + plen);
+        }
+    }
+
+    void _send(Client& c, uint8_t op, const void* data, size_t len) {
+        if (c.dead) return;
+        uint8_t hdr[10];
+        uint8_t hlen = 2;
+        hdr[0] = 0x80 | op;
+        if (len < 126) {
+            hdr[1] = len;
+        } else if (len <= 0xffff) {
+            hdr[1] = 126;
+            hdr[2] = len >> 8;
+            hdr[3] = len;
+            hlen = 4;
+        } else {
+            hdr[1] = 127;
+            for (uint8_t i = 0; i < 8; i++) hdr[2 + i] = (uint64_t)len >> ((7 - i) * 8);
+            hlen = 10;
+        }
+        if (c.out.len + hlen + len > WS_MAX_OUT || !c.out.add(hdr, hlen) || !c.out.add(data, len)) {
+            c.dead = true;  // клиент не успевает читать
+            return;
+        }
+        _flush(c);
+    }
+
+    void _flush(Client& c) {
+        if (!c.out.sendTo(c.fd)) {
+            c.dead = true;
+            return;
+        }
+        bool need = c.out.len;
+        if (need != c.pollout) {
+            c.pollout = need;
+            GH_epollMod(ep, c.fd, &c, need ? (EPOLLIN | EPOLLOUT) : EPOLLIN);
+        }
+    }
+
+    static void _b64(const uint8_t* data, uint8_t len, char* out) {
+        for (uint8_t i = 0; i < len; i += 3) {
+            uint32_t v = (uint32_t)data[i] << 16;
+            if (i + 1 < len) v |= (uint32_t)data[i + 1] << 8;
+            if (i + 2 < len) v |= data[i + 2];
+            *out++ = GH_b64v(v >> 18);
+            *out++ = GH_b64v((v >> 12) & 0x3f);
+            *out++ = (i + 1 < len) ? GH_b64v((v >> 6) & 0x3f) : '=';
+            *out++ = (i + 2 < len) ? GH_b64v(v & 0x3f) : '=';
+        }
+        *out = 0;
+    }
+
+    Client clients[GH_WS_CLIENTS];
+    int ep = -1;
+    int lfd = -1;
+    uint8_t clientID = 0;
+};
+#endif
+#endif
@@ -14,6 +14,7 @@ class HubMQTT {
 #include <PubSubClient.h>
 
 #include "../utils/stats.h"
+#include "../utils/wheel.h"
 
 class HubMQTT {
     // ============ PUBLIC =============
@@ -41,6 +42,7 @@ class HubMQTT {
     virtual const char* getPrefix() = 0;
     virtual const char* getID() = 0;
     virtual void sendEvent(GHevent_t state, GHconn_t conn) = 0;
+    virtual GHwheel& getWheel() = 0;
 
     void beginMQTT() {
         mqtt.setCallback([this](char* topic, uint8_t* data, uint16_t len) {
@@ -57,8 +59,8 @@ class HubMQTT {
 
     void tickMQTT() {
         if (mq_configured) {
-            if (!mqtt.connected() && (!mqtt_tmr || millis() - mqtt_tmr > GH_MQTT_RECONNECT)) {
-                mqtt_tmr = millis();
+            if (!mqtt.connected() && !mq_reconn.active()) {
+                getWheel().start(mq_reconn, GH_MQTT_RECONNECT);
                 sendEvent(GH_CONNECTING, GH_MQTT);
                 connectMQTT();
             }
@@ -133,7 +135,7 @@ class HubMQTT {
     PubSubClient mqtt;
     WiFiClient mclient;
     bool mq_configured = false;
-    uint32_t mqtt_tmr = 0;
+    GHwheelTimer mq_reconn;
     uint8_t qos = 0;
     bool ret = 0;
     const char* mq_login;
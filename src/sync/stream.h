@@ -0,0 +1,156 @@
+#pragma once
+#include "../config.hpp"
+#include "../macro.hpp"
+
+#ifdef GH_ESP_BUILD
+#ifdef GH_NO_STREAM
+class HubStream {
+   public:
+    bool setupStream(size_t size, const char* mime = nullptr) { return 0; }
+    void onStream(size_t (*handler)(uint8_t* buf, size_t size)) {}
+    bool streamFrame(const uint8_t* data, size_t len) { return 0; }
+    uint8_t streamClients() { return 0; }
+};
+#else
+
+#include <Arduino.h>
+
+#ifdef ESP8266
+#include <ESP8266WiFi.h>
+#else
+#include <WiFi.h>
+#include <errno.h>
+#include <lwip/sockets.h>
+#endif
+
+#include "../utils/frames.h"
+
+class HubStream {
+    // ============ PUBLIC =============
+   public:
+    HubStream() : stream_server(GH_HTTPD_PORT) {}
+
+    // включить стрим, указать макс. размер кадра в байтах и тип данных (умолч. image/jpeg). Вызывать до begin()
+    bool setupStream(size_t size, const char* mime = nullptr) {
+        stream_mime = mime;
+        return frames.begin(size);
+    }
+
+    // подключить функцию-источник кадров вида size_t f(uint8_t* buf, size_t size). Вернуть длину записанного в buf кадра или 0
+    void onStream(size_t (*handler)(uint8_t* buf, size_t size)) {
+        stream_cb = *handler;
+    }
+
+    // отправить кадр в стрим. false - кадр пропущен
+    bool streamFrame(const uint8_t* data, size_t len) {
+        return frames.push(data, len);
+    }
+
+    // количество подключенных к стриму клиентов
+    uint8_t streamClients() {
+        uint8_t n = 0;
+        for (uint8_t i = 0; i < GH_STREAM_CLIENTS; i++) {
+            if (clients[i].cl) n++;
+        }
+        return n;
+    }
+
+    // ============ PROTECTED =============
+   protected:
+    void beginStream() {
+        if (frames.state()) stream_server.begin();
+    }
+
+    void endStream() {
+        if (!frames.state()) return;
+        for (uint8_t i = 0; i < GH_STREAM_CLIENTS; i++) _drop(clients[i]);
+        stream_server.stop();
+    }
+
+    void tickStream() {
+        if (!frames.state()) return;
+
+        WiFiClient cl = stream_server.available();
+        if (cl) _accept(cl);
+
+        if (stream_cb && streamClients()) {
+            uint8_t* buf = frames.claim();
+            if (buf) {
+                size_t len = stream_cb(buf, frames.capacity());
+                if (len) frames.commit(len);
+                else frames.cancel();
+            }
+        }
+
+        for (uint8_t i = 0; i < GH_STREAM_CLIENTS; i++) _send(clients[i]);
+    }
+
+    // ============ PRIVATE =============
+   private:
+    struct GHstreamClient {
+        WiFiClient cl;
+        GHframeSender out;
+    };
+
+    void _accept(WiFiClient& cl) {
+        for (uint8_t i = 0; i < GH_STREAM_CLIENTS; i++) {
+            if (!clients[i].cl) {
+                GHstreamClient& c = clients[i];
+                c.out.reset(frames);
+                c.cl = cl;
+                c.cl.setNoDelay(true);
+                c.cl.print(F("HTTP/1.1 200 OK\r\n"
+                             "Content-Type: multipart/x-mixed-replace;boundary=" GH_STREAM_BOUNDARY "\r\n"
+                             "Access-Control-Allow-Origin: *\r\n"
+                             "Cache-Control: no-cache\r\n\r\n"));
+                return;
+            }
+        }
+        cl.print(F("HTTP/1.1 503 Service Unavailable\r\n\r\n"));
+        cl.stop();
+    }
+
+    void _drop(GHstreamClient& c) {
+        c.out.reset(frames);
+        c.cl.stop();
+        c.cl = WiFiClient();
+    }
+
+    // отправить клиенту очередную порцию кадра, не дожидаясь освобождения сокета
+    void _send(GHstreamClient& c) {
+        if (!c.cl.connected()) {
+            if (c.out.busy()) _drop(c);
+            return;
+        }
+        while (c.cl.available()) c.cl.read();  // запрос не нужен
+        c.out.send(frames, stream_mime, GH_STREAM_CHUNK, _write, &c.cl);
+        if (c.out.stalled(GH_STREAM_TIMEOUT)) _drop(c);  // клиент завис - освободить его буфер кадра
+    }
+
+    // запись без ожидания: сколько есть места в буфере сокета
+    static size_t _write(void* arg, const uint8_t* data, size_t len) {
+        WiFiClient& cl = *(WiFiClient*)arg;
+#ifdef ESP8266
+        size_t room = cl.availableForWrite();
+        return room ? cl.write(data, min(len, room)) : 0;
+#else
+        // WiFiClient::write на esp32 ждёт, пока сокет освободится - пишем в сокет напрямую
+        int fd = cl.fd();
+        if (fd < 0) return 0;
+        int w = send(fd, data, len, MSG_DONTWAIT);
+        if (w < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) cl.stop();  // обрыв - отключится в следующем тике
+            return 0;
+        }
+        return w;
+#endif
+    }
+
+    WiFiServer stream_server;
+    GHframes frames;
+    GHstreamClient clients[GH_STREAM_CLIENTS];
+    size_t (*stream_cb)(uint8_t* buf, size_t size) = nullptr;
+    const char* stream_mime = nullptr;
+};
+#endif
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+#include "../config.hpp"
+#include "../macro.hpp"
+
+#ifdef GH_ESP_BUILD
+#ifdef GH_NO_UDP
+class HubUDP {
+   public:
+};
+#else
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+
+#ifdef ESP8266
+#include <ESP8266WiFi.h>
+#else
+#include <WiFi.h>
+#endif
+
+#include "../utils/stats.h"
+
+// ответ на поиск устройств широковещательной/multicast UDP датаграммой на порт GH_UDP_PORT
+class HubUDP {
+   protected:
+    // вернёт пакет discover для ответа или nullptr
+    virtual String* discoverUDP(char* req) = 0;
+
+    void beginUDP() {
+#ifdef ESP8266
+        udp.beginMulticast(WiFi.localIP(), IPAddress(GH_UDP_GROUP), GH_UDP_PORT);
+#else
+        udp.beginMulticast(IPAddress(GH_UDP_GROUP), GH_UDP_PORT);
+#endif
+    }
+
+    void endUDP() {
+        udp.stop();
+    }
+
+    void tickUDP() {
+        int len = udp.parsePacket();
+        if (len <= 0) return;
+        char req[GH_UDP_REQ_SIZE + 1];
+        len = udp.read(req, min(len, GH_UDP_REQ_SIZE));
+        while (udp.available()) udp.read();  // остаток длинной датаграммы
+        if (len <= 0) return;
+        req[len] = 0;
+        String* answ = discoverUDP(req);
+        if (!answ) return;
+        udp.beginPacket(udp.remoteIP(), udp.remotePort());
+        udp.write((const uint8_t*)answ->c_str(), answ->length());
+        udp.endPacket();
+    }
+
+   private:
+    WiFiUDP udp;
+};
+#endif
+#endif
@@ -67,12 +67,19 @@ class HubWS {
         ws.loop();
     }
 
-    void sendWS(const String& answ) {
-        ws.broadcastTXT(answ.c_str(), answ.length());
+    void sendWS(const String& answ, bool bin = false) {
+        if (bin) ws.broadcastBIN((uint8_t*)answ.c_str(), answ.length());
+        else ws.broadcastTXT(answ.c_str(), answ.length());
     }
 
-    void answerWS(const String& answ) {
-        ws.sendTXT(clientID, answ.c_str(), answ.length());
+    // клиент последнего входящего пакета
+    uint32_t clientWS() {
+        return clientID;
+    }
+
+    void answerWS(const String& answ, bool bin, uint32_t client) {
+        if (bin) ws.sendBIN(client, (uint8_t*)answ.c_str(), answ.length());
+        else ws.sendTXT(client, answ.c_str(), answ.length());
     }
 
     // ============ PRIVATE =============
@@ -0,0 +1,97 @@
+#pragma once
+#include <Arduino.h>
+
+#include "../config.hpp"
+
+// Арена для временных буферов запроса: один блок памяти выделяется в begin() и не освобождается,
+// память раздаётся сдвигом указателя и возвращается целиком по метке (release) - без фрагментации кучи.
+// Нижняя часть, занятая до keep(), постоянная (например буфер чанка загрузки). Только для loop
+class GHarena {
+   public:
+    ~GHarena() {
+        end();
+    }
+
+    // выделить блок size байт
+    bool begin(size_t size) {
+        end();
+        if (!size) return 0;
+        buf = (uint8_t*)malloc(size);
+        if (!buf) return 0;
+        cap = size;
+        return 1;
+    }
+
+    // освободить блок
+    void end() {
+        if (buf) free(buf);
+        buf = nullptr;
+        cap = used = base = high = 0;
+    }
+
+    // выделить len байт (выравнивание 4 или размер указателя). nullptr - не хватает места
+    void* alloc(size_t len) {
+        const size_t align = sizeof(void*) > 4 ? sizeof(void*) : 4;
+        len = (len + align - 1) & ~(align - 1);
+        if (!buf || len > cap - used) return nullptr;
+        void* p = buf + used;
+        used += len;
+        if (used > high) high = used;
+        return p;
+    }
+
+    // текущая метка
+    size_t mark() {
+        return used;
+    }
+
+    // вернуть всё, выделенное после метки
+    void release(size_t m) {
+        used = max(m, base);
+    }
+
+    // вернуть всё, кроме постоянной части
+    void reset() {
+        used = base;
+    }
+
+    // сделать выделенное постоянным (не возвращается в reset)
+    void keep() {
+        base = used;
+    }
+
+    // размер блока
+    size_t size() {
+        return cap;
+    }
+
+    // занято сейчас
+    size_t usage() {
+        return used;
+    }
+
+    // максимум занятого за время работы
+    size_t peak() {
+        return high;
+    }
+
+   private:
+    uint8_t* buf = nullptr;
+    size_t cap = 0;
+    size_t used = 0;
+    size_t base = 0;
+    size_t high = 0;
+};
+
+// шаг обработки: при выходе из области видимости выделенное в арене возвращается
+class GHarenaScope {
+   public:
+    GHarenaScope(GHarena& arena) : arena(arena), m(arena.mark()) {}
+    ~GHarenaScope() {
+        arena.release(m);
+    }
+
+   private:
+    GHarena& arena;
+    size_t m;
+};
@@ -0,0 +1,163 @@
+#pragma once
+#include <Arduino.h>
+#include <limits.h>
+
+#include "color.h"
+#include "datatypes.h"
+#include "flags.h"
+#include "misc.h"
+#include "pos.h"
+
+// ====================== BIND =======================
+// преобразование переменной типа T в строку и обратно, выбирается при компиляции.
+// Для неподдерживаемого типа будет ошибка компиляции
+template <typename T>
+struct GHbind;
+
+template <typename T, long MIN, long MAX>
+struct GHbindInt {
+    static void toStr(String* s, void* v) {
+        GH_addInt(s, *(T*)v);
+    }
+    static void fromStr(const char* str, void* v) {
+        *(T*)v = GH_parseInt(str, MIN, MAX);
+    }
+};
+
+template <typename T, unsigned long MAX>
+struct GHbindUint {
+    static void toStr(String* s, void* v) {
+        GH_addUint(s, *(T*)v);
+    }
+    static void fromStr(const char* str, void* v) {
+        *(T*)v = GH_parseUint(str, MAX);
+    }
+};
+
+template <>
+struct GHbind<signed char> : GHbindInt<signed char, SCHAR_MIN, SCHAR_MAX> {};
+template <>
+struct GHbind<short> : GHbindInt<short, SHRT_MIN, SHRT_MAX> {};
+template <>
+struct GHbind<int> : GHbindInt<int, INT_MIN, INT_MAX> {};
+template <>
+struct GHbind<long> : GHbindInt<long, LONG_MIN, LONG_MAX> {};
+
+template <>
+struct GHbind<unsigned char> : GHbindUint<unsigned char, UCHAR_MAX> {};
+template <>
+struct GHbind<unsigned short> : GHbindUint<unsigned short, USHRT_MAX> {};
+template <>
+struct GHbind<unsigned int> : GHbindUint<unsigned int, UINT_MAX> {};
+template <>
+struct GHbind<unsigned long> : GHbindUint<unsigned long, ULONG_MAX> {};
+
+template <>
+struct GHbind<bool> {
+    static void toStr(String* s, void* v) {
+        *s += *(bool*)v ? '1' : '0';
+    }
+    static void fromStr(const char* str, void* v) {
+        *(bool*)v = (str[0] == '1');
+    }
+};
+
+template <>
+struct GHbind<float> {
+    static void toStr(String* s, void* v) {
+        GH_addFloat(s, *(float*)v);
+    }
+    static void fromStr(const char* str, void* v) {
+        *(float*)v = atof(str);
+    }
+};
+
+template <>
+struct GHbind<double> {
+    static void toStr(String* s, void* v) {
+        GH_addFloat(s, *(double*)v);
+    }
+    static void fromStr(const char* str, void* v) {
+        *(double*)v = atof(str);
+    }
+};
+
+template <>
+struct GHbind<String> {
+    static void toStr(String* s, void* v) {
+        GH_escapeStr(s, ((String*)v)->c_str(), false);
+    }
+    static void fromStr(const char* str, void* v) {
+        *(String*)v = str;
+    }
+};
+
+// char[] - строка, буфер должен вмещать значение
+template <>
+struct GHbind<char> {
+    static void toStr(String* s, void* v) {
+        GH_escapeStr(s, (char*)v, false);
+    }
+    static void fromStr(const char* str, void* v) {
+        strcpy((char*)v, str);
+    }
+};
+
+template <>
+struct GHbind<GHcolor> {
+    static void toStr(String* s, void* v) {
+        GH_addUint(s, ((GHcolor*)v)->getHEX());
+    }
+    static void fromStr(const char* str, void* v) {
+        ((GHcolor*)v)->setHEX(GH_parseUint(str, 0xffffff));
+    }
+};
+
+template <>
+struct GHbind<GHflags> {
+    static void toStr(String* s, void* v) {
+        GH_addUint(s, ((GHflags*)v)->flags);
+    }
+    static void fromStr(const char* str, void* v) {
+        ((GHflags*)v)->flags = GH_parseUint(str, 0xffff);
+    }
+};
+
+template <>
+struct GHbind<GHpos> {
+    static void toStr(GH_UNUSED String* s, GH_UNUSED void* v) {}
+    static void fromStr(const char* str, void* v) {
+        uint32_t xy = GH_parseUint(str, 0xffffffff);
+        ((GHpos*)v)->_changed = true;
+        ((GHpos*)v)->x = xy >> 16;
+        ((GHpos*)v)->y = xy & 0xffff;
+    }
+};
+
+// ====================== VAR =======================
+// привязанная к компоненту переменная: указатель и функции преобразования
+struct GHvar {
+    GHvar() {}
+
+    // тип определяется при компиляции
+    template <typename T>
+    GHvar(T* var) : ptr(var), to(&GHbind<T>::toStr), from(&GHbind<T>::fromStr) {}
+
+    // тип указан вручную
+    GHvar(void* var, GHdata_t type);
+
+    // вывести значение в строку (нет переменной - 0)
+    void toStr(String* s) const {
+        if (ptr && to) to(s, ptr);
+        else *s += '0';
+    }
+
+    // установить значение из строки
+    void fromStr(const char* str) const {
+        if (ptr && from && str) from(str, ptr);
+    }
+
+    void* ptr = nullptr;
+    void (*to)(String* s, void* v) = nullptr;
+    void (*from)(const char* str, void* v) = nullptr;
+};
@@ -4,9 +4,12 @@
 #include "../config.hpp"
 #include "../macro.hpp"
 #include "action.h"
+#include "arena.h"
+#include "bind.h"
 #include "datatypes.h"
 #include "hub.h"
 #include "stats.h"
+#include "strkind.h"
 
 // тип билда
 enum GHbuild_t {
@@ -18,6 +21,89 @@ enum GHbuild_t {
     GH_BUILD_TG,
 };
 
+// список имён для чтения значений за один проход билдера. Строка списка разбивается на месте и восстанавливается.
+// Массивы имён и отметок берутся из арены (если она не выделена или заполнена - из кучи) и возвращаются в деструкторе.
+// Имён не больше GH_READ_LIST, хвост списка отрезается
+struct GHreadList {
+    GHreadList(char* list, GHarena& arena, char div = ',') : arena(arena) {
+        mark = arena.mark();
+        if (!list || !*list) return;
+        this->list = list;
+        this->div = div;
+        amount = 1;
+        for (char* p = list; *p; p++) {
+            if (*p != div) continue;
+            if (amount == GH_READ_LIST) {
+                cut = p;
+                *cut = 0;
+                break;
+            }
+            amount++;
+        }
+        size_t len = amount * (sizeof(char*) + sizeof(bool));
+        names = (char**)arena.alloc(len);
+        if (!names) names = (char**)(heap = malloc(len));
+        found = names ? (bool*)(names + amount) : nullptr;
+        values = new String[amount];
+        if (!names || !values || !found) {
+            _free();
+            return;
+        }
+        memset(found, 0, amount);
+        char* p = list;
+        for (uint16_t i = 0; i < amount; i++) {
+            names[i] = p;
+            p = strchr(p, div);
+            if (p) *p++ = 0;
+        }
+        left = amount;
+    }
+    ~GHreadList() {
+        for (uint16_t i = 1; i < amount; i++) *(names[i] - 1) = div;
+        if (cut) *cut = div;
+        _free();
+    }
+
+    // найти незаполненный слот с именем name вида S (GHpgm, GHram) и отметить его. -1 - не найден
+    template <typename S>
+    int16_t take(VSPTR name) {
+        for (uint16_t i = 0; i < amount; i++) {
+            if (found[i]) continue;
+            if (S::eq(names[i], name)) {
+                found[i] = 1;
+                left--;
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    char** names = nullptr;
+    String* values = nullptr;
+    bool* found = nullptr;
+    uint16_t amount = 0;
+    uint16_t left = 0;
+    bool get = 0;  // чтение для get-топика MQTT (у рядов Chart свой курсор)
+
+   private:
+    void _free() {
+        delete[] values;
+        free(heap);
+        heap = nullptr;
+        arena.release(mark);
+        names = nullptr;
+        values = nullptr;
+        found = nullptr;
+        amount = left = 0;
+    }
+    GHarena& arena;
+    size_t mark = 0;
+    void* heap = nullptr;  // массивы в куче вместо арены
+    char* list = nullptr;
+    char* cut = nullptr;
+    char div = ',';
+};
+
 class GHbuild {
    public:
     GHbuild(GHbuild_t btype = GH_BUILD_NONE, GHaction_t atype = GH_ACTION_NONE, const char* name = nullptr, const char* value = nullptr, GHhub nhub = GHhub()) {
@@ -30,38 +116,82 @@ class GHbuild {
 
     // нажата кнопка с именем name. fstr - имя передано как F() или PSTR()
     bool press(VSPTR name, bool fstr = true) {
-        return check(GH_ACTION_PRESS, name, fstr);
+        return fstr ? press<GHpgm>(name) : press<GHram>(name);
     }
 
     // отпущена кнопка с именем name. fstr - имя передано как F() или PSTR()
     bool release(VSPTR name, bool fstr = true) {
-        return check(GH_ACTION_RELEASE, name, fstr);
+        return fstr ? release<GHpgm>(name) : release<GHram>(name);
     }
 
     // установка значения на компонент с именем name. fstr - имя передано как F() или PSTR()
     bool set(VSPTR name, bool fstr = true) {
-        return check(GH_ACTION_SET, name, fstr);
+        return fstr ? set<GHpgm>(name) : set<GHram>(name);
     }
 
     // имя действия совпадает с именем name. fstr - имя передано как F() или PSTR()
     bool nameEq(VSPTR name, bool fstr = true) {
-        return fstr ? !strcmp_P(action.name, (PGM_P)name) : !strcmp(action.name, (PGM_P)name);
+        return fstr ? nameEq<GHpgm>(name) : nameEq<GHram>(name);
     }
 
     // парсить значение компонента с именем name. fstr - имя передано как F() или PSTR()
     bool parseSet(VSPTR name, void* value, GHdata_t type, bool fstr = true) {
-        if (set(name, fstr)) {
+        return fstr ? parseSet<GHpgm>(name, value, type) : parseSet<GHram>(name, value, type);
+    }
+
+    // парсить значение компонента с именем name в переменную, тип которой определяется при компиляции
+    bool parseSet(VSPTR name, const GHvar& var, bool fstr = true) {
+        return fstr ? parseSet<GHpgm>(name, var) : parseSet<GHram>(name, var);
+    }
+
+    // парсить действие по кнопке с именем name. fstr - имя передано как F() или PSTR()
+    bool parseClick(VSPTR name, bool* value, bool fstr = true) {
+        return fstr ? parseClick<GHpgm>(name, value) : parseClick<GHram>(name, value);
+    }
+
+    // ======= вид строки имени S (GHpgm, GHram) задан при компиляции =======
+    template <typename S>
+    bool press(VSPTR name) {
+        return check<S>(GH_ACTION_PRESS, name);
+    }
+
+    template <typename S>
+    bool release(VSPTR name) {
+        return check<S>(GH_ACTION_RELEASE, name);
+    }
+
+    template <typename S>
+    bool set(VSPTR name) {
+        return check<S>(GH_ACTION_SET, name);
+    }
+
+    template <typename S>
+    bool nameEq(VSPTR name) {
+        return action.name && S::eq(action.name, name);
+    }
+
+    template <typename S>
+    bool parseSet(VSPTR name, void* value, GHdata_t type) {
+        if (set<S>(name)) {
             GHtypeFromStr(action.value, value, type);
             return 1;
         } else return 0;
     }
 
-    // парсить действие по кнопке с именем name. fstr - имя передано как F() или PSTR()
-    bool parseClick(VSPTR name, bool* value, bool fstr = true) {
-        if (press(name, fstr)) {
+    template <typename S>
+    bool parseSet(VSPTR name, const GHvar& var) {
+        if (set<S>(name)) {
+            var.fromStr(action.value);
+            return 1;
+        } else return 0;
+    }
+
+    template <typename S>
+    bool parseClick(VSPTR name, bool* value) {
+        if (press<S>(name)) {
             if (value) *value = 1;
             return 1;
-        } else if (release(name, fstr)) {
+        } else if (release<S>(name)) {
             if (value) *value = 0;
             return 0;
         }
@@ -77,9 +207,13 @@ class GHbuild {
     // действие
     GHaction action;
 
+    // список имён для чтения за один проход (READ)
+    GHreadList* reads = nullptr;
+
    private:
-    bool check(GHaction_t atype, VSPTR name, bool fstr) {
-        if (action.type == atype && nameEq(name, fstr)) {
+    template <typename S>
+    bool check(GHaction_t atype, VSPTR name) {
+        if (action.type == atype && nameEq<S>(name)) {
             action.type = GH_ACTION_NONE;
             return 1;
         }
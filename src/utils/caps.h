@@ -0,0 +1,73 @@
+#pragma once
+#include <Arduino.h>
+
+#include "../config.hpp"
+#include "hub.h"
+#include "misc.h"
+
+// возможности клиента из focus
+#define GH_CAP_MP (1 << 0)   // ответы в MessagePack
+#define GH_CAP_DEF (1 << 1)  // без значений по умолчанию
+#define GH_CAP_SK (1 << 2)   // короткие ключи
+#define GH_CAP_LZ (1 << 3)   // сжатие длинных ответов
+
+// возможности хранятся по клиенту (подключение + id), а не по подключению: через один WS или MQTT
+// работают несколько приложений, и новое не должно получить упакованные ответы для соседнего.
+// До GH_CAPS_CLIENTS клиентов, при переполнении ячейки затираются по кругу
+class GHcaps {
+   public:
+    // разобрать список возможностей caps ("def,sk,lz,mp") и запомнить для клиента hub. Пустой - забыть клиента
+    void set(GHhub& hub, const char* caps) {
+        uint8_t flags = 0;
+#ifndef GH_NO_MSGPACK
+        if (GH_inList(caps, "mp")) flags |= GH_CAP_MP;
+#endif
+        if (GH_inList(caps, "def")) flags |= GH_CAP_DEF;
+        if (GH_inList(caps, "sk")) flags |= GH_CAP_SK;
+        if (GH_inList(caps, "lz")) flags |= GH_CAP_LZ;
+
+        Client* c = _find(hub);
+        if (!flags) {
+            if (c) c->flags = 0;
+            return;
+        }
+        if (!c) c = _free();
+        if (!c) {
+            c = &clients[old];
+            old = (old + 1) % GH_CAPS_CLIENTS;
+        }
+        c->conn = hub.conn;
+        strcpy(c->id, hub.id);
+        c->flags = flags;
+    }
+
+    // возможности клиента hub
+    uint8_t get(GHhub& hub) {
+        Client* c = _find(hub);
+        return c ? c->flags : 0;
+    }
+
+   private:
+    struct Client {
+        GHconn_t conn = GH_SYSTEM;
+        char id[9] = {'\0'};
+        uint8_t flags = 0;
+    };
+
+    Client* _find(GHhub& hub) {
+        for (uint8_t i = 0; i < GH_CAPS_CLIENTS; i++) {
+            Client& c = clients[i];
+            if (c.flags && c.conn == hub.conn && !strcmp(c.id, hub.id)) return &c;
+        }
+        return nullptr;
+    }
+    Client* _free() {
+        for (uint8_t i = 0; i < GH_CAPS_CLIENTS; i++) {
+            if (!clients[i].flags) return &clients[i];
+        }
+        return nullptr;
+    }
+
+    Client clients[GH_CAPS_CLIENTS];
+    uint8_t old = 0;
+};
@@ -40,11 +40,12 @@ GH_PGM(_GH_CMDN7, "upload_chunk");
 GH_PGM(_GH_CMDN8, "ota");
 GH_PGM(_GH_CMDN9, "ota_chunk");
 GH_PGM(_GH_CMDN10, "ota_url");
+GH_PGM(_GH_CMDN11, "fsbr");
 #endif
 
 #ifdef GH_ESP_BUILD
-#define GH_CMDN_LEN 11
-GH_PGM_LIST(_GH_cmdN_list, _GH_CMDN0, _GH_CMDN1, _GH_CMDN2, _GH_CMDN3, _GH_CMDN4, _GH_CMDN5, _GH_CMDN6, _GH_CMDN7, _GH_CMDN8, _GH_CMDN9, _GH_CMDN10);
+#define GH_CMDN_LEN 12
+GH_PGM_LIST(_GH_cmdN_list, _GH_CMDN0, _GH_CMDN1, _GH_CMDN2, _GH_CMDN3, _GH_CMDN4, _GH_CMDN5, _GH_CMDN6, _GH_CMDN7, _GH_CMDN8, _GH_CMDN9, _GH_CMDN10, _GH_CMDN11);
 #else
 #define GH_CMDN_LEN 3
 GH_PGM_LIST(_GH_cmdN_list, _GH_CMDN0, _GH_CMDN1, _GH_CMDN2);
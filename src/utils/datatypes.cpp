@@ -1,64 +1,64 @@
 #include "datatypes.h"
 
-void GHtypeFromStr(const char* str, void* val, GHdata_t type) {
-    if (!val) return;
-    switch (type) {
-        case GH_STR:
-            *(String*)val = str;
-            break;
-        case GH_CSTR:
-            strcpy((char*)val, str);
-            break;
-
-        case GH_BOOL:
-            *(bool*)val = (str[0] == '1');
-            break;
-
-        case GH_INT8:
-            *(int8_t*)val = atoi(str);
-            break;
-
-        case GH_UINT8:
-            *(uint8_t*)val = atoi(str);
-            break;
-
-        case GH_INT16:
-            *(int16_t*)val = atoi(str);
-            break;
-        case GH_UINT16:
-            *(uint16_t*)val = atoi(str);
-            break;
-
-        case GH_INT32:
-            *(int32_t*)val = atol(str);
-            break;
-        case GH_UINT32:
-            *(uint32_t*)val = atol(str);
-            break;
-
-        case GH_FLOAT:
-            *(float*)val = atof(str);
-            break;
-        case GH_DOUBLE:
-            *(double*)val = atof(str);
-            break;
-
-        case GH_COLOR:
-            ((GHcolor*)val)->setHEX(atol(str));
-            break;
-        case GH_FLAGS:
-            ((GHflags*)val)->flags = atoi(str);
-            break;
-        case GH_POS: {
-            uint32_t xy = atol(str);
-            ((GHpos*)val)->_changed = true;
-            ((GHpos*)val)->x = ((uint16_t*)&xy)[1];
-            ((GHpos*)val)->y = ((uint16_t*)&xy)[0];
-        } break;
-
-        case GH_NULL:
-            break;
+#include "bind.h"
+
+struct GHbindNull {
+    static void toStr(String* s, GH_UNUSED void* v) {
+        *s += '0';
     }
+    static void fromStr(GH_UNUSED const char* str, GH_UNUSED void* v) {}
+};
+
+// таблица преобразований в порядке GHdata_t
+static void (*const _GH_toStr[])(String* s, void* v) = {
+    GHbindNull::toStr,
+
+    GHbind<String>::toStr,
+    GHbind<char>::toStr,
+
+    GHbind<bool>::toStr,
+    GHbind<int8_t>::toStr,
+    GHbind<uint8_t>::toStr,
+    GHbind<int16_t>::toStr,
+    GHbind<uint16_t>::toStr,
+    GHbind<int32_t>::toStr,
+    GHbind<uint32_t>::toStr,
+
+    GHbind<float>::toStr,
+    GHbind<double>::toStr,
+
+    GHbind<GHcolor>::toStr,
+    GHbind<GHflags>::toStr,
+    GHbind<GHpos>::toStr,
+};
+
+static void (*const _GH_fromStr[])(const char* str, void* v) = {
+    GHbindNull::fromStr,
+
+    GHbind<String>::fromStr,
+    GHbind<char>::fromStr,
+
+    GHbind<bool>::fromStr,
+    GHbind<int8_t>::fromStr,
+    GHbind<uint8_t>::fromStr,
+    GHbind<int16_t>::fromStr,
+    GHbind<uint16_t>::fromStr,
+    GHbind<int32_t>::fromStr,
+    GHbind<uint32_t>::fromStr,
+
+    GHbind<float>::fromStr,
+    GHbind<double>::fromStr,
+
+    GHbind<GHcolor>::fromStr,
+    GHbind<GHflags>::fromStr,
+    GHbind<GHpos>::fromStr,
+};
+
+GHvar::GHvar(void* var, GHdata_t type) : ptr(var), to(_GH_toStr[type]), from(_GH_fromStr[type]) {}
+
+void GHtypeFromStr(const char* str, void* val, GHdata_t type) {
+    if (!val || !str) return;
+    _GH_fromStr[type](str, val);
 }
 
 void GHtypeToStr(String* s, void* val, GHdata_t type) {
@@ -66,58 +66,99 @@ void GHtypeToStr(String* s, void* val, GHdata_t type) {
         *s += '0';
         return;
     }
-    switch (type) {
-        case GH_STR:
-            *s += *(String*)val;
-            break;
-        case GH_CSTR:
-            *s += (char*)val;
-            break;
-
-        case GH_BOOL:
-            *s += *(bool*)val;
-            break;
-
-        case GH_INT8:
-            *s += *(int8_t*)val;
-            break;
-
-        case GH_UINT8:
-            *s += *(uint8_t*)val;
-            break;
-
-        case GH_INT16:
-            *s += *(int16_t*)val;
-            break;
-        case GH_UINT16:
-            *s += *(uint16_t*)val;
-            break;
-
-        case GH_INT32:
-            *s += *(int32_t*)val;
-            break;
-        case GH_UINT32:
-            *s += *(uint32_t*)val;
-            break;
-
-        case GH_FLOAT:
-            *s += *(float*)val;
-            break;
-        case GH_DOUBLE:
-            *s += *(double*)val;
-            break;
-
-        case GH_COLOR:
-            *s += ((GHcolor*)val)->getHEX();
-            break;
-        case GH_FLAGS:
-            *s += ((GHflags*)val)->flags;
-            break;
-        case GH_POS:
-            break;
-
-        case GH_NULL:
-            *s += '0';
-            break;
+    _GH_toStr[type](s, val);
+}
+
+// ========================== FORMAT ==========================
+void GH_addUint(String* s, unsigned long v) {
+    char buf[21];
+    char* p = buf + sizeof(buf) - 1;
+    *p = 0;
+    do {
+        *--p = '0' + v % 10;
+        v /= 10;
+    } while (v);
+    *s += p;
+}
+
+void GH_addInt(String* s, long v) {
+    if (v < 0) {
+        *s += '-';
+        GH_addUint(s, 0ul - (unsigned long)v);
+    } else {
+        GH_addUint(s, v);
     }
-}
\ No newline at end of file
+}
+
+void GH_addFloat(String* s, double v, uint8_t dec) {
+    if (isnan(v)) {
+        *s += F("nan");
+        return;
+    }
+    if (isinf(v)) {
+        *s += F("inf");
+        return;
+    }
+    if (v < 0) {
+        *s += '-';
+        v = -v;
+    }
+    if (v >= 4294967295.0) {  // не помещается в целое - стандартный вывод
+        *s += String(v, dec);
+        return;
+    }
+    double round = 0.5;
+    for (uint8_t i = 0; i < dec; i++) round /= 10;
+    v += round;
+    unsigned long ip = v;
+    GH_addUint(s, ip);
+    if (!dec) return;
+
+    char buf[12];
+    uint8_t len = 0;
+    double frac = v - ip;
+    buf[len++] = '.';
+    for (uint8_t i = 0; i < dec && len < sizeof(buf) - 1; i++) {
+        frac *= 10;
+        uint8_t d = frac;
+        buf[len++] = '0' + d;
+        frac -= d;
+    }
+    buf[len] = 0;
+    *s += buf;
+}
+
+// ========================== PARSE ==========================
+static const char* _GH_parseSign(const char* s, bool* neg) {
+    while (*s == ' ') s++;
+    *neg = (*s == '-');
+    if (*s == '-' || *s == '+') s++;
+    return s;
+}
+
+unsigned long GH_parseUint(const char* s, unsigned long maxv) {
+    if (!s) return 0;
+    bool neg;
+    s = _GH_parseSign(s, &neg);
+    unsigned long v = 0;
+    while (*s >= '0' && *s <= '9') {
+        uint8_t d = *s++ - '0';
+        if (v > (maxv - d) / 10) return neg ? 0 : maxv;
+        v = v * 10 + d;
+    }
+    return neg ? 0 : v;
+}
+
+long GH_parseInt(const char* s, long minv, long maxv) {
+    if (!s) return 0;
+    bool neg;
+    s = _GH_parseSign(s, &neg);
+    unsigned long lim = neg ? (0ul - (unsigned long)minv) : (unsigned long)maxv;
+    unsigned long v = 0;
+    while (*s >= '0' && *s <= '9') {
+        uint8_t d = *s++ - '0';
+        if (v > (lim - d) / 10) return neg ? minv : maxv;
+        v = v * 10 + d;
+    }
+    return neg ? (long)(0ul - v) : (long)v;
+}
@@ -30,4 +30,13 @@ enum GHdata_t {
 };
 
 void GHtypeToStr(String* s, void* val, GHdata_t type);
-void GHtypeFromStr(const char* s, void* val, GHdata_t type);
\ No newline at end of file
+void GHtypeFromStr(const char* s, void* val, GHdata_t type);
+
+// быстрый вывод чисел в строку без временных String
+void GH_addInt(String* s, long v);
+void GH_addUint(String* s, unsigned long v);
+void GH_addFloat(String* s, double v, uint8_t dec = 2);
+
+// парсинг чисел с ограничением диапазона (значение за пределами - насыщение)
+long GH_parseInt(const char* s, long minv, long maxv);
+unsigned long GH_parseUint(const char* s, unsigned long maxv);
\ No newline at end of file
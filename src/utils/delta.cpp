@@ -0,0 +1,155 @@
+#include "delta.h"
+
+#if defined(GH_ESP_BUILD) && !defined(ESP8266)
+#include <esp_ota_ops.h>
+#endif
+
+#define GH_DELTA_COPY 1
+#define GH_DELTA_ADD 2
+#define GH_DELTA_INSERT 3
+
+static const uint32_t _GH_crcTable[] PROGMEM = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+uint32_t GH_crc32(uint32_t crc, const uint8_t* data, size_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ pgm_read_dword(_GH_crcTable + (crc & 0xf));
+        crc = (crc >> 4) ^ pgm_read_dword(_GH_crcTable + (crc & 0xf));
+    }
+    return ~crc;
+}
+
+static uint32_t _GH_u32(const uint8_t* p) {
+    return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// ========================== PUBLIC ==========================
+size_t GHdelta::write(const uint8_t* data, size_t dlen) {
+    size_t i = 0;
+    while (i < dlen && state != S_ERR) {
+        switch (state) {
+            case S_HEAD:
+                buf[var++] = data[i++];
+                if (var == GH_DELTA_HEAD && !_header()) state = S_ERR;
+                break;
+
+            case S_OP:
+                op = data[i++];
+                var = shift = 0;
+                if (op >= GH_DELTA_COPY && op <= GH_DELTA_INSERT) state = S_LEN;
+                else state = S_ERR;
+                break;
+
+            case S_LEN:
+                if (_varint(data[i++], len)) {
+                    if (!len) state = S_ERR;
+                    else state = (op == GH_DELTA_INSERT) ? S_DATA : S_SEEK;
+                }
+                break;
+
+            case S_SEEK: {
+                uint32_t v;
+                if (!_varint(data[i++], v)) break;
+                sptr += (v >> 1) ^ -(int32_t)(v & 1);  // zigzag
+                if (sptr > ssize || len > ssize - sptr) state = S_ERR;
+                else if (op == GH_DELTA_ADD) state = S_DATA;
+                else if (_source(len)) _command();
+                else state = S_ERR;
+            } break;
+
+            case S_DATA: {
+                size_t n = min((size_t)len, dlen - i);
+                if (op == GH_DELTA_ADD) {
+                    n = min(n, (size_t)GH_DELTA_BUF);
+                    if (!read(sptr, buf, n)) {
+                        state = S_ERR;
+                        break;
+                    }
+                    for (size_t k = 0; k < n; k++) buf[k] += data[i + k];
+                    sptr += n;
+                    if (!_emit(buf, n)) break;
+                } else {
+                    if (!_emit(data + i, n)) break;
+                }
+                i += n;
+                len -= n;
+                if (!len) _command();
+            } break;
+
+            default:  // лишние данные после конца патча
+                state = S_ERR;
+                break;
+        }
+    }
+    return (state == S_ERR) ? 0 : dlen;
+}
+
+// ========================== PRIVATE ==========================
+bool GHdelta::_varint(uint8_t c, uint32_t& v) {
+    if (shift > 28) {
+        state = S_ERR;
+        return 0;
+    }
+    var |= (uint32_t)(c & 0x7f) << shift;
+    shift += 7;
+    if (c & 0x80) return 0;
+    v = var;
+    var = shift = 0;
+    return 1;
+}
+
+bool GHdelta::_header() {
+    if (memcmp(buf, "GHDP", 4) || buf[4] != GH_DELTA_VER) return 0;
+    ssize = _GH_u32(buf + 8);
+    dsize = _GH_u32(buf + 12);
+    dcrc = _GH_u32(buf + 16);
+    var = 0;
+    _command();
+    return 1;
+}
+
+// ждать следующую команду или конец
+void GHdelta::_command() {
+    state = (done >= dsize) ? S_DONE : S_OP;
+}
+
+// COPY: старая прошивка окнами в out
+bool GHdelta::_source(uint32_t n) {
+    while (n) {
+        size_t part = min(n, (uint32_t)GH_DELTA_BUF);
+        if (!read(sptr, buf, part) || !_emit(buf, part)) return 0;
+        sptr += part;
+        n -= part;
+        yield();
+    }
+    return 1;
+}
+
+bool GHdelta::_emit(const uint8_t* data, size_t n) {
+    if (n > dsize - done || out.write(data, n) != n) {
+        state = S_ERR;
+        return 0;
+    }
+    crc = GH_crc32(crc, data, n);
+    done += n;
+    return 1;
+}
+
+// ========================== FLASH ==========================
+#ifdef GH_ESP_BUILD
+bool GH_readSketch(uint32_t addr, uint8_t* buf, size_t len) {
+#ifdef ESP8266
+    // образ скетча лежит во флеш с нулевого адреса
+    if (addr + len > ESP.getFlashChipSize()) return 0;
+    return ESP.flashRead(addr, buf, len);
+#else
+    const esp_partition_t* part = esp_ota_get_running_partition();
+    if (!part || addr + len > part->size) return 0;
+    return esp_partition_read(part, addr, buf, len) == ESP_OK;
+#endif
+}
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+#include <Arduino.h>
+#include <Print.h>
+
+#include "../config.hpp"
+
+// Потоковое применение бинарного патча (дельта OTA) к текущей прошивке. Патч создаётся tools/ghdiff.py.
+// Заголовок 20 байт: "GHDP" [версия] [3 резерв] [размер старой] [размер новой] [CRC32 новой] (uint32 LE).
+// Дальше команды: [код] [длина varint], для COPY и ADD ещё [сдвиг указателя старой прошивки zigzag varint]:
+// COPY - скопировать из старой, ADD - данные патча плюс байты старой, INSERT - данные патча как есть.
+// Старая прошивка читается окнами по GH_DELTA_BUF байт, новая пишется в out, CRC32 проверяется в end()
+
+#define GH_DELTA_HEAD 20
+#define GH_DELTA_VER 1
+#define GH_DELTA_BUF 256  // окно чтения старой прошивки, байт
+
+// чтение старой прошивки: адрес от начала образа. false - ошибка
+typedef bool (*GHdeltaRead)(uint32_t addr, uint8_t* buf, size_t len);
+
+// CRC32 (IEEE, как zlib.crc32)
+uint32_t GH_crc32(uint32_t crc, const uint8_t* data, size_t len);
+
+class GHdelta : public Print {
+   public:
+    GHdelta(GHdeltaRead read, Print& out) : read(read), out(out) {}
+
+    // данные патча (любыми порциями)
+    size_t write(uint8_t c) {
+        return write(&c, 1);
+    }
+    size_t write(const uint8_t* data, size_t len);
+
+    // патч применён полностью и CRC совпал
+    bool end() {
+        return state == S_DONE && crc == dcrc;
+    }
+
+    // ошибка в патче, чтении или записи
+    bool error() {
+        return state == S_ERR;
+    }
+
+    // размер новой прошивки (после заголовка)
+    uint32_t size() {
+        return dsize;
+    }
+
+   private:
+    enum State : uint8_t {
+        S_HEAD,
+        S_OP,
+        S_LEN,
+        S_SEEK,
+        S_DATA,
+        S_DONE,
+        S_ERR,
+    };
+
+    bool _varint(uint8_t c, uint32_t& v);
+    bool _header();
+    void _command();
+    bool _source(uint32_t len);
+    bool _emit(const uint8_t* data, size_t len);
+
+    GHdeltaRead read;
+    Print& out;
+    uint8_t buf[GH_DELTA_BUF];
+    State state = S_HEAD;
+    uint8_t op = 0;
+    uint8_t shift = 0;
+    uint32_t var = 0;
+    uint32_t len = 0;
+    uint32_t sptr = 0;
+    uint32_t ssize = 0;
+    uint32_t dsize = 0;
+    uint32_t dcrc = 0;
+    uint32_t done = 0;
+    uint32_t crc = 0;
+};
+
+#ifdef GH_ESP_BUILD
+// чтение работающей прошивки из флеш
+bool GH_readSketch(uint32_t addr, uint8_t* buf, size_t len);
+#endif
@@ -0,0 +1,242 @@
+#pragma once
+#include <Arduino.h>
+
+#include "../config.hpp"
+
+#define GH_STREAM_BOUNDARY "ghframe"
+#define GH_FRAMES_SLOTS (GH_STREAM_CLIENTS + 1)
+
+#if defined(ESP32) && defined(GH_ASYNC)
+#define GH_FRAMES_LOCK() portENTER_CRITICAL(&_mux)
+#define GH_FRAMES_UNLOCK() portEXIT_CRITICAL(&_mux)
+#else
+#define GH_FRAMES_LOCK()
+#define GH_FRAMES_UNLOCK()
+#endif
+
+// буферы кадров: по одному на клиента плюс один. Клиент держит не больше одного буфера (кадр, который он
+// дочитывает), поэтому свободный буфер для нового кадра есть всегда и медленный клиент не задерживает остальных.
+// Если последний кадр никто не читает - он перезаписывается новым
+class GHframes {
+   public:
+    ~GHframes() {
+        end();
+    }
+
+    // выделить буферы под кадры размером size. Если памяти хватило только на часть буферов (но не меньше двух),
+    // медленный клиент снова может задерживать кадры остальных - они пропускаются
+    bool begin(size_t size) {
+        end();
+        for (uint8_t i = 0; i < GH_FRAMES_SLOTS; i++) {
+            buf[i] = (uint8_t*)malloc(size);
+            if (!buf[i]) break;
+            slots++;
+        }
+        if (slots < 2) {
+            end();
+            return 0;
+        }
+        cap = size;
+        return 1;
+    }
+
+    // освободить буферы
+    void end() {
+        for (uint8_t i = 0; i < GH_FRAMES_SLOTS; i++) {
+            if (buf[i]) free(buf[i]);
+            buf[i] = nullptr;
+            len[i] = 0;
+            readers[i] = 0;
+        }
+        slots = 0;
+        cap = 0;
+        seq = 0;
+        latest = -1;
+        claimed = -1;
+    }
+
+    // буферы выделены
+    bool state() {
+        return cap;
+    }
+
+    // размер буфера кадра
+    size_t capacity() {
+        return cap;
+    }
+
+    // ======================== PRODUCER ========================
+    // получить свободный буфер для записи кадра. nullptr - свободного нет, кадр нужно пропустить
+    uint8_t* claim() {
+        if (!cap || claimed >= 0) return nullptr;
+        int8_t slot = -1;
+        GH_FRAMES_LOCK();
+        for (uint8_t i = 0; i < slots; i++) {
+            if (i != latest && !readers[i]) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot < 0 && latest >= 0 && !readers[latest]) {  // последний кадр никто не читает - перезаписать
+            slot = latest;
+            latest = -1;
+        }
+        claimed = slot;
+        GH_FRAMES_UNLOCK();
+        if (slot < 0) {
+            dropped++;
+            return nullptr;
+        }
+        return buf[slot];
+    }
+    // опубликовать записанный в claim() кадр длиной size
+    void commit(size_t size) {
+        if (claimed < 0) return;
+        len[claimed] = min(size, cap);
+        GH_FRAMES_LOCK();
+        latest = claimed;
+        seq++;
+        GH_FRAMES_UNLOCK();
+        claimed = -1;
+    }
+
+    // отменить запись кадра
+    void cancel() {
+        claimed = -1;
+    }
+
+    // скопировать и опубликовать кадр. false - кадр пропущен
+    bool push(const uint8_t* data, size_t size) {
+        if (size > cap) {
+            dropped++;
+            return 0;
+        }
+        uint8_t* p = claim();
+        if (!p) return 0;
+        memcpy(p, data, size);
+        commit(size);
+        return 1;
+    }
+
+    // ======================== CONSUMER ========================
+    // захватить последний кадр, если он новее last. Вернёт номер буфера или -1
+    int8_t acquire(uint32_t& last) {
+        int8_t slot = -1;
+        GH_FRAMES_LOCK();
+        if (latest >= 0 && seq != last) {
+            slot = latest;
+            readers[slot]++;
+            last = seq;
+        }
+        GH_FRAMES_UNLOCK();
+        return slot;
+    }
+
+    // освободить захваченный кадр
+    void release(int8_t slot) {
+        if (slot < 0) return;
+        GH_FRAMES_LOCK();
+        if (readers[slot]) readers[slot]--;
+        GH_FRAMES_UNLOCK();
+    }
+
+    // данные кадра в буфере slot
+    const uint8_t* data(int8_t slot) {
+        return buf[slot];
+    }
+
+    // длина кадра в буфере slot
+    size_t length(int8_t slot) {
+        return len[slot];
+    }
+
+    // счётчик пропущенных кадров
+    uint32_t dropped = 0;
+
+   private:
+    uint8_t* buf[GH_FRAMES_SLOTS] = {};
+    size_t len[GH_FRAMES_SLOTS] = {};
+    volatile uint8_t readers[GH_FRAMES_SLOTS] = {};
+    uint8_t slots = 0;
+    size_t cap = 0;
+    volatile uint32_t seq = 0;
+    volatile int8_t latest = -1;
+    int8_t claimed = -1;
+#if defined(ESP32) && defined(GH_ASYNC)
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+};
+
+// Отправка кадров одному клиенту стрима. Часть multipart (заголовок, кадр, "\r\n") уходит порциями - сколько
+// примет сокет, без ожидания. Пока клиент дочитывает кадр, он держит его буфер и пропускает новые кадры
+class GHframeSender {
+   public:
+    // запись в сокет: вернуть количество записанных байт, 0 - сокет занят (продолжить в следующий раз)
+    typedef size_t (*Write)(void* arg, const uint8_t* data, size_t len);
+
+    // отправить не больше max байт. Вернёт отправленное, 0 - нового кадра нет или сокет занят
+    size_t send(GHframes& frames, const char* mime, size_t max, Write write, void* arg) {
+        if (slot < 0) {
+            slot = frames.acquire(seq);
+            if (slot < 0) return 0;
+            hlen = snprintf_P(head, sizeof(head), PSTR("--" GH_STREAM_BOUNDARY "\r\nContent-Type: %s\r\nContent-Length: %u\r\n\r\n"),
+                              mime ? mime : "image/jpeg", (unsigned)frames.length(slot));
+            if (hlen >= sizeof(head)) hlen = sizeof(head) - 1;
+            pos = 0;
+            tmr = millis();
+        }
+
+        size_t total = hlen + frames.length(slot) + 2;
+        size_t sent = 0;
+        while (sent < max && pos < total) {
+            const uint8_t* p;
+            size_t left;
+            if (pos < hlen) {
+                p = (const uint8_t*)head + pos;
+                left = hlen - pos;
+            } else if (pos < total - 2) {
+                p = frames.data(slot) + (pos - hlen);
+                left = total - 2 - pos;
+            } else {
+                p = (const uint8_t*)"\r\n" + (pos - (total - 2));
+                left = total - pos;
+            }
+            size_t w = write(arg, p, min(left, max - sent));
+            if (!w) break;
+            pos += w;
+            sent += w;
+            tmr = millis();
+        }
+
+        if (pos >= total) {
+            frames.release(slot);
+            slot = -1;
+        }
+        return sent;
+    }
+
+    // держит буфер кадра (кадр отправлен не полностью)
+    bool busy() {
+        return slot >= 0;
+    }
+
+    // клиент держит кадр и не принял ни байта дольше tout мс - его нужно отключить
+    bool stalled(uint32_t tout) {
+        return slot >= 0 && millis() - tmr >= tout;
+    }
+
+    // освободить захваченный кадр и начать заново (клиент отключился)
+    void reset(GHframes& frames) {
+        frames.release(slot);
+        slot = -1;
+        seq = 0;
+    }
+
+   private:
+    uint32_t seq = 0;
+    uint32_t tmr = 0;
+    size_t pos = 0;
+    int8_t slot = -1;
+    uint8_t hlen = 0;
+    char head[80];
+};
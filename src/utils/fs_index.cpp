@@ -0,0 +1,315 @@
+#include "fs_index.h"
+
+#ifdef GH_ESP_BUILD
+#ifndef GH_NO_FS
+
+GHfsIndex GH_fsIndex;
+
+// путь каталога для ФС: без завершающего /
+static String _GH_fsPath(const String& dir) {
+    return (dir.length() > 1 && dir.endsWith("/")) ? dir.substring(0, dir.length() - 1) : dir;
+}
+
+// обойти каталог на ФС: f(имя, размер, каталог). f вернёт false - остановить
+template <typename F>
+static void _GH_eachFile(const String& dir, F f) {
+#ifdef ESP8266
+    Dir d = GH_FS.openDir(_GH_fsPath(dir));
+    while (d.next()) {
+        String name = d.fileName();
+        if (!name.length()) continue;
+        if (!f(name, d.isDirectory() ? 0 : (uint32_t)d.fileSize(), d.isDirectory())) break;
+    }
+#else
+    File root = GH_FS.open(_GH_fsPath(dir).c_str());
+    if (!root || !root.isDirectory()) return;
+    File file;
+    while (file = root.openNextFile()) {
+        String name(file.name());  // в старых версиях ядра - полный путь
+        int slash = name.lastIndexOf('/');
+        if (slash >= 0) name = name.substring(slash + 1);
+        if (!name.length()) continue;
+        if (!f(name, file.isDirectory() ? 0 : (uint32_t)file.size(), file.isDirectory())) break;
+    }
+#endif
+}
+
+// "/a/b.txt" -> "/a/" + "b.txt", "/a/b/" -> "/a/" + "b"
+static void _GH_splitPath(const String& path, String& dir, String& name) {
+    String p(path);
+    if (!p.startsWith("/")) p = String('/') + p;
+    while (p.length() > 1 && p.endsWith("/")) p.remove(p.length() - 1);
+    int slash = p.lastIndexOf('/');
+    dir = p.substring(0, slash + 1);
+    name = p.substring(slash + 1);
+}
+
+// ========================== PUBLIC ==========================
+uint16_t GHfsIndex::page(String& answ, const String& dir, uint16_t n) {
+    uint32_t from = (uint32_t)n * GH_FS_PAGE;
+    uint32_t to = from + GH_FS_PAGE;
+    uint32_t amount = 0;
+    Dir* d = _get(dir);
+    if (d) {
+        for (uint32_t i = from; i < to && i < d->count; i++) _entry(answ, dir, d->ent[i].name, d->ent[i].size, d->ent[i].dir, nullptr);
+        amount = d->count;
+    } else {  // не помещается в кеш: читаем с ФС, пропуская предыдущие страницы
+        if (!GH_FS.exists(_GH_fsPath(dir))) return 0;
+        _GH_eachFile(dir, [&](const String& name, uint32_t size, bool isdir) {
+            if (amount >= from && amount < to) _entry(answ, dir, name, size, isdir, nullptr);
+            amount++;
+            return true;
+        });
+    }
+    return amount ? (amount + GH_FS_PAGE - 1) / GH_FS_PAGE : 1;
+}
+
+void GHfsIndex::tree(String& answ, const String& dir, uint8_t depth, uint32_t* count) {
+    Dir* d = _get(dir);
+    if (d) {
+        d->pin++;  // вложенные каталоги не должны вытеснить этот
+        for (uint16_t i = 0; i < d->count; i++) {
+            Entry& e = d->ent[i];
+            _entry(answ, dir, e.name, e.size, e.dir, count);
+            if (e.dir && depth) tree(answ, dir + e.name + '/', depth - 1, count);
+        }
+        d->pin--;
+    } else {
+        _GH_eachFile(dir, [&](const String& name, uint32_t size, bool isdir) {
+            _entry(answ, dir, name, size, isdir, count);
+            if (isdir && depth) tree(answ, dir + name + '/', depth - 1, count);
+            return true;
+        });
+    }
+}
+
+void GHfsIndex::removeEnding(const String& dir, const String& ext, uint8_t depth) {
+    String files, dirs;  // имена через '/': во время обхода каталога удалять нельзя
+    _GH_eachFile(dir, [&](const String& name, uint32_t size, bool isdir) {
+        if (isdir) {
+            if (depth) dirs += name + '/';
+        } else if (name.endsWith(ext)) {
+            files += name + '/';
+        }
+        return true;
+    });
+    int from = 0, to;
+    while ((to = files.indexOf('/', from)) >= 0) {
+        String path = dir + files.substring(from, to);
+        if (GH_FS.remove(path)) removed(path);
+        from = to + 1;
+    }
+    from = 0;
+    while ((to = dirs.indexOf('/', from)) >= 0) {
+        removeEnding(dir + dirs.substring(from, to + 1), ext, depth - 1);
+        from = to + 1;
+    }
+}
+
+void GHfsIndex::added(const String& path, uint32_t size) {
+    String dir, name;
+    _GH_splitPath(path, dir, name);
+    if (!name.length()) return;
+    Dir* d = _find(dir);
+    if (d && !d->over) {
+        int i = _indexOf(d, name);
+        if (i >= 0) {
+            d->ent[i].size = size;
+            return;  // файл уже был - каталоги на пути существуют
+        }
+        if (!_push(d, name, size, false)) _drop(d);
+    }
+    // каталоги на пути могли быть созданы вместе с файлом
+    while (dir.length() > 1) {
+        String pdir, pname;
+        _GH_splitPath(dir, pdir, pname);
+        Dir* p = _find(pdir);
+        if (p && !p->over && _indexOf(p, pname) < 0 && !_push(p, pname, 0, true)) _drop(p);
+        dir = pdir;
+    }
+}
+
+void GHfsIndex::removed(const String& path) {
+    String dir, name;
+    _GH_splitPath(path, dir, name);
+    if (!name.length()) return;
+    _dropTree(dir + name + '/');
+    Dir* d = _find(dir);
+    if (d && d->over) _drop(d);  // мог уменьшиться до лимита - пересчитаем при запросе
+    else if (d) {
+        int i = _indexOf(d, name);
+        if (i >= 0) _erase(d, i);
+    }
+    // LittleFS на esp8266 удаляет опустевшие каталоги
+    if (dir.length() > 1 && !GH_FS.exists(_GH_fsPath(dir))) removed(dir);
+}
+
+void GHfsIndex::renamed(const String& from, const String& to) {
+    String fdir, fname;
+    _GH_splitPath(from, fdir, fname);
+    Dir* d = _find(fdir);
+    int i = (d && !d->over) ? _indexOf(d, fname) : -1;
+    if (i >= 0 && d->ent[i].dir) {  // каталог: его содержимое перечитается по запросу
+        removed(from);
+        String tdir, tname;
+        _GH_splitPath(to, tdir, tname);
+        _dropTree(tdir + tname + '/');
+        Dir* p = _find(tdir);
+        if (p && !p->over && _indexOf(p, tname) < 0 && !_push(p, tname, 0, true)) _drop(p);
+        return;
+    }
+    uint32_t size = 0;
+    if (i >= 0) size = d->ent[i].size;
+    else {
+        File f = GH_FS.open(to, "r");
+        if (f) size = f.size();
+    }
+    removed(from);
+    added(to, size);
+}
+
+void GHfsIndex::reset() {
+    while (dirs) _drop(dirs);
+}
+
+// ========================== PRIVATE ==========================
+GHfsIndex::Dir* GHfsIndex::_get(const String& dir) {
+    Dir* d = _find(dir);
+    if (!d) d = _scan(dir);
+    if (!d) return nullptr;
+    d->used = ++clock;
+    return d->over ? nullptr : d;
+}
+
+GHfsIndex::Dir* GHfsIndex::_find(const String& dir) {
+    for (Dir* d = dirs; d; d = d->next) {
+        if (d->path == dir) return d;
+    }
+    return nullptr;
+}
+
+GHfsIndex::Dir* GHfsIndex::_scan(const String& dir) {
+    if (!GH_FS.exists(_GH_fsPath(dir))) return nullptr;
+    // размер считается до вытеснения: каталог больше лимита не должен сбросить весь кеш
+    uint16_t amount = 0;
+    _GH_eachFile(dir, [&](const String&, uint32_t, bool) {
+        return ++amount < GH_FS_INDEX_SIZE;
+    });
+    bool over = amount >= GH_FS_INDEX_SIZE;  // + запись самого каталога
+    uint16_t need = over ? 1 : amount + 1;
+    while (total + need > GH_FS_INDEX_SIZE && _evict(nullptr));
+    Dir* d = new Dir;
+    if (!d) return nullptr;
+    d->path = dir;
+    d->over = over;
+    d->next = dirs;
+    dirs = d;
+    total++;  // сам каталог тоже занимает место в кеше
+    if (over) return d;
+    bool ok = true;
+    _GH_eachFile(dir, [&](const String& name, uint32_t size, bool isdir) {
+        ok = _push(d, name, size, isdir);
+        return ok;
+    });
+    if (!ok) {
+        _drop(d);
+        return nullptr;
+    }
+    return d;
+}
+
+bool GHfsIndex::_push(Dir* d, const String& name, uint32_t size, bool isdir) {
+    if (d->count >= GH_FS_INDEX_SIZE) return 0;
+    while (total >= GH_FS_INDEX_SIZE) {
+        if (!_evict(d)) return 0;
+    }
+    if (d->count == d->cap) {
+        uint16_t ncap = d->cap ? min(d->cap * 2, GH_FS_INDEX_SIZE) : 8;
+        Entry* ent = new Entry[ncap];
+        if (!ent) return 0;
+        for (uint16_t i = 0; i < d->count; i++) {
+            ent[i].name = d->ent[i].name;
+            ent[i].size = d->ent[i].size;
+            ent[i].dir = d->ent[i].dir;
+        }
+        delete[] d->ent;
+        d->ent = ent;
+        d->cap = ncap;
+    }
+    Entry& e = d->ent[d->count++];
+    e.name = name;
+    e.size = size;
+    e.dir = isdir;
+    total++;
+    return 1;
+}
+
+void GHfsIndex::_erase(Dir* d, uint16_t i) {
+    for (; i + 1 < d->count; i++) {
+        d->ent[i].name = d->ent[i + 1].name;
+        d->ent[i].size = d->ent[i + 1].size;
+        d->ent[i].dir = d->ent[i + 1].dir;
+    }
+    d->count--;
+    d->ent[d->count].name = "";
+    total--;
+}
+
+int GHfsIndex::_indexOf(Dir* d, const String& name) {
+    for (uint16_t i = 0; i < d->count; i++) {
+        if (d->ent[i].name == name) return i;
+    }
+    return -1;
+}
+
+// вытеснить давно не запрошенный каталог
+bool GHfsIndex::_evict(Dir* keep) {
+    Dir* old = nullptr;
+    for (Dir* d = dirs; d; d = d->next) {
+        if (d == keep || d->pin) continue;
+        if (!old || d->used < old->used) old = d;
+    }
+    if (!old) return 0;
+    _drop(old);
+    return 1;
+}
+
+void GHfsIndex::_drop(Dir* d) {
+    for (Dir** p = &dirs; *p; p = &(*p)->next) {
+        if (*p == d) {
+            *p = d->next;
+            break;
+        }
+    }
+    total -= d->count + 1;
+    delete[] d->ent;
+    delete d;
+}
+
+void GHfsIndex::_dropTree(const String& dir) {
+    Dir* d = dirs;
+    while (d) {
+        Dir* next = d->next;
+        if (d->path.startsWith(dir) && !d->pin) _drop(d);
+        d = next;
+    }
+}
+
+void GHfsIndex::_entry(String& answ, const String& dir, const String& name, uint32_t size, bool isdir, uint32_t* count) {
+    answ += '\"';
+    GH_escapeStr(&answ, dir.c_str(), false);
+    GH_escapeStr(&answ, name.c_str(), false);
+    if (isdir) answ += F("/\":0,");
+    else {
+        answ += F("\":");
+        answ += size;
+        answ += ',';
+    }
+    if (count) {
+        *count += answ.length();
+        answ = "";
+    }
+}
+
+#endif
+#endif
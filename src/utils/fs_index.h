@@ -0,0 +1,88 @@
+#pragma once
+#include <Arduino.h>
+
+#include "../config.hpp"
+#include "../macro.hpp"
+#include "misc.h"
+
+#ifdef GH_ESP_BUILD
+#ifndef GH_NO_FS
+
+// кеш содержимого каталогов ФС для fsbr. Каталог читается с ФС при первом запросе, дальше обновляется
+// через added/removed/renamed. В кеше до GH_FS_INDEX_SIZE записей, старые каталоги вытесняются.
+// Каталог больше лимита не кешируется и читается с ФС при каждом запросе, в кеше остаётся только
+// отметка о нём - закешированные каталоги ради него не вытесняются
+class GHfsIndex {
+   public:
+    ~GHfsIndex() {
+        reset();
+    }
+
+    // добавить в answ записи 'путь':размер, каталога dir ("/" или "/path/") со страницы n. Вернёт количество страниц, 0 - нет каталога
+    uint16_t page(String& answ, const String& dir, uint16_t n);
+
+    // добавить в answ записи 'путь':размер, дерева от каталога dir на глубину depth.
+    // count != nullptr - только посчитать длину (answ используется как буфер)
+    void tree(String& answ, const String& dir, uint8_t depth, uint32_t* count = nullptr);
+
+    // файл создан или изменён
+    void added(const String& path, uint32_t size);
+
+    // открытый файл изменён (путь и размер берутся из файла)
+    void added(File& file) {
+#ifdef ESP8266
+        added(file.fullName(), file.size());
+#else
+        added(file.path(), file.size());
+#endif
+    }
+
+    // файл или каталог удалён
+    void removed(const String& path);
+
+    // файл или каталог переименован
+    void renamed(const String& from, const String& to);
+
+    // удалить файлы с окончанием ext в дереве от каталога dir на глубину depth
+    void removeEnding(const String& dir, const String& ext, uint8_t depth);
+
+    // очистить кеш (например после форматирования)
+    void reset();
+
+   private:
+    struct Entry {
+        String name;
+        uint32_t size = 0;
+        bool dir = 0;
+    };
+    struct Dir {
+        String path;
+        Entry* ent = nullptr;
+        uint16_t count = 0;
+        uint16_t cap = 0;
+        uint8_t pin = 0;
+        bool over = 0;  // больше лимита, записей нет
+        uint32_t used = 0;
+        Dir* next = nullptr;
+    };
+
+    Dir* _get(const String& dir);
+    Dir* _find(const String& dir);
+    Dir* _scan(const String& dir);
+    bool _push(Dir* d, const String& name, uint32_t size, bool isdir);
+    void _erase(Dir* d, uint16_t i);
+    int _indexOf(Dir* d, const String& name);
+    bool _evict(Dir* keep);
+    void _drop(Dir* d);
+    void _dropTree(const String& dir);
+    void _entry(String& answ, const String& dir, const String& name, uint32_t size, bool isdir, uint32_t* count);
+
+    Dir* dirs = nullptr;
+    uint16_t total = 0;
+    uint32_t clock = 0;
+};
+
+extern GHfsIndex GH_fsIndex;
+
+#endif
+#endif
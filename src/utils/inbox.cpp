@@ -0,0 +1,97 @@
+#include "inbox.h"
+
+#if (defined(GH_ESP_BUILD) && defined(GH_ASYNC)) || defined(GH_POSIX_BUILD)
+#include <string.h>
+
+static uint8_t _GH_inboxNext(uint8_t i) {
+    return (i + 1 == GH_INBOX_SIZE) ? 0 : i + 1;
+}
+
+// ========================== WRITER ==========================
+bool GHinbox::push(uint8_t conn, uint32_t id, const char* url, size_t ulen, const char* value, size_t vlen) {
+    size_t len = ulen + 1 + (value ? vlen + 1 : 0);
+    uint8_t h = head.load(std::memory_order_relaxed);
+    uint16_t pos;
+    if (_GH_inboxNext(h) == tail.load(std::memory_order_acquire) || !_alloc(len, pos)) {
+        drops.store(drops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return 0;
+    }
+    Slot& s = slots[h];
+    s.pos = pos;
+    s.len = len;
+    s.conn = conn;
+    s.event = 0;
+    s.id = id;
+    memcpy(buf + pos, url, ulen);
+    buf[pos + ulen] = 0;
+    s.vpos = 0;
+    if (value) {
+        s.vpos = pos + ulen + 1;
+        memcpy(buf + s.vpos, value, vlen);
+        buf[s.vpos + vlen] = 0;
+    }
+    head.store(_GH_inboxNext(h), std::memory_order_release);
+    return 1;
+}
+
+bool GHinbox::push(uint8_t conn, uint8_t event) {
+    uint8_t h = head.load(std::memory_order_relaxed);
+    if (_GH_inboxNext(h) == tail.load(std::memory_order_acquire)) {
+        drops.store(drops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return 0;
+    }
+    Slot& s = slots[h];
+    s.pos = wpos;  // данных нет, место в буфере не занимает
+    s.len = 0;
+    s.vpos = 0;
+    s.conn = conn;
+    s.event = event;
+    s.id = 0;
+    head.store(_GH_inboxNext(h), std::memory_order_release);
+    return 1;
+}
+
+// ========================== READER ==========================
+bool GHinbox::peek(Frame& f) {
+    uint8_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return 0;
+    Slot& s = slots[t];
+    f.url = s.len ? buf + s.pos : nullptr;
+    f.value = s.vpos ? buf + s.vpos : nullptr;
+    f.id = s.id;
+    f.conn = s.conn;
+    f.event = s.event;
+    return 1;
+}
+
+void GHinbox::pop() {
+    uint8_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return;
+    tail.store(_GH_inboxNext(t), std::memory_order_release);
+}
+
+// ========================== PRIVATE ==========================
+// занятая часть буфера - от начала самого старого пакета до wpos, по кругу.
+// wpos не догоняет начало старого пакета вплотную, поэтому wpos == old - занятая часть пуста
+bool GHinbox::_alloc(size_t len, uint16_t& pos) {
+    if (len >= GH_INBOX_BUF) return 0;
+    uint8_t t = tail.load(std::memory_order_acquire);
+    if (t == head.load(std::memory_order_relaxed)) {  // очередь пуста, читатель всё освободил
+        wpos = 0;
+    } else {
+        uint16_t old = slots[t].pos;
+        if (wpos >= old) {
+            if (wpos + len > GH_INBOX_BUF) {
+                if (len >= old) return 0;
+                wpos = 0;
+            }
+        } else if (wpos + len >= old) {
+            return 0;
+        }
+    }
+    pos = wpos;
+    wpos += len;
+    return 1;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../config.hpp"
+
+// нужна только async сборке esp (и linux - для теста на ПК), где есть <atomic>
+#if (defined(GH_ESP_BUILD) && defined(GH_ASYNC)) || defined(GH_POSIX_BUILD)
+#include <atomic>
+
+// Очередь входящих пакетов из сетевой задачи в loop (один писатель, один читатель, без блокировок).
+// Писатель (обработчик async библиотеки) копирует пакет в кольцевой буфер данных и сразу возвращается,
+// читатель разбирает пакеты в tick(). Данные пакета лежат одним куском: url\0[value\0].
+// Если места нет - пакет отбрасывается (приложение повторит запрос по таймауту)
+
+class GHinbox {
+   public:
+    struct Frame {
+        char* url;
+        char* value;  // nullptr - value в url после '='
+        uint32_t id;  // id клиента
+        uint8_t conn;
+        uint8_t event;  // не 0 - системное событие без данных
+    };
+
+    // ======= писатель =======
+    // пакет: url длиной ulen, value длиной vlen (nullptr - без отдельного value)
+    bool push(uint8_t conn, uint32_t id, const char* url, size_t ulen, const char* value = nullptr, size_t vlen = 0);
+
+    // системное событие
+    bool push(uint8_t conn, uint8_t event);
+
+    // ======= читатель =======
+    // первый пакет в очереди. Данные действительны до pop()
+    bool peek(Frame& f);
+
+    // освободить первый пакет
+    void pop();
+
+    // отброшено пакетов (очередь или буфер заполнены)
+    uint32_t dropped() {
+        return drops.load(std::memory_order_relaxed);
+    }
+
+   private:
+    struct Slot {
+        uint16_t pos;
+        uint16_t len;
+        uint16_t vpos;  // 0 - без value
+        uint8_t conn;
+        uint8_t event;
+        uint32_t id;
+    };
+
+    bool _alloc(size_t len, uint16_t& pos);
+
+    Slot slots[GH_INBOX_SIZE];
+    char buf[GH_INBOX_BUF];
+    uint16_t wpos = 0;  // курсор писателя в buf
+    std::atomic<uint8_t> head{0};  // пишет писатель
+    std::atomic<uint8_t> tail{0};  // пишет читатель
+    std::atomic<uint32_t> drops{0};
+};
+
+#endif
@@ -10,6 +10,7 @@ class GHlog : public Print {
     void begin(int n = 64) {
         end();
         len = head = 0;
+        count = sent = 0;
         size = n;
         buffer = new char[size];
     }
@@ -31,15 +32,14 @@ class GHlog : public Print {
         return 1;
     }
 
+    virtual size_t write(const uint8_t* data, size_t n) {
+        if (buffer && n) _write(data, n);
+        return n;
+    }
+
     // прочитать в строку
     void read(String* s) {
-        if (!buffer) return;
-        bool start = 0;
-        for (uint16_t i = 0; i < len; i++) {
-            char c = _read(i);
-            if (start && c != '\r') GH_escapeChar(s, c);
-            else if (c == '\n') start = 1;
-        }
+        readSince(s, 0);
     }
 
     // прочитать строкой
@@ -50,9 +50,37 @@ class GHlog : public Print {
         return s;
     }
 
+    // позиция, с которой readSince(seq) начнёт вывод.
+    // Если часть данных после seq уже перезаписана - начало первой целой строки в буфере
+    uint32_t since(uint32_t seq) {
+        if (!buffer) return count;
+        if (count - seq <= (uint32_t)len) return seq;
+        if (len < size) return count - len;
+        for (uint16_t i = 0; i < len; i++) {
+            if (_read(i) == '\n') return count - len + i + 1;
+        }
+        return count;
+    }
+
+    // дописать в строку данные, записанные после позиции seq (с экранированием для JSON).
+    // Вернёт текущую позицию для следующего вызова. Начало вывода - since(seq)
+    uint32_t readSince(String* s, uint32_t seq) {
+        if (!buffer) return count;
+        uint32_t amount = count - since(seq);
+        s->reserve(s->length() + amount);
+        for (uint16_t i = len - amount; i < len; i++) GH_escapeChar(s, _read(i));
+        return count;
+    }
+
+    // позиция записи (всего записано байт)
+    uint32_t written() {
+        return count;
+    }
+
     // очистить
     void clear() {
         len = head = 0;
+        sent = count;
     }
 
     // есть данные
@@ -72,17 +100,37 @@ class GHlog : public Print {
 
     char* buffer = nullptr;
 
+    // позиция, до которой лог отправлен через sendLog()
+    uint32_t sent = 0;
+
    private:
     void _write(uint8_t n) {
         if (len < size) len++;
         buffer[head] = n;
         if (++head >= size) head = 0;
+        count++;
+    }
+    void _write(const uint8_t* data, size_t n) {
+        count += n;
+        if (n > size) {
+            data += n - size;
+            n = size;
+        }
+        uint16_t part = min(n, (size_t)(size - head));
+        memcpy(buffer + head, data, part);
+        memcpy(buffer, data + part, n - part);
+        head += n;
+        if (head >= size) head -= size;
+        len = min((size_t)len + n, (size_t)size);
     }
     char _read(int num) {
-        return buffer[(len < size) ? num : ((head + num) % size)];
+        int i = head - len + num;
+        if (i < 0) i += size;
+        return buffer[i];
     }
 
     uint16_t size = 0;
     uint16_t len = 0;
     uint16_t head = 0;
+    uint32_t count = 0;
 };
\ No newline at end of file
@@ -0,0 +1,187 @@
+#pragma once
+#include <Arduino.h>
+#include <Print.h>
+
+#include "../config.hpp"
+#include "fs_index.h"
+#include "misc.h"
+
+#ifdef GH_ESP_BUILD
+#ifndef GH_NO_FS
+
+// лог в файл: print() пишет в буфер в RAM, tick() сбрасывает его в файл страницами,
+// не дольше заданного бюджета. Файлы ротируются по размеру: path, path.1 ... path.N-1
+class GHlogFile : public Print {
+   public:
+    ~GHlogFile() {
+        end();
+    }
+
+    // начать: путь к файлу (хранится указатель), макс. размер файла, количество файлов, размер страницы, количество страниц в буфере
+    bool begin(const char* path, uint32_t fsize = 16384, uint8_t files = 4, uint16_t page = 256, uint8_t pages = 4) {
+        end();
+        if (!path || !page || !pages) return 0;
+        cap = page * pages;
+        buffer = (uint8_t*)malloc(cap);
+        if (!buffer) {
+            cap = 0;
+            return 0;
+        }
+        this->path = path;
+        this->fsize = max(fsize, (uint32_t)page);
+        this->files = files ? files : 1;
+        this->page = page;
+        len = head = 0;
+        dropped = 0;
+        return 1;
+    }
+
+    // остановить (несохранённые данные записываются)
+    void end() {
+        if (!buffer) return;
+        flush();
+        free(buffer);
+        buffer = nullptr;
+        cap = 0;
+    }
+
+    // запущен
+    bool state() {
+        return buffer;
+    }
+
+    // макс. время записи за один tick, мс (умолч. 5), включая открытие и ротацию файлов. Одна страница или одна ротация выполняется всегда
+    void setBudget(uint16_t ms) {
+        budget = ms;
+    }
+
+    // период записи неполной страницы, мс (умолч. 2000)
+    void setPeriod(uint16_t ms) {
+        prd = ms;
+    }
+
+    virtual size_t write(uint8_t n) {
+        return write(&n, 1);
+    }
+
+    virtual size_t write(const uint8_t* data, size_t n) {
+        if (!buffer) return n;
+        size_t room = cap - len;
+        if (n > room) {
+            dropped += n - room;
+            n = room;
+        }
+        if (!len) tmr = millis();
+        size_t tail = head + len;
+        if (tail >= cap) tail -= cap;
+        size_t part = min(n, cap - tail);
+        memcpy(buffer + tail, data, part);
+        memcpy(buffer, data + part, n - part);
+        len += n;
+        return n;
+    }
+
+    // тикер, вызывать в loop
+    void tick() {
+        if (!buffer || !len) return;
+        if (len < page && millis() - tmr < prd) return;
+        _flush(budget);
+    }
+
+    // записать буфер в файл целиком (блокирующая)
+    void flush() {
+        if (buffer) _flush(0);
+    }
+
+    // удалить все файлы лога
+    void clear() {
+        len = head = 0;
+        for (uint8_t i = 0; i < files; i++) {
+            if (GH_FS.remove(_name(i))) GH_fsIndex.removed(_name(i));
+        }
+    }
+
+    // количество байт в буфере
+    size_t pending() {
+        return len;
+    }
+
+    // путь к файлу лога номер n (0 - текущий)
+    String fileName(uint8_t n = 0) {
+        return _name(n);
+    }
+
+    // счётчик байт, потерянных при переполнении буфера
+    uint32_t dropped = 0;
+
+   private:
+    // budget 0 - записать всё. Открытие и ротация тоже входят в бюджет: после ротации файл
+    // открывается только если время ещё есть, иначе запись продолжится в следующем tick
+    void _flush(uint16_t ms) {
+        uint32_t start = millis();
+        File file = GH_FS.open(path, "a");
+        if (!file) return;
+        size_t fs = file.size();
+        while (len) {
+            if (fs >= fsize) {
+                GH_fsIndex.added(path, fs);
+                file.close();
+                _rotate();
+                if (_over(start, ms)) break;
+                file = GH_FS.open(path, "a");
+                if (!file) break;
+                fs = 0;
+            }
+            size_t chunk = min(min(len, (size_t)page), cap - head);
+            chunk = min(chunk, (size_t)(fsize - fs));
+            size_t w = file.write(buffer + head, chunk);
+            if (!w) break;
+            fs += w;
+            head += w;
+            if (head >= cap) head = 0;
+            len -= w;
+            if (_over(start, ms)) break;
+        }
+        if (file) {
+            GH_fsIndex.added(path, fs);
+            file.close();
+        }
+        if (!len) head = 0;
+        tmr = millis();
+    }
+
+    bool _over(uint32_t start, uint16_t ms) {
+        return ms && millis() - start >= ms;
+    }
+
+    void _rotate() {
+        if (GH_FS.remove(_name(files - 1))) GH_fsIndex.removed(_name(files - 1));
+        for (uint8_t i = files - 1; i > 0; i--) {
+            if (GH_FS.rename(_name(i - 1), _name(i))) GH_fsIndex.renamed(_name(i - 1), _name(i));
+        }
+    }
+
+    String _name(uint8_t n) {
+        String s(path);
+        if (n) {
+            s += '.';
+            s += n;
+        }
+        return s;
+    }
+
+    uint8_t* buffer = nullptr;
+    size_t cap = 0;
+    size_t len = 0;
+    size_t head = 0;
+    const char* path = nullptr;
+    uint32_t fsize = 0;
+    uint32_t tmr = 0;
+    uint16_t page = 0;
+    uint16_t budget = 5;
+    uint16_t prd = 2000;
+    uint8_t files = 1;
+};
+
+#endif
+#endif
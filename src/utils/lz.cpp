@@ -0,0 +1,185 @@
+#include "lz.h"
+
+bool GHlz::beginEncode() {
+    end();
+    win = (uint8_t*)malloc(GH_LZ_WIN);
+    head = (uint16_t*)calloc(GH_LZ_HASH, sizeof(uint16_t));
+    prev = (uint16_t*)malloc(GH_LZ_WIN * sizeof(uint16_t));
+    if (!win || !head || !prev) {
+        end();
+        return 0;
+    }
+    return 1;
+}
+
+bool GHlz::beginDecode() {
+    end();
+    win = (uint8_t*)malloc(GH_LZ_WIN);
+    return win;
+}
+
+void GHlz::end() {
+    free(win);
+    free(head);
+    free(prev);
+    win = nullptr;
+    head = prev = nullptr;
+    pos = done = 0;
+    grp[0] = 0;
+    glen = 1;
+    gbit = 0;
+}
+
+// ========================== ENCODE ==========================
+void GHlz::encode(const uint8_t* data, size_t len, Print& out) {
+    if (!head) return;
+    uint32_t start = pos;
+    size_t i = 0;
+    while (i < len) {
+        uint16_t best = 0, bdist = 0;
+        if (len - i >= GH_LZ_MIN) {
+            uint16_t maxl = min(len - i, (size_t)GH_LZ_MAX);
+            uint16_t cand = head[_hash(data + i)];
+            uint16_t last = 0;
+            for (uint8_t n = 0; n < GH_LZ_CHAIN; n++) {
+                uint16_t dist = (uint16_t)pos - cand;
+                // позиции в таблицах хранятся по модулю 2^16: устаревшие отсекаются по расстоянию
+                if (!dist || dist > GH_LZ_WIN || dist > pos || dist <= last) break;
+                uint32_t src = pos - dist;
+                uint16_t l = 0;
+                while (l < maxl && _at(src + l, data, start) == data[i + l]) l++;
+                if (l > best) {
+                    best = l;
+                    bdist = dist;
+                    if (l == maxl) break;
+                }
+                last = dist;
+                cand = prev[cand & (GH_LZ_WIN - 1)];
+            }
+        }
+        if (best >= GH_LZ_MIN) {
+            uint16_t d = bdist - 1;
+            _item(0, d & 0xff, ((d >> 8) << 6) | (best - GH_LZ_MIN), out);
+            for (uint16_t k = 0; k < best; k++, i++) _put(data + i, len - i);
+        } else {
+            _item(1, data[i], 0, out);
+            _put(data + i, len - i);
+            i++;
+        }
+    }
+}
+
+void GHlz::flush(Print& out) {
+    if (!gbit) return;
+    out.write(grp, glen);
+    grp[0] = 0;
+    glen = 1;
+    gbit = 0;
+}
+
+void GHlz::_put(const uint8_t* p, size_t left) {
+    if (left >= GH_LZ_MIN) {
+        uint8_t h = _hash(p);
+        prev[pos & (GH_LZ_WIN - 1)] = head[h];
+        head[h] = pos;
+    }
+    win[pos & (GH_LZ_WIN - 1)] = *p;
+    pos++;
+}
+
+void GHlz::_item(bool literal, uint8_t b0, uint8_t b1, Print& out) {
+    if (literal) {
+        grp[0] |= 1 << gbit;
+        grp[glen++] = b0;
+    } else {
+        grp[glen++] = b0;
+        grp[glen++] = b1;
+    }
+    if (++gbit == 8) flush(out);
+}
+
+// ========================== DECODE ==========================
+bool GHlz::decode(const uint8_t* data, size_t len, Print& out) {
+    if (!win) return 0;
+    uint8_t flags = 0, bits = 0;
+    size_t i = 0;
+    bool ok = 1;
+    while (i < len) {
+        if (!bits) {
+            flags = data[i++];
+            bits = 8;
+            continue;
+        }
+        if (flags & 1) {
+            if (!_out(data[i++], out)) return 0;
+        } else {
+            if (i + 1 >= len) {
+                ok = 0;
+                break;
+            }
+            uint16_t dist = (data[i] | ((data[i + 1] >> 6) << 8)) + 1;
+            uint8_t l = (data[i + 1] & 0x3f) + GH_LZ_MIN;
+            i += 2;
+            if (dist > pos) {
+                ok = 0;
+                break;
+            }
+            while (l--) {
+                if (!_out(win[(pos - dist) & (GH_LZ_WIN - 1)], out)) return 0;
+            }
+        }
+        flags >>= 1;
+        bits--;
+    }
+    if (pos != done) {
+        if (out.write(win + (done & (GH_LZ_WIN - 1)), pos - done) != pos - done) ok = 0;
+        done = pos;
+    }
+    return ok;
+}
+
+// false - вывод принял не всё (например, ФС заполнена)
+bool GHlz::_out(uint8_t c, Print& out) {
+    win[pos & (GH_LZ_WIN - 1)] = c;
+    pos++;
+    if (!(pos & (GH_LZ_WIN - 1))) {  // окно заполнено до конца - сбросить
+        size_t len = pos - done;
+        bool ok = out.write(win + (done & (GH_LZ_WIN - 1)), len) == len;
+        done = pos;
+        return ok;
+    }
+    return 1;
+}
+
+// ========================== PACK ==========================
+// Print с выводом в строку
+class GHlzString : public Print {
+   public:
+    GHlzString(String& str) : str(str) {}
+
+    size_t write(uint8_t c) {
+        str += (char)c;
+        return 1;
+    }
+    size_t write(const uint8_t* data, size_t len) {
+        str.concat((const char*)data, len);
+        return len;
+    }
+
+   private:
+    String& str;
+};
+
+bool GH_lzPack(const String& in, String& out) {
+    GHlz lz;
+    if (!lz.beginEncode()) return 0;
+    uint32_t start = out.length();
+    out.reserve(start + in.length() / 2);
+    out += (char)GH_LZ_FRAME;
+    GHlzString p(out);
+    lz.encode((const uint8_t*)in.c_str(), in.length(), p);
+    lz.flush(p);
+    if (out.length() - start < in.length()) return 1;
+    out.remove(start);
+    return 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <Arduino.h>
+#include <Print.h>
+
+#include "../config.hpp"
+
+// Потоковое LZSS сжатие файлов при передаче. Поток - группы: байт флагов (младший бит первый,
+// 1 - литерал, 0 - ссылка) и до 8 элементов. Литерал - 1 байт, ссылка - 2 байта:
+// [смещение-1 младшие 8 бит] [смещение-1 старшие 2 бита | длина-3 6 бит]. Чанк передачи всегда
+// заканчивается целой группой, окно сохраняется между чанками
+
+#define GH_LZ_WIN 1024  // окно, байт
+#define GH_LZ_MIN 3     // мин. длина ссылки
+#define GH_LZ_MAX 66    // макс. длина ссылки
+#define GH_LZ_HASH 256  // таблица хешей компрессора
+#define GH_LZ_CHAIN 8   // макс. кандидатов на позицию
+#define GH_LZ_FRAME 0xc1  // первый байт сжатого ответа (в MessagePack не используется)
+
+class GHlz {
+   public:
+    ~GHlz() {
+        end();
+    }
+
+    // подготовить сжатие (~3.5 кБ RAM)
+    bool beginEncode();
+
+    // подготовить распаковку (1 кБ RAM)
+    bool beginDecode();
+
+    // освободить память
+    void end();
+
+    // сжать порцию данных в out
+    void encode(const uint8_t* data, size_t len, Print& out);
+
+    // завершить чанк: дописать неполную группу
+    void flush(Print& out);
+
+    // распаковать чанк в out. false - ошибка в данных
+    bool decode(const uint8_t* data, size_t len, Print& out);
+
+   private:
+    uint8_t _at(uint32_t a, const uint8_t* data, uint32_t start) {
+        return (a >= start) ? data[a - start] : win[a & (GH_LZ_WIN - 1)];
+    }
+    uint8_t _hash(const uint8_t* p) {
+        return (p[0] * 33 + p[1] * 7 + p[2]) & (GH_LZ_HASH - 1);
+    }
+    void _put(const uint8_t* p, size_t left);
+    void _item(bool literal, uint8_t b0, uint8_t b1, Print& out);
+    bool _out(uint8_t c, Print& out);
+
+    uint8_t* win = nullptr;
+    uint16_t* head = nullptr;
+    uint16_t* prev = nullptr;
+    uint32_t pos = 0;
+    uint32_t done = 0;
+    uint8_t grp[17];
+    uint8_t glen = 1;
+    uint8_t gbit = 0;
+};
+
+// сжать ответ целиком: [GH_LZ_FRAME][LZSS]. Окно не переносится между ответами, память только на время вызова.
+// false - нет памяти или сжатие не выгодно, out не изменён
+bool GH_lzPack(const String& in, String& out);
@@ -21,6 +21,40 @@ char* GH_splitter(char* list, char div) {
     return NULL;
 }
 
+// сравнение с шаблоном: * - любые символы, ? - один символ
+bool GH_glob(const char* pat, const char* str) {
+    const char* star = nullptr;
+    const char* back = nullptr;
+    while (*str) {
+        if (*pat == '*') {
+            star = pat++;
+            back = str;
+        } else if (*pat == '?' || *pat == *str) {
+            pat++;
+            str++;
+        } else if (star) {
+            pat = star + 1;
+            str = ++back;
+        } else {
+            return 0;
+        }
+    }
+    while (*pat == '*') pat++;
+    return !*pat;
+}
+
+// str есть в списке через запятую
+bool GH_inList(const char* list, const char* str) {
+    uint16_t len = strlen(str);
+    while (list && *list) {
+        const char* div = strchr(list, ',');
+        uint16_t tlen = div ? (div - list) : strlen(list);
+        if (tlen == len && !strncmp(list, str, len)) return 1;
+        list = div ? div + 1 : nullptr;
+    }
+    return 0;
+}
+
 String GH_uptime() {
     uint32_t sec = millis() / 1000ul;
     uint8_t second = sec % 60ul;
@@ -45,110 +79,123 @@ String GH_uptime() {
 }
 
 void GH_escapeChar(String* s, char c) {
-    if (c <= 13) {
-        *s += '\\';
-        switch (c) {
-            case '\r':
-                *s += 'r';
-                break;
-            case '\n':
-                *s += 'n';
-                break;
-            case '\t':
-                *s += 't';
-                break;
-        }
-    } else if (c == '\"' || c == '\'') {
-        *s += '\\';
-        *s += '\"';
-    } else if (c == '\\') {
-        *s += '\\';
-        *s += '\\';
-    } else {
-        *s += c;
+    switch (c) {
+        case '\"':
+        case '\\':
+            *s += '\\';
+            *s += c;
+            break;
+        case '\r':
+            *s += F("\\r");
+            break;
+        case '\n':
+            *s += F("\\n");
+            break;
+        case '\t':
+            *s += F("\\t");
+            break;
+        case '\'':  // старые приложения заменяют ' на " во всём пакете, \u0027 это переживает
+            *s += F("\\u0027");
+            break;
+        default:
+            if ((uint8_t)c < 0x20) {  // прочие управляющие - \u00XX
+                *s += F("\\u00");
+                *s += (char)('0' + (c >> 4));
+                *s += (char)((c & 0xf) < 10 ? '0' + (c & 0xf) : 'a' + (c & 0xf) - 10);
+            } else {
+                *s += c;
+            }
+            break;
     }
 }
 void GH_escapeStr(String* s, VSPTR v, bool fstr) {
     if (!v) return;
     if (fstr) {
-        uint16_t len = strlen_P((PGM_P)v);
+        size_t len = strlen_P((PGM_P)v);
         char str[len + 1];
         strcpy_P(str, (PGM_P)v);
-        for (uint16_t i = 0; i < len; i++) GH_escapeChar(s, str[i]);
+        for (size_t i = 0; i < len; i++) GH_escapeChar(s, str[i]);
     } else {
         char* str = (char*)v;
-        uint16_t len = strlen(str);
-        for (uint16_t i = 0; i < len; i++) GH_escapeChar(s, str[i]);
+        size_t len = strlen(str);
+        for (size_t i = 0; i < len; i++) GH_escapeChar(s, str[i]);
     }
 }
 
 // ========================== FS ==========================
 #ifdef GH_ESP_BUILD
-#ifndef GH_NO_FS
-void GH_showFiles(String& answ, const String& path, GH_UNUSED uint8_t levels, uint16_t* count) {
-#ifdef ESP8266
-    Dir dir = GH_FS.openDir(path);
-    while (dir.next()) {
-        if (dir.isDirectory()) {
-            String p(path);
-            p += dir.fileName();
-            p += '/';
-            answ += '\'';
-            answ += p;
-            answ += "':0,";
-            if (count) {
-                *count += answ.length();
-                answ = "";
-            }
-            Dir sdir = GH_FS.openDir(p);
-            GH_showFiles(answ, p);
+// base64 в байты, вернёт длину
+static uint16_t _GH_b64decode(const char* str, uint8_t* data) {
+    uint16_t len = strlen(str);
+    if (len < 4) return 0;
+    int padd = 0;
+    if (str[len - 2] == '=') padd = 2;
+    else if (str[len - 1] == '=') padd = 1;
+
+    int val = 0, valb = -8;
+    uint16_t idx = 0;
+    for (uint16_t i = 0; i < len - padd; i++) {
+        uint8_t b = GH_b64i(str[i]);
+        val = (val << 6) + b;
+        valb += 6;
+        if (valb >= 0) {
+            data[idx++] = (uint8_t)((val >> valb) & 0xFF);
+            valb -= 8;
         }
-        if (dir.isFile() && dir.fileName().length()) {
-            answ += '\'';
-            answ += path;
-            answ += dir.fileName();
-            answ += "':";
-            answ += dir.fileSize();
-            answ += ',';
-            if (count) {
-                *count += answ.length();
-                answ = "";
-            }
+    }
+    return idx;
+}
+
+#ifndef GH_NO_FS
+// Print с выводом в строку в base64
+class GHb64Print : public Print {
+   public:
+    GHb64Print(String& str) : str(str) {}
+
+    size_t write(uint8_t c) {
+        val = ((val << 8) | c) & 0xffff;
+        valb += 8;
+        while (valb >= 0) {
+            str += GH_b64v((val >> valb) & 0x3F);
+            slen++;
+            valb -= 6;
         }
+        return 1;
     }
+    using Print::write;
 
-#else  // ESP32
-    File root = GH_FS.open(path.c_str());
-    if (!root || !root.isDirectory()) return;
-    File file;
-    while (file = root.openNextFile()) {
-        if (file.isDirectory()) {
-            answ += '\'';
-            answ += file.path();
-            answ += "/':0,";
-            if (count) {
-                *count += answ.length();
-                answ = "";
-            }
-            if (levels) GH_showFiles(answ, file.path(), levels - 1);
-        } else {
-            answ += '\'';
-            if (levels != GH_FS_DEPTH) answ += path;
-            answ += '/';
-            answ += file.name();
-            answ += "':";
-            answ += file.size();
-            answ += ',';
-            if (count) {
-                *count += answ.length();
-                answ = "";
-            }
+    void end() {
+        if (valb > -6) {
+            str += GH_b64v(((val << 8) >> (valb + 8)) & 0x3F);
+            slen++;
+        }
+        while (slen % 4) {
+            str += '=';
+            slen++;
         }
     }
-#endif
-}
 
-void GH_fileToB64(File& file, String& str) {
+   private:
+    String& str;
+    uint16_t slen = 0;
+    int val = 0, valb = -6;
+};
+
+void GH_fileToB64(File& file, String& str, GHlz* lz) {
+    if (lz) {  // чанк GH_DOWN_CHUNK_SIZE байт файла, сжатый
+        GHb64Print b64(str);
+        uint8_t buf[128];
+        size_t len = 0;
+        while (len < GH_DOWN_CHUNK_SIZE && file.available()) {
+            size_t n = file.read(buf, min(sizeof(buf), (size_t)(GH_DOWN_CHUNK_SIZE - len)));
+            if (!n) break;
+            lz->encode(buf, n, b64);
+            len += n;
+        }
+        lz->flush(b64);
+        b64.end();
+        return;
+    }
     int16_t len = 0;
     uint16_t slen = 0;
     int val = 0, valb = -6;
@@ -174,47 +221,22 @@ void GH_fileToB64(File& file, String& str) {
     }
 }
 
-void GH_B64toFile(File& file, const char* str) {
-    uint16_t len = strlen(str);
-    if (len < 4) return;
-    int padd = 0;
-    if (str[len - 2] == '=') padd = 2;
-    else if (str[len - 1] == '=') padd = 1;
-
-    int val = 0, valb = -8;
-    for (uint16_t i = 0; i < len - padd; i++) {
-        uint8_t b = GH_b64i(str[i]);
-        val = (val << 6) + b;
-        valb += 6;
-        if (valb >= 0) {
-            file.write(uint8_t((val >> valb) & 0xFF));
-            valb -= 8;
-        }
-    }
+bool GH_B64toFile(File& file, const char* str, GHlz* lz) {
+    uint8_t data[(strlen(str) + 3) / 4 * 3];
+    uint16_t len = _GH_b64decode(str, data);
+    return lz ? lz->decode(data, len, file) : (file.write(data, len) == len);  // короткая запись - ФС заполнена
 }
 #endif
 
 #ifndef GH_NO_OTA
-void GH_B64toUpdate(const char* str) {
-    uint16_t len = strlen(str);
-    if (len < 4) return;
-    int padd = 0;
-    if (str[len - 2] == '=') padd = 2;
-    else if (str[len - 1] == '=') padd = 1;
-    int blen = ((len + 3) / 4) * 3 - padd;  // byte length
-    uint8_t data[blen];
+GHupdatePrint GH_update;
 
-    int val = 0, valb = -8, idx = 0;
-    for (uint16_t i = 0; i < len - padd; i++) {
-        uint8_t b = GH_b64i(str[i]);
-        val = (val << 6) + b;
-        valb += 6;
-        if (valb >= 0) {
-            data[idx++] = (uint8_t)((val >> valb) & 0xFF);
-            valb -= 8;
-        }
-    }
-    Update.write(data, blen);
+bool GH_B64toUpdate(const char* str, GHlz* lz, GHdelta* delta) {
+    uint8_t data[(strlen(str) + 3) / 4 * 3];
+    uint16_t len = _GH_b64decode(str, data);
+    Print& out = delta ? *(Print*)delta : GH_update;
+    bool ok = lz ? lz->decode(data, len, out) : (out.write(data, len) == len);
+    return ok && !(delta && delta->error());
 }
 #endif
 #endif
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "../config.hpp"
 #include "../macro.hpp"
 #include "utils/b64.h"
+#include "utils/delta.h"
+#include "utils/lz.h"
 
 #ifdef GH_ESP_BUILD
 #ifndef GH_NO_FS
@@ -52,17 +54,33 @@ struct GHparser {
 };
 
 char* GH_splitter(char* list, char div = ',');
+bool GH_glob(const char* pat, const char* str);
+bool GH_inList(const char* list, const char* str);
 String GH_uptime();
+
+// экранирование строки для JSON (внутри "")
 void GH_escapeChar(String* s, char c);
 void GH_escapeStr(String* s, VSPTR v, bool fstr);
 
 #ifdef GH_ESP_BUILD
 #ifndef GH_NO_FS
-void GH_showFiles(String& answ, const String& path, GH_UNUSED uint8_t levels = 0, uint16_t* count = nullptr);
-void GH_fileToB64(File& file, String& str);
-void GH_B64toFile(File& file, const char* str);
+void GH_fileToB64(File& file, String& str, GHlz* lz = nullptr);
+bool GH_B64toFile(File& file, const char* str, GHlz* lz = nullptr);
 #endif
 #ifndef GH_NO_OTA
-void GH_B64toUpdate(const char* str);
+// Print с записью в обновление
+class GHupdatePrint : public Print {
+   public:
+    size_t write(uint8_t c) {
+        return Update.write(&c, 1);
+    }
+    size_t write(const uint8_t* buf, size_t n) {
+        return Update.write((uint8_t*)buf, n);
+    }
+};
+extern GHupdatePrint GH_update;
+
+// base64 в обновление: распаковка lz и/или применение патча delta, если заданы
+bool GH_B64toUpdate(const char* str, GHlz* lz = nullptr, GHdelta* delta = nullptr);
 #endif
 #endif
\ No newline at end of file
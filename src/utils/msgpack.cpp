@@ -0,0 +1,278 @@
+#include "msgpack.h"
+
+#define GH_MP_DEPTH 16  // макс. вложенность
+
+struct GHmp {
+    const char* p;
+    String* out;
+};
+
+static bool _GH_mpValue(GHmp& s, uint8_t depth);
+
+static void _GH_mpByte(GHmp& s, uint8_t b) {
+    *s.out += (char)b;
+}
+
+// big-endian
+static void _GH_mpBE(GHmp& s, uint8_t code, uint64_t v, uint8_t len) {
+    _GH_mpByte(s, code);
+    while (len--) _GH_mpByte(s, v >> (len * 8));
+}
+
+// размер: fix-формат или 16/32 бит
+static void _GH_mpHead(GHmp& s, uint32_t n, uint8_t fix, uint8_t fixmax, uint8_t code8, uint8_t code16) {
+    if (n <= fixmax) _GH_mpByte(s, fix | n);
+    else if (code8 && n <= 0xff) _GH_mpBE(s, code8, n, 1);
+    else if (n <= 0xffff) _GH_mpBE(s, code16, n, 2);
+    else _GH_mpBE(s, code16 + 1, n, 4);
+}
+
+static void _GH_mpWs(GHmp& s) {
+    while (*s.p == ' ' || *s.p == '\n' || *s.p == '\r' || *s.p == '\t') s.p++;
+}
+
+static bool _GH_mpQuote(char c) {
+    return c == '\"';
+}
+
+// количество элементов в [] или {} после открывающей скобки
+static uint32_t _GH_mpCount(const char* p) {
+    while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') p++;
+    if (*p == ']' || *p == '}') return 0;
+    uint32_t n = 1;
+    uint8_t depth = 0;
+    for (; *p; p++) {
+        if (_GH_mpQuote(*p)) {
+            for (p++; *p && !_GH_mpQuote(*p); p++) {
+                if (*p == '\\' && p[1]) p++;
+            }
+            if (!*p) return 0;
+        } else if (*p == '[' || *p == '{') {
+            depth++;
+        } else if (*p == ']' || *p == '}') {
+            if (!depth) return n;
+            depth--;
+        } else if (*p == ',' && !depth) {
+            n++;
+        }
+    }
+    return 0;
+}
+
+static int8_t _GH_mpHex(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// \uXXXX -> код символа, p после XXXX
+static bool _GH_mpU16(const char*& p, uint32_t& code) {
+    code = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        int8_t h = _GH_mpHex(*p++);
+        if (h < 0) return 0;
+        code = (code << 4) | h;
+    }
+    return 1;
+}
+
+// разобрать экранирование после '\', вернёт символ (или UTF-8 в buf) и длину
+static uint8_t _GH_mpEscape(const char*& p, char* buf) {
+    char c = *p++;
+    switch (c) {
+        case 'n': buf[0] = '\n'; return 1;
+        case 'r': buf[0] = '\r'; return 1;
+        case 't': buf[0] = '\t'; return 1;
+        case 'b': buf[0] = '\b'; return 1;
+        case 'f': buf[0] = '\f'; return 1;
+        case '\\': buf[0] = '\\'; return 1;
+        case '/': buf[0] = '/'; return 1;
+        case '\"': buf[0] = '\"'; return 1;
+        case 'u': {
+            uint32_t code;
+            if (!_GH_mpU16(p, code)) return 0;
+            if (code >= 0xd800 && code < 0xdc00 && p[0] == '\\' && p[1] == 'u') {  // суррогатная пара
+                const char* q = p + 2;
+                uint32_t low;
+                if (_GH_mpU16(q, low) && low >= 0xdc00 && low < 0xe000) {
+                    code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                    p = q;
+                }
+            }
+            if (code < 0x80) {
+                buf[0] = code;
+                return 1;
+            }
+            if (code < 0x800) {
+                buf[0] = 0xc0 | (code >> 6);
+                buf[1] = 0x80 | (code & 0x3f);
+                return 2;
+            }
+            if (code < 0x10000) {
+                buf[0] = 0xe0 | (code >> 12);
+                buf[1] = 0x80 | ((code >> 6) & 0x3f);
+                buf[2] = 0x80 | (code & 0x3f);
+                return 3;
+            }
+            buf[0] = 0xf0 | (code >> 18);
+            buf[1] = 0x80 | ((code >> 12) & 0x3f);
+            buf[2] = 0x80 | ((code >> 6) & 0x3f);
+            buf[3] = 0x80 | (code & 0x3f);
+            return 4;
+        }
+    }
+    return 0;
+}
+
+// два прохода: длина после разэкранирования, затем запись кусками между '\'
+static bool _GH_mpString(GHmp& s) {
+    const char* p = ++s.p;
+    uint32_t len = 0;
+    char buf[4];
+    while (*p && !_GH_mpQuote(*p)) {
+        if (*p == '\\') {
+            p++;
+            uint8_t n = _GH_mpEscape(p, buf);
+            if (!n) return 0;
+            len += n;
+        } else {
+            p++;
+            len++;
+        }
+    }
+    if (!*p) return 0;
+    _GH_mpHead(s, len, 0xa0, 31, 0xd9, 0xda);
+
+    p = s.p;
+    while (!_GH_mpQuote(*p)) {
+        const char* from = p;
+        while (!_GH_mpQuote(*p) && *p != '\\') p++;
+        if (p != from) s.out->concat(from, p - from);
+        if (*p == '\\') {
+            p++;
+            s.out->concat(buf, _GH_mpEscape(p, buf));
+        }
+    }
+    s.p = p + 1;
+    return 1;
+}
+
+static void _GH_mpInt(GHmp& s, bool neg, uint64_t v) {
+    if (!neg) {
+        if (v < 0x80) _GH_mpByte(s, v);
+        else if (v <= 0xff) _GH_mpBE(s, 0xcc, v, 1);
+        else if (v <= 0xffff) _GH_mpBE(s, 0xcd, v, 2);
+        else if (v <= 0xffffffff) _GH_mpBE(s, 0xce, v, 4);
+        else _GH_mpBE(s, 0xcf, v, 8);
+    } else {
+        int64_t i = -(int64_t)v;
+        if (i >= -32) _GH_mpByte(s, i);
+        else if (i >= -128) _GH_mpBE(s, 0xd0, i, 1);
+        else if (i >= -32768) _GH_mpBE(s, 0xd1, i, 2);
+        else if (i >= INT32_MIN) _GH_mpBE(s, 0xd2, i, 4);
+        else _GH_mpBE(s, 0xd3, i, 8);
+    }
+}
+
+static void _GH_mpReal(GHmp& s, double d) {
+    float f = d;
+    if (d >= INT32_MIN && d <= INT32_MAX && d == (int32_t)d && !(d == 0 && signbit(d))) {  // 100.00 -> 100, как в JSON.parse
+        int32_t i = d;
+        _GH_mpInt(s, i < 0, i < 0 ? -(int64_t)i : i);
+    } else if ((double)f == d) {
+        uint32_t bits;
+        memcpy(&bits, &f, 4);
+        _GH_mpBE(s, 0xca, bits, 4);
+    } else {
+        uint64_t bits;
+        memcpy(&bits, &d, 8);
+        _GH_mpBE(s, 0xcb, bits, 8);
+    }
+}
+
+static bool _GH_mpNumber(GHmp& s) {
+    const char* p = s.p;
+    bool neg = (*p == '-');
+    if (neg) p++;
+    if (*p < '0' || *p > '9') return 0;
+    uint64_t v = 0;
+    uint8_t digits = 0;
+    while (*p >= '0' && *p <= '9') {
+        v = v * 10 + (*p++ - '0');
+        digits++;
+    }
+    bool real = (digits > 18);
+    if (*p == '.') {
+        real = 1;
+        p++;
+        if (*p < '0' || *p > '9') return 0;
+        while (*p >= '0' && *p <= '9') p++;
+    }
+    if (*p == 'e' || *p == 'E') {
+        real = 1;
+        p++;
+        if (*p == '+' || *p == '-') p++;
+        if (*p < '0' || *p > '9') return 0;
+        while (*p >= '0' && *p <= '9') p++;
+    }
+
+    if (real) _GH_mpReal(s, strtod(s.p, nullptr));
+    else _GH_mpInt(s, neg, v);
+    s.p = p;
+    return 1;
+}
+
+static bool _GH_mpWord(GHmp& s, PGM_P word, uint8_t code) {
+    uint8_t len = strlen_P(word);
+    if (strncmp_P(s.p, word, len)) return 0;
+    s.p += len;
+    _GH_mpByte(s, code);
+    return 1;
+}
+
+// массив или объект: элементы через запятую, в объекте ключ:значение
+static bool _GH_mpList(GHmp& s, uint8_t depth, bool obj) {
+    uint32_t n = _GH_mpCount(++s.p);
+    if (obj) _GH_mpHead(s, n, 0x80, 15, 0, 0xde);
+    else _GH_mpHead(s, n, 0x90, 15, 0, 0xdc);
+    for (uint32_t i = 0; i < n; i++) {
+        if (i) {
+            _GH_mpWs(s);
+            if (*s.p++ != ',') return 0;
+        }
+        if (obj) {
+            _GH_mpWs(s);
+            if (!_GH_mpQuote(*s.p) || !_GH_mpString(s)) return 0;
+            _GH_mpWs(s);
+            if (*s.p++ != ':') return 0;
+        }
+        if (!_GH_mpValue(s, depth + 1)) return 0;
+    }
+    _GH_mpWs(s);
+    return *s.p++ == (obj ? '}' : ']');
+}
+
+static bool _GH_mpValue(GHmp& s, uint8_t depth) {
+    if (depth > GH_MP_DEPTH) return 0;
+    _GH_mpWs(s);
+    char c = *s.p;
+    if (c == '{' || c == '[') return _GH_mpList(s, depth, c == '{');
+    if (_GH_mpQuote(c)) return _GH_mpString(s);
+    if (c == 't') return _GH_mpWord(s, PSTR("true"), 0xc3);
+    if (c == 'f') return _GH_mpWord(s, PSTR("false"), 0xc2);
+    if (c == 'n') return _GH_mpWord(s, PSTR("null"), 0xc0);
+    return _GH_mpNumber(s);
+}
+
+bool GH_toMsgpack(const String& text, String& out) {
+    uint32_t start = out.length();
+    out.reserve(start + text.length());
+    GHmp s{text.c_str(), &out};
+    if (_GH_mpValue(s, 0)) {
+        _GH_mpWs(s);
+        if (!*s.p) return 1;
+    }
+    out.remove(start);
+    return 0;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <Arduino.h>
+
+#include "../config.hpp"
+
+// Перевод пакета (JSON, как его собирает билдер) в MessagePack.
+// Результат - та же модель данных, что даёт JSON.parse в приложении: объекты, массивы,
+// строки (экранирование \" \\ \n \r \t \/ \uXXXX), целые, float32/float64, true/false/null.
+// Бинарные данные хранятся в String, отправлять по length()
+
+// false - пакет не разобран, out не изменён (отправлять как текст)
+bool GH_toMsgpack(const String& text, String& out);
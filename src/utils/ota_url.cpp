@@ -0,0 +1,222 @@
+#include "ota_url.h"
+
+#if defined(GH_ESP_BUILD) && !defined(GH_NO_FS) && !defined(GH_NO_OTA) && !defined(GH_NO_OTA_URL)
+
+#define GH_OTAU_RETRY_DELAY 1000  // пауза перед докачкой, мс
+#define GH_OTAU_REDIRECTS 5       // макс. переадресаций
+#define GH_OTAU_LINE 256          // макс. длина строки заголовка
+
+bool GHotaUrl::begin(const String& nurl, bool nfs) {
+    abort();
+    if (!nurl.startsWith(F("http://")) && !nurl.startsWith(F("https://"))) return 0;
+    url = nurl;
+    fs = nfs;
+    got = total = 0;
+    tries = redirects = 0;
+    state = S_CONNECT;
+    return 1;
+}
+
+void GHotaUrl::abort() {
+    _close();
+    if (upd) Update.end();
+    upd = 0;
+    state = S_IDLE;
+}
+
+GHotaUrl::Status GHotaUrl::tick() {
+    switch (state) {
+        case S_CONNECT:
+            return _connect();
+        case S_HEAD:
+            return _head();
+        case S_BODY:
+            return _body();
+        case S_WAIT:
+            if (millis() - tmr >= GH_OTAU_RETRY_DELAY) state = S_CONNECT;
+            return GH_OTAU_RUN;
+        default:
+            return GH_OTAU_ERR;
+    }
+}
+
+// подключение и TLS рукопожатие блокируют на время до GH_CONN_TOUT
+GHotaUrl::Status GHotaUrl::_connect() {
+    bool https = url.startsWith(F("https"));
+    int hstart = url.indexOf(F("://")) + 3;
+    int pstart = url.indexOf('/', hstart);
+    if (pstart < 0) pstart = url.length();
+    String host = url.substring(hstart, pstart);
+    String path = (pstart < (int)url.length()) ? url.substring(pstart) : String('/');
+    uint16_t port = https ? 443 : 80;
+    int colon = host.indexOf(':');
+    if (colon >= 0) {
+        port = host.substring(colon + 1).toInt();
+        host.remove(colon);
+    }
+
+    if (https) {
+#ifdef ESP8266
+        BearSSL::WiFiClientSecure* sec = new BearSSL::WiFiClientSecure;
+#else
+        WiFiClientSecure* sec = new WiFiClientSecure;
+#endif
+        if (sec) sec->setInsecure();
+        cli = sec;
+    } else {
+        cli = new WiFiClient;
+    }
+    if (!cli) return _error();
+    cli->setTimeout(GH_CONN_TOUT * 1000ul);
+    if (!cli->connect(host.c_str(), port)) return _retry();
+
+    String req(F("GET "));
+    req += path;
+    req += F(" HTTP/1.1\r\nHost: ");
+    req += host;
+    req += F("\r\nUser-Agent: GyverHub\r\nConnection: close\r\n");
+    if (got) {
+        req += F("Range: bytes=");
+        req += got;
+        req += F("-\r\n");
+    }
+    req += F("\r\n");
+    cli->print(req);
+
+    line = "";
+    location = "";
+    code = 0;
+    clen = rstart = -1;
+    chunked = 0;
+    tmr = millis();
+    state = S_HEAD;
+    return GH_OTAU_RUN;
+}
+
+GHotaUrl::Status GHotaUrl::_head() {
+    for (uint16_t n = 0; n < 512 && cli->available(); n++) {
+        int c = cli->read();
+        if (c < 0) break;
+        if (c == '\r') continue;
+        if (c != '\n') {
+            if (line.length() < GH_OTAU_LINE) line += (char)c;
+            continue;
+        }
+        if (!line.length()) return _headersDone();
+        _header(line);
+        line = "";
+        tmr = millis();
+    }
+    if (!cli->connected() && !cli->available()) return _retry();
+    if (millis() - tmr >= GH_CONN_TOUT * 1000ul) return _retry();
+    return GH_OTAU_RUN;
+}
+
+void GHotaUrl::_header(const String& ln) {
+    if (!code) {  // HTTP/1.1 200 OK
+        int sp = ln.indexOf(' ');
+        if (sp > 0) code = ln.substring(sp + 1).toInt();
+        return;
+    }
+    int colon = ln.indexOf(':');
+    if (colon < 0) return;
+    String key = ln.substring(0, colon);
+    String val = ln.substring(colon + 1);
+    val.trim();
+    if (key.equalsIgnoreCase(F("Content-Length"))) clen = val.toInt();
+    else if (key.equalsIgnoreCase(F("Location"))) location = val;
+    else if (key.equalsIgnoreCase(F("Transfer-Encoding"))) chunked = val.equalsIgnoreCase(F("chunked"));
+    else if (key.equalsIgnoreCase(F("Content-Range"))) {  // bytes 100-999/1000
+        int sp = val.indexOf(' ');
+        if (sp > 0) rstart = val.substring(sp + 1).toInt();
+    }
+}
+
+GHotaUrl::Status GHotaUrl::_headersDone() {
+    if (code >= 300 && code < 400 && location.length()) {
+        if (++redirects > GH_OTAU_REDIRECTS) return _error();
+        if (location.startsWith(F("/"))) {  // относительный адрес - на тот же хост
+            int pstart = url.indexOf('/', url.indexOf(F("://")) + 3);
+            if (pstart > 0) url.remove(pstart);
+            url += location;
+        } else {
+            url = location;
+        }
+        _close();
+        state = S_CONNECT;
+        return GH_OTAU_RUN;
+    }
+    if (chunked) return _error();
+
+    if (!got) {
+        if (code != 200 || clen <= 0) return _error();
+        total = clen;
+        int type = U_FLASH;
+        if (fs) {
+#ifdef ESP8266
+            type = U_FS;
+            close_all_fs();
+#else
+            type = U_SPIFFS;
+#endif
+        }
+        if (!Update.begin(total, type)) return _error();
+        upd = 1;
+    } else if (code != 206 || rstart != (int32_t)got) {
+        return _error();  // сервер не поддерживает докачку
+    }
+    tmr = millis();
+    state = S_BODY;
+    return GH_OTAU_RUN;
+}
+
+GHotaUrl::Status GHotaUrl::_body() {
+    uint8_t buf[512];
+    uint16_t n = 0;
+    while (n < GH_OTA_URL_TICK && got < total) {
+        int av = cli->available();
+        if (av <= 0) break;
+        size_t len = min((size_t)av, sizeof(buf));
+        len = min(len, (size_t)(total - got));
+        int r = cli->read(buf, len);
+        if (r <= 0) break;
+        if (Update.write(buf, r) != (size_t)r) return _error();
+        got += r;
+        n += r;
+    }
+    if (got >= total) {
+        _close();
+        upd = 0;
+        state = S_IDLE;
+        return Update.end(true) ? GH_OTAU_DONE : GH_OTAU_ERR;
+    }
+    if (n) {
+        tmr = millis();
+        tries = 0;
+        return GH_OTAU_CHUNK;
+    }
+    if (!cli->connected() || millis() - tmr >= GH_CONN_TOUT * 1000ul) return _retry();
+    return GH_OTAU_RUN;
+}
+
+GHotaUrl::Status GHotaUrl::_retry() {
+    _close();
+    if (++tries > GH_OTA_URL_RETRY) return _error();
+    tmr = millis();
+    state = S_WAIT;
+    return GH_OTAU_RUN;
+}
+
+GHotaUrl::Status GHotaUrl::_error() {
+    abort();
+    return GH_OTAU_ERR;
+}
+
+void GHotaUrl::_close() {
+    if (!cli) return;
+    cli->stop();
+    delete cli;
+    cli = nullptr;
+}
+
+#endif
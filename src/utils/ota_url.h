@@ -0,0 +1,90 @@
+#pragma once
+#include <Arduino.h>
+
+#include "../config.hpp"
+#include "../macro.hpp"
+
+#if defined(GH_ESP_BUILD) && !defined(GH_NO_FS) && !defined(GH_NO_OTA) && !defined(GH_NO_OTA_URL)
+#ifdef ESP8266
+#include <ESP8266WiFi.h>
+#include <Updater.h>
+#else
+#include <Update.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#endif
+
+// OTA по URL без блокировки: HTTP(S) загрузка порциями в tick() с докачкой через Range после обрыва
+class GHotaUrl {
+   public:
+    enum Status {
+        GH_OTAU_RUN,    // в процессе
+        GH_OTAU_CHUNK,  // записана порция
+        GH_OTAU_DONE,   // обновление записано
+        GH_OTAU_ERR,    // ошибка
+    };
+
+    ~GHotaUrl() {
+        abort();
+    }
+
+    // начать загрузку прошивки (fs = 0) или файловой системы (fs = 1)
+    bool begin(const String& url, bool fs);
+
+    // обработать порцию данных
+    Status tick();
+
+    // прервать
+    void abort();
+
+    // идёт загрузка
+    bool running() {
+        return state != S_IDLE;
+    }
+
+    // получено байт
+    uint32_t received() {
+        return got;
+    }
+
+    // размер образа, 0 - ещё неизвестен
+    uint32_t size() {
+        return total;
+    }
+
+   private:
+    enum State {
+        S_IDLE,
+        S_CONNECT,
+        S_HEAD,
+        S_BODY,
+        S_WAIT,
+    };
+
+    Status _connect();
+    Status _head();
+    Status _headersDone();
+    Status _body();
+    Status _retry();
+    Status _error();
+    void _header(const String& line);
+    void _close();
+
+    String url;
+    String line;
+    String location;
+    WiFiClient* cli = nullptr;
+    State state = S_IDLE;
+    bool fs = 0;
+    bool upd = 0;
+    bool chunked = 0;
+    uint8_t tries = 0;
+    uint8_t redirects = 0;
+    uint16_t code = 0;
+    int32_t clen = -1;
+    int32_t rstart = -1;
+    uint32_t got = 0;
+    uint32_t total = 0;
+    uint32_t tmr = 0;
+};
+#endif
@@ -0,0 +1,259 @@
+#pragma once
+#include <Arduino.h>
+
+// прореживание ряда для графика
+#define GH_SERIES_LTTB 0    // Largest-Triangle-Three-Buckets: по точке на столбец, форма кривой
+#define GH_SERIES_MINMAX 1  // минимум и максимум каждого столбца: не теряет пики
+
+// ====================== SERIES =======================
+// база временного ряда: кольцевой буфер меток времени и вывод точек "t,v;t,v"
+class GHseriesBase {
+   public:
+    virtual ~GHseriesBase() {}
+
+    // количество точек
+    uint16_t length() {
+        return len;
+    }
+
+    // размер буфера
+    uint16_t capacity() {
+        return cap;
+    }
+
+    // запущен
+    bool state() {
+        return cap;
+    }
+
+    // очистить
+    void clear() {
+        len = head = 0;
+        sent = sent_get = count;
+    }
+
+    // метка времени точки i (0 - самая старая)
+    uint32_t time(uint16_t i) {
+        return times[_idx(i)];
+    }
+
+    // значение точки i как float
+    virtual float valueF(uint16_t i) = 0;
+
+    // всего добавлено точек
+    uint32_t written() {
+        return count;
+    }
+
+    // вывести точки, прореженные до ширины графика width (столбцов экрана, 0 - все точки) способом mode:
+    // GH_SERIES_LTTB - не больше width точек, GH_SERIES_MINMAX - не больше 2 * width точек
+    void read(String* s, uint16_t width = 0, uint8_t mode = GH_SERIES_LTTB) {
+        if (!len) return;
+        uint16_t points = (mode == GH_SERIES_MINMAX) ? min(width, (uint16_t)(0xffff / 2)) * 2 : width;
+        if (!width || points >= len || width < 3) {
+            s->reserve(s->length() + len * 12);
+            for (uint16_t i = 0; i < len; i++) _point(s, i);
+            return;
+        }
+        s->reserve(s->length() + points * 12);
+        if (mode == GH_SERIES_MINMAX) _minmax(s, width);
+        else _lttb(s, width);
+    }
+
+    // вывести точки, добавленные после позиции seq. Вернёт новую позицию
+    uint32_t readSince(String* s, uint32_t seq) {
+        uint32_t amount = min(count - seq, (uint32_t)len);
+        for (uint16_t i = len - amount; i < len; i++) _point(s, i);
+        return count;
+    }
+
+    // позиция, до которой ряд отправлен через Chart: в update (получают все подключения) и на get-топик MQTT.
+    // Курсоры раздельные, иначе sendGet забирает точки, предназначенные графику в приложении
+    uint32_t sent = 0;
+    uint32_t sent_get = 0;
+
+   protected:
+    bool _begin(uint16_t n) {
+        times = (uint32_t*)malloc(n * sizeof(uint32_t));
+        if (!times) return 0;
+        cap = n;
+        len = head = 0;
+        count = sent = sent_get = 0;
+        return 1;
+    }
+    void _end() {
+        if (times) free(times);
+        times = nullptr;
+        cap = len = head = 0;
+    }
+
+    // занять место под новую точку, вернуть индекс в буфере
+    uint16_t _push(uint32_t t) {
+        uint16_t i = head;
+        times[i] = t;
+        if (++head >= cap) head = 0;
+        if (len < cap) len++;
+        count++;
+        return i;
+    }
+
+    uint16_t _idx(uint16_t i) {
+        int idx = head - len + i;
+        if (idx < 0) idx += cap;
+        return idx;
+    }
+
+    virtual void _printValue(String* s, uint16_t i) = 0;
+
+    // Largest-Triangle-Three-Buckets: первая и последняя точки + по одной из каждой корзины
+    void _lttb(String* s, uint16_t points) {
+        float every = (float)(len - 2) / (points - 2);
+        uint32_t t0 = time(0);
+        uint16_t a = 0;
+        _point(s, 0);
+        for (uint16_t b = 0; b < points - 2; b++) {
+            uint16_t from = (uint16_t)(b * every) + 1;
+            uint16_t to = (uint16_t)((b + 1) * every) + 1;
+            uint16_t nfrom = to;
+            uint16_t nto = min((uint16_t)((b + 2) * every) + 1, (int)len);
+
+            float avgt = 0, avgv = 0;
+            for (uint16_t j = nfrom; j < nto; j++) {
+                avgt += time(j) - t0;
+                avgv += valueF(j);
+            }
+            if (nto > nfrom) {
+                avgt /= nto - nfrom;
+                avgv /= nto - nfrom;
+            } else {
+                avgt = time(len - 1) - t0;
+                avgv = valueF(len - 1);
+            }
+
+            float at = time(a) - t0, av = valueF(a);
+            float amax = -1;
+            uint16_t next = from;
+            for (uint16_t j = from; j < to; j++) {
+                float area = fabs((at - avgt) * (valueF(j) - av) - (at - (time(j) - t0)) * (avgv - av));
+                if (area > amax) {
+                    amax = area;
+                    next = j;
+                }
+            }
+            _point(s, next);
+            a = next;
+        }
+        _point(s, len - 1);
+    }
+
+    // по столбцу экрана на корзину, из корзины - минимум и максимум в порядке времени: пики не теряются
+    void _minmax(String* s, uint16_t width) {
+        for (uint16_t b = 0; b < width; b++) {
+            uint16_t from = (uint32_t)b * len / width;
+            uint16_t to = (uint32_t)(b + 1) * len / width;
+            if (from >= to) continue;
+            uint16_t imin = from, imax = from;
+            for (uint16_t j = from + 1; j < to; j++) {
+                float v = valueF(j);
+                if (v < valueF(imin)) imin = j;
+                if (v > valueF(imax)) imax = j;
+            }
+            _point(s, min(imin, imax));
+            if (imin != imax) _point(s, max(imin, imax));
+        }
+    }
+
+    void _point(String* s, uint16_t i) {
+        *s += time(i);
+        *s += ',';
+        _printValue(s, i);
+        *s += ';';
+    }
+
+    uint32_t* times = nullptr;
+    uint16_t cap = 0;
+    uint16_t len = 0;
+    uint16_t head = 0;
+    uint32_t count = 0;
+};
+
+// временной ряд значений типа T (int16_t, float...) с метками времени
+template <typename T>
+class GHseries : public GHseriesBase {
+   public:
+    GHseries() {}
+    GHseries(uint16_t n) {
+        begin(n);
+    }
+    ~GHseries() {
+        end();
+    }
+
+    // начать и указать количество точек
+    bool begin(uint16_t n) {
+        end();
+        if (!n) return 0;
+        values = (T*)malloc(n * sizeof(T));
+        if (!values) return 0;
+        if (!_begin(n)) {
+            end();
+            return 0;
+        }
+        return 1;
+    }
+
+    // остановить
+    void end() {
+        if (values) free(values);
+        values = nullptr;
+        _end();
+    }
+
+    // добавить значение с меткой времени (умолч. millis())
+    void add(T value) {
+        add(value, millis());
+    }
+    void add(T value, uint32_t t) {
+        if (!values) return;
+        values[_push(t)] = value;
+    }
+
+    // значение точки i (0 - самая старая)
+    T get(uint16_t i) {
+        return values[_idx(i)];
+    }
+
+    // последнее значение
+    T last() {
+        return len ? get(len - 1) : T();
+    }
+
+    // минимальное значение
+    T getMin() {
+        T v = last();
+        for (uint16_t i = 0; i < len; i++) {
+            if (get(i) < v) v = get(i);
+        }
+        return v;
+    }
+
+    // максимальное значение
+    T getMax() {
+        T v = last();
+        for (uint16_t i = 0; i < len; i++) {
+            if (get(i) > v) v = get(i);
+        }
+        return v;
+    }
+
+    virtual float valueF(uint16_t i) {
+        return get(i);
+    }
+
+   protected:
+    virtual void _printValue(String* s, uint16_t i) {
+        *s += get(i);
+    }
+
+    T* values = nullptr;
+};
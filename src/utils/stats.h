@@ -70,4 +70,7 @@ enum GHevent_t {
     GH_OTA_FINISH,
 
     GH_OTA_URL,
+    GH_OTA_URL_CHUNK,
+    GH_OTA_URL_ERROR,
+    GH_OTA_URL_FINISH,
 };
\ No newline at end of file
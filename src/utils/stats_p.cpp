@@ -79,7 +79,10 @@ GH_PGM(_GH_STA36, "OTA_ERROR");
 GH_PGM(_GH_STA37, "OTA_ABORTED");
 GH_PGM(_GH_STA38, "OTA_FINISH");
 GH_PGM(_GH_STA39, "OTA_URL");
-GH_PGM_LIST(_GH_sta_list, _GH_STA0, _GH_STA1, _GH_STA2, _GH_STA3, _GH_STA4, _GH_STA5, _GH_STA6, _GH_STA7, _GH_STA8, _GH_STA9, _GH_STA10, _GH_STA11, _GH_STA12, _GH_STA13, _GH_STA14, _GH_STA15, _GH_STA16, _GH_STA17, _GH_STA18, _GH_STA19, _GH_STA20, _GH_STA21, _GH_STA22, _GH_STA23, _GH_STA24, _GH_STA25, _GH_STA26, _GH_STA27, _GH_STA28, _GH_STA29, _GH_STA30, _GH_STA31, _GH_STA32, _GH_STA33, _GH_STA34, _GH_STA35, _GH_STA36, _GH_STA37, _GH_STA38, _GH_STA39);
+GH_PGM(_GH_STA40, "OTA_URL_CHUNK");
+GH_PGM(_GH_STA41, "OTA_URL_ERROR");
+GH_PGM(_GH_STA42, "OTA_URL_FINISH");
+GH_PGM_LIST(_GH_sta_list, _GH_STA0, _GH_STA1, _GH_STA2, _GH_STA3, _GH_STA4, _GH_STA5, _GH_STA6, _GH_STA7, _GH_STA8, _GH_STA9, _GH_STA10, _GH_STA11, _GH_STA12, _GH_STA13, _GH_STA14, _GH_STA15, _GH_STA16, _GH_STA17, _GH_STA18, _GH_STA19, _GH_STA20, _GH_STA21, _GH_STA22, _GH_STA23, _GH_STA24, _GH_STA25, _GH_STA26, _GH_STA27, _GH_STA28, _GH_STA29, _GH_STA30, _GH_STA31, _GH_STA32, _GH_STA33, _GH_STA34, _GH_STA35, _GH_STA36, _GH_STA37, _GH_STA38, _GH_STA39, _GH_STA40, _GH_STA41, _GH_STA42);
 FSTR GHreadEvent(GHevent_t n) {
     return (FSTR)_GH_sta_list[n];
 }
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+#include <Arduino.h>
+
+#include "../macro.hpp"
+#include "misc.h"
+
+// Вид строки имени/подписи компонента, выбирается при компиляции вместо флага fstr:
+// GHpgm - F() или PSTR() во flash, GHram - строка в RAM. Ветвления по виду строки в билдере нет
+
+struct GHpgm {
+    static const bool fstr = true;
+
+    // str совпадает с name
+    static bool eq(const char* name, VSPTR str) {
+        return !strcmp_P(name, (PGM_P)str);
+    }
+
+    // пустая строка или nullptr
+    static bool empty(VSPTR str) {
+        return !str || !pgm_read_byte((PGM_P)str);
+    }
+
+    static void add(String* s, VSPTR str) {
+        *s += (FSTR)str;
+    }
+
+    // экранировать для JSON посимвольно, без копии во временный буфер
+    static void escape(String* s, VSPTR str) {
+        PGM_P p = (PGM_P)str;
+        while (char c = pgm_read_byte(p++)) GH_escapeChar(s, c);
+    }
+};
+
+struct GHram {
+    static const bool fstr = false;
+
+    static bool eq(const char* name, VSPTR str) {
+        return !strcmp(name, (const char*)str);
+    }
+
+    static bool empty(VSPTR str) {
+        return !str || !*(const char*)str;
+    }
+
+    static void add(String* s, VSPTR str) {
+        *s += (const char*)str;
+    }
+
+    static void escape(String* s, VSPTR str) {
+        const char* p = (const char*)str;
+        while (char c = *p++) GH_escapeChar(s, c);
+    }
+};
@@ -0,0 +1,148 @@
+#include "wheel.h"
+
+// Таймер на уровне L лежит в слоте (at >> 5L) & 31, если старший отличающийся от cur
+// 5-битный разряд срока - L. Тогда все занятые слоты уровня лежат впереди cur, и время
+// до следующего события - начало ближайшего занятого слота по битовой маске уровня.
+
+// номера младшего и старшего единичного бита (x != 0). Версии для long: на AVR int 16-битный
+static inline uint8_t _lowBit(uint32_t x) {
+    return __builtin_ctzl(x);
+}
+static inline uint8_t _highBit(uint32_t x) {
+    return 8 * sizeof(long) - 1 - __builtin_clzl(x);
+}
+
+void GHwheel::start(GHwheelTimer& t, uint32_t ms, bool periodic) {
+    t.stop();
+    _advance(millis());
+    t.at = cur + ms;
+    t.prd = periodic ? ms : 0;
+    _insert(&t);
+}
+
+GHwheel::~GHwheel() {
+    // таймеры могут пережить колесо (например, в базовых классах) - отвязываем их
+    for (uint8_t l = 0; l < GH_WHEEL_LEVELS; l++) {
+        for (uint8_t i = 0; i < GH_WHEEL_SLOTS; i++) _detach(slots[l][i]);
+    }
+    _detach(far);
+    _detach(due);
+}
+
+void GHwheel::tick() {
+    _advance(millis());
+    if (!due) return;
+
+    // истёкшие переносятся в локальный список: перезапуск из обработчика сработает в следующем tick
+    GHwheelTimer* run = due;
+    due = nullptr;
+    run->pprev = &run;
+    while (run) {
+        GHwheelTimer* t = run;
+        t->stop();
+        if (t->prd) {
+            t->at += t->prd;
+            if ((int32_t)(t->at - cur) <= 0) t->at = cur + t->prd;  // пропущенные периоды не догоняем
+            _insert(t);
+        }
+        if (t->cb) t->cb(t->arg);
+    }
+}
+
+uint32_t GHwheel::nextDeadline() {
+    _advance(millis());
+    if (due) return 0;
+    uint32_t best = UINT32_MAX;
+    for (uint8_t l = 0; l < GH_WHEEL_LEVELS; l++) {
+        for (uint32_t m = mask[l]; m; m &= m - 1) {
+            GHwheelTimer* t = slots[l][_lowBit(m)];
+            if (!t) continue;  // слот опустел после stop()
+            for (; t; t = t->next) {
+                if (t->at - cur < best) best = t->at - cur;
+            }
+            break;
+        }
+    }
+    for (GHwheelTimer* t = far; t; t = t->next) {
+        if (t->at - cur < best) best = t->at - cur;
+    }
+    return best;
+}
+
+void GHwheel::_advance(uint32_t now) {
+    while (cur != now) {
+        uint32_t step = _nextStep();
+        if (step > now - cur) {
+            cur = now;
+            break;
+        }
+        cur += step;
+        _collect();
+    }
+}
+
+uint32_t GHwheel::_nextStep() {
+    uint32_t step = UINT32_MAX;
+    for (uint8_t l = 0; l < GH_WHEEL_LEVELS; l++) {
+        if (!mask[l]) continue;
+        uint8_t shift = l * GH_WHEEL_BITS;
+        uint32_t base = cur & ~(uint32_t)((1ul << (shift + GH_WHEEL_BITS)) - 1);
+        uint32_t start = base | ((uint32_t)_lowBit(mask[l]) << shift);
+        if (start - cur < step) step = start - cur;
+    }
+    if (far) {
+        uint32_t start = (cur | (uint32_t)((1ul << GH_WHEEL_SPAN) - 1)) + 1;
+        if (start - cur < step) step = start - cur;
+    }
+    return step;
+}
+
+void GHwheel::_collect() {
+    if (!(cur & ((1ul << GH_WHEEL_SPAN) - 1))) _reinsert(far);
+    for (uint8_t l = GH_WHEEL_LEVELS - 1; l; l--) {
+        uint8_t shift = l * GH_WHEEL_BITS;
+        if (cur & ((1ul << shift) - 1)) continue;
+        uint8_t idx = (cur >> shift) & (GH_WHEEL_SLOTS - 1);
+        if (!(mask[l] & (1ul << idx))) continue;
+        mask[l] &= ~(1ul << idx);
+        _reinsert(slots[l][idx]);
+    }
+    uint8_t idx = cur & (GH_WHEEL_SLOTS - 1);
+    if (mask[0] & (1ul << idx)) {
+        mask[0] &= ~(1ul << idx);
+        _reinsert(slots[0][idx]);
+    }
+}
+
+void GHwheel::_insert(GHwheelTimer* t) {
+    if ((int32_t)(t->at - cur) <= 0) return _link(due, t);
+    uint32_t diff = t->at ^ cur;
+    if (diff >> GH_WHEEL_SPAN) return _link(far, t);
+    uint8_t l = _highBit(diff) / GH_WHEEL_BITS;
+    uint8_t idx = (t->at >> (l * GH_WHEEL_BITS)) & (GH_WHEEL_SLOTS - 1);
+    mask[l] |= 1ul << idx;
+    _link(slots[l][idx], t);
+}
+
+void GHwheel::_detach(GHwheelTimer*& list) {
+    while (list) list->stop();
+}
+
+void GHwheel::_reinsert(GHwheelTimer*& list) {
+    GHwheelTimer* t = list;
+    list = nullptr;
+    while (t) {
+        GHwheelTimer* next = t->next;
+        t->next = nullptr;
+        t->pprev = nullptr;
+        _insert(t);
+        t = next;
+    }
+}
+
+void GHwheel::_link(GHwheelTimer*& head, GHwheelTimer* t) {
+    t->next = head;
+    if (head) head->pprev = &t->next;
+    head = t;
+    t->pprev = &head;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <Arduino.h>
+
+// иерархическое колесо таймеров: 4 уровня по 32 слота (горизонт 2^20 мс ~ 17 мин), дальше - отдельный список
+#define GH_WHEEL_BITS 5
+#define GH_WHEEL_SLOTS (1 << GH_WHEEL_BITS)
+#define GH_WHEEL_LEVELS 4
+#define GH_WHEEL_SPAN (GH_WHEEL_BITS * GH_WHEEL_LEVELS)
+
+// таймер для GHwheel. По сроку вызывает cb(arg), если задан. Срок и период - до 2^31 мс
+struct GHwheelTimer {
+    GHwheelTimer() {}
+    GHwheelTimer(void (*ncb)(void* arg), void* narg = nullptr) : cb(ncb), arg(narg) {}
+    GHwheelTimer(const GHwheelTimer&) = delete;
+    GHwheelTimer& operator=(const GHwheelTimer&) = delete;
+    ~GHwheelTimer() {
+        stop();
+    }
+
+    // подключить обработчик
+    void attach(void (*ncb)(void* arg), void* narg = nullptr) {
+        cb = ncb;
+        arg = narg;
+    }
+
+    // остановить
+    void stop() {
+        if (!pprev) return;
+        *pprev = next;
+        if (next) next->pprev = pprev;
+        next = nullptr;
+        pprev = nullptr;
+    }
+
+    // запущен и ещё не сработал
+    bool active() const {
+        return pprev;
+    }
+
+    void (*cb)(void* arg) = nullptr;
+    void* arg = nullptr;
+    uint32_t at = 0;   // срок, millis()
+    uint32_t prd = 0;  // период, 0 - однократный
+
+    GHwheelTimer* next = nullptr;
+    GHwheelTimer** pprev = nullptr;
+};
+
+class GHwheel {
+   public:
+    GHwheel() {}
+    GHwheel(const GHwheel&) = delete;
+    GHwheel& operator=(const GHwheel&) = delete;
+    ~GHwheel();
+
+    // запустить таймер через ms мс. periodic - перезапускать с тем же периодом
+    void start(GHwheelTimer& t, uint32_t ms, bool periodic = false);
+
+    // выполнить истёкшие таймеры. Стоимость - по числу истёкших таймеров и непустых слотов
+    void tick();
+
+    // мс до ближайшего срока. 0 - есть истёкшие, UINT32_MAX - таймеров нет
+    uint32_t nextDeadline();
+
+   private:
+    void _advance(uint32_t now);
+    uint32_t _nextStep();
+    void _collect();
+    void _insert(GHwheelTimer* t);
+    void _reinsert(GHwheelTimer*& list);
+    void _detach(GHwheelTimer*& list);
+    static void _link(GHwheelTimer*& head, GHwheelTimer* t);
+
+    GHwheelTimer* slots[GH_WHEEL_LEVELS][GH_WHEEL_SLOTS] = {};
+    uint32_t mask[GH_WHEEL_LEVELS] = {};
+    GHwheelTimer* far = nullptr;
+    GHwheelTimer* due = nullptr;
+    uint32_t cur = 0;
+};
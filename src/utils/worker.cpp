@@ -0,0 +1,171 @@
+#include "worker.h"
+
+#ifdef GH_WORKER_BUILD
+
+// ========================== PUBLIC ==========================
+bool GHworker::begin(GHjobHandler nwork, GHjobHandler nout, void* narg) {
+    if (run_f) return 1;
+    work_cb = nwork;
+    out_cb = nout;
+    arg = narg;
+    head = work = tail = 0;
+    stop_f = 0;
+#ifdef ESP32
+    if (!wake_s) wake_s = xSemaphoreCreateBinary();
+    if (!done_s) done_s = xSemaphoreCreateBinary();
+    if (!wake_s || !done_s) return 0;
+    exit_f = 0;
+#if portNUM_PROCESSORS > 1
+    BaseType_t core = xPortGetCoreID() ? 0 : 1;  // ядро, свободное от loop
+#else
+    BaseType_t core = tskNO_AFFINITY;
+#endif
+    if (xTaskCreatePinnedToCore(_task, "gh_worker", GH_WORKER_STACK, this, 1, nullptr, core) != pdPASS) return 0;
+#else
+    wake_f = done_f = 0;
+    thread = std::thread(&GHworker::_run, this);
+#endif
+    run_f = 1;
+    return 1;
+}
+
+void GHworker::end() {
+    if (!run_f) return;
+    _lock();
+    stop_f = 1;
+    _unlock();
+    _wake();
+#ifdef ESP32
+    while (!exit_f) _waitDone();
+#else
+    thread.join();
+#endif
+    run_f = 0;
+    flush();
+}
+
+GHjob* GHworker::claim() {
+    _lock();
+    bool full = (_next(head) == tail);
+    _unlock();
+    if (full) {  // освободить отправкой обработанных
+        flush();
+        _lock();
+        full = (_next(head) == tail);
+        _unlock();
+    }
+    if (full) {
+        drops++;
+        return nullptr;
+    }
+    return &jobs[head];
+}
+
+void GHworker::commit() {
+    _lock();
+    head = _next(head);
+    _unlock();
+    _wake();
+}
+
+void GHworker::flush() {
+    if (!out_cb) return;
+    while (1) {
+        _lock();
+        bool empty = (tail == work);
+        _unlock();
+        if (empty) break;
+        out_cb(arg, jobs[tail]);
+        _free(jobs[tail]);
+        _lock();
+        tail = _next(tail);
+        _unlock();
+    }
+}
+
+// ========================== PRIVATE ==========================
+// цикл задачи: пакеты обрабатываются вне блокировки, кольцо защищает только индексы
+void GHworker::_run() {
+    while (1) {
+        _lock();
+        bool empty = (work == head);
+        bool stop = stop_f;
+        _unlock();
+        if (empty) {
+            if (stop) break;
+            _waitWake();
+            continue;
+        }
+        GHjob& job = jobs[work];
+        work_cb(arg, job);
+        if (!out_cb) _free(job);
+        _lock();
+        work = _next(work);
+        if (!out_cb) tail = work;
+        _unlock();
+        _done();
+    }
+}
+
+void GHworker::_free(GHjob& job) {
+    job.data = String();
+    job.flags = 0;
+}
+
+#ifdef ESP32
+void GHworker::_task(void* self) {
+    GHworker* w = (GHworker*)self;
+    w->_run();
+    w->exit_f = 1;
+    w->_done();
+    vTaskDelete(nullptr);
+}
+
+void GHworker::_lock() {
+    portENTER_CRITICAL(&_mux);
+}
+void GHworker::_unlock() {
+    portEXIT_CRITICAL(&_mux);
+}
+void GHworker::_wake() {
+    xSemaphoreGive(wake_s);
+}
+void GHworker::_done() {
+    xSemaphoreGive(done_s);
+}
+void GHworker::_waitWake() {
+    xSemaphoreTake(wake_s, portMAX_DELAY);
+}
+void GHworker::_waitDone() {
+    xSemaphoreTake(done_s, portMAX_DELAY);
+}
+
+#else
+void GHworker::_lock() {
+    mtx.lock();
+}
+void GHworker::_unlock() {
+    mtx.unlock();
+}
+void GHworker::_wake() {
+    std::lock_guard<std::mutex> l(sig_mtx);
+    wake_f = 1;
+    sig_cv.notify_all();
+}
+void GHworker::_done() {
+    std::lock_guard<std::mutex> l(sig_mtx);
+    done_f = 1;
+    sig_cv.notify_all();
+}
+void GHworker::_waitWake() {
+    std::unique_lock<std::mutex> l(sig_mtx);
+    sig_cv.wait(l, [this] { return wake_f; });
+    wake_f = 0;
+}
+void GHworker::_waitDone() {
+    std::unique_lock<std::mutex> l(sig_mtx);
+    sig_cv.wait(l, [this] { return done_f; });
+    done_f = 0;
+}
+#endif
+#endif
@@ -0,0 +1,107 @@
+#pragma once
+#include <Arduino.h>
+
+#include "../config.hpp"
+
+// флаги пакета
+#define GH_JOB_ANSWER (1 << 0)  // ответ клиенту (иначе рассылка)
+#define GH_JOB_MP (1 << 1)      // упаковать в MessagePack
+#define GH_JOB_LZ (1 << 2)      // сжать длинный
+#define GH_JOB_BIN (1 << 3)     // data упакован (бинарный)
+
+#ifdef GH_WORKER_BUILD
+#ifdef ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+#include <utility>
+
+// Фоновая задача для готовых пакетов (второе ядро ESP32, поток на linux): упаковка.
+// loop только собирает текст пакета и кладёт его в очередь. Пакеты проходят кольцо по порядку:
+// заполняется в loop -> обрабатывается в задаче (work) -> отправляется в loop (out, flush) -> свободен.
+// Без out пакет освобождается сразу после work
+
+struct GHjob {
+    String data;
+    uint32_t client = 0;  // WS клиент (ответ)
+    char id[9] = {'\0'};  // id клиента (ответ MQTT)
+    uint8_t conn = 0;
+    uint8_t flags = 0;
+};
+
+typedef void (*GHjobHandler)(void* arg, GHjob& job);
+
+class GHworker {
+   public:
+    ~GHworker() {
+        end();
+    }
+
+    // запустить задачу. work - в задаче, out - в flush() (nullptr - не нужен)
+    bool begin(GHjobHandler work, GHjobHandler out, void* arg);
+
+    // отправить очередь и остановить задачу
+    void end();
+
+    // задача запущена
+    bool running() {
+        return run_f;
+    }
+
+    // свободный пакет для заполнения (из loop). Очередь заполнена - nullptr: loop не ждёт задачу, пакет отбрасывается или отправляется вызывающим сам
+    GHjob* claim();
+
+    // отказов claim() из-за заполненной очереди
+    uint32_t dropped() {
+        return drops;
+    }
+
+    // отдать заполненный пакет задаче
+    void commit();
+
+    // отправить обработанные пакеты (из loop)
+    void flush();
+
+   private:
+    static uint8_t _next(uint8_t i) {
+        return (i + 1 == GH_WORKER_QUEUE) ? 0 : i + 1;
+    }
+    void _run();
+    void _free(GHjob& job);
+    void _lock();
+    void _unlock();
+    void _wake();   // задаче: есть работа
+    void _done();   // loop: пакет обработан
+    void _waitWake();
+    void _waitDone();
+
+    GHjob jobs[GH_WORKER_QUEUE];
+    uint8_t head = 0;  // следующий для заполнения (loop)
+    uint8_t work = 0;  // следующий для обработки (задача)
+    uint8_t tail = 0;  // следующий для отправки
+    GHjobHandler work_cb = nullptr;
+    GHjobHandler out_cb = nullptr;
+    void* arg = nullptr;
+    bool run_f = 0;
+    bool stop_f = 0;
+    uint32_t drops = 0;  // только из loop
+
+#ifdef ESP32
+    static void _task(void* self);
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+    SemaphoreHandle_t wake_s = nullptr;
+    SemaphoreHandle_t done_s = nullptr;
+    volatile bool exit_f = 0;
+#else
+    std::mutex mtx, sig_mtx;
+    std::condition_variable sig_cv;
+    bool wake_f = 0, done_f = 0;
+    std::thread thread;
+#endif
+};
+#endif
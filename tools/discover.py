@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""GyverHub LAN discovery over UDP.
+
+Sends one discover datagram (PREFIX or PREFIX=?FILTER) to the broadcast address
+and to the multicast group, then prints every device that answers with its IP.
+Port and group must match GH_UDP_PORT and GH_UDP_GROUP in src/config.hpp.
+
+Examples:
+    python3 tools/discover.py --prefix MyDevices
+    python3 tools/discover.py --prefix MyDevices --filter "name=Kitchen*&group=light"
+    python3 tools/discover.py --prefix MyDevices --addr 127.0.0.1 --json
+"""
+
+import argparse
+import json
+import re
+import socket
+import time
+
+UDP_PORT = 52025
+UDP_GROUP = '239.255.72.66'
+
+RE_FIELD = re.compile(r"'(\w+)':(?:'([^']*)'|([^,}]*))")
+
+
+def parse_packet(text):
+    try:
+        return json.loads(text)
+    except ValueError:
+        # прошивки до перехода на строгий JSON отвечают с одинарными кавычками
+        return {m.group(1): m.group(2) if m.group(2) is not None else m.group(3) for m in RE_FIELD.finditer(text)}
+
+
+def main():
+    p = argparse.ArgumentParser(description='GyverHub UDP discovery')
+    p.add_argument('--prefix', default='MyDevices', help='network prefix')
+    p.add_argument('--filter', default='', help='discover filter, e.g. "name=Lamp*&from=0&to=7fffffff"')
+    p.add_argument('--port', type=int, default=UDP_PORT, help='UDP port (GH_UDP_PORT)')
+    p.add_argument('--group', default=UDP_GROUP, help='multicast group (GH_UDP_GROUP), empty to skip')
+    p.add_argument('--addr', action='append', help='send to this address instead of broadcast (repeatable)')
+    p.add_argument('-t', '--timeout', type=float, default=1.5, help='wait for answers, s')
+    p.add_argument('--json', action='store_true', help='print results as JSON')
+    args = p.parse_args()
+
+    req = args.prefix + ('=?' + args.filter if args.filter else '')
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s.setsockopt(socket.SOL_SOCKET, socket.SO_BROADCAST, 1)
+    s.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL, 1)
+    s.bind(('', 0))
+
+    targets = args.addr or ['255.255.255.255'] + ([args.group] if args.group else [])
+    for addr in targets:
+        try:
+            s.sendto(req.encode(), (addr, args.port))
+        except OSError as e:
+            print('send to %s failed: %s' % (addr, e))
+
+    found = {}
+    start = time.monotonic()
+    while True:
+        left = args.timeout - (time.monotonic() - start)
+        if left <= 0:
+            break
+        s.settimeout(left)
+        try:
+            data, (ip, _) = s.recvfrom(2048)
+        except socket.timeout:
+            break
+        dev = parse_packet(data.decode('utf-8', 'replace'))
+        if dev.get('type') != 'discover' or 'id' not in dev:
+            continue
+        dev['ip'] = ip
+        dev['ms'] = round((time.monotonic() - start) * 1000, 1)
+        found[dev['id']] = dev  # ответ на broadcast и multicast приходит дважды
+
+    devs = sorted(found.values(), key=lambda d: d['id'])
+    if args.json:
+        print(json.dumps(devs, indent=2, ensure_ascii=False))
+        return
+    for d in devs:
+        print('%-10s %-15s %6.1f ms  %s %s' % (d['id'], d['ip'], d['ms'], d.get('name', ''), d.get('version', '')))
+    print('%d device(s)' % len(devs))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+"""GyverHub delta OTA patch tool.
+
+Builds a patch between the firmware running on the device (old .bin) and the new
+one. The device applies it on the fly against its own flash (src/utils/delta.h),
+so only the patch goes over the air: OTA type `delta` in the app.
+
+Patch format (all integers little-endian):
+    header  "GHDP" [u8 version=1] [3 reserved] [u32 old size] [u32 new size] [u32 CRC32 of new]
+    COPY    0x01 [varint len] [zigzag varint seek]   - len bytes of old
+    ADD     0x02 [varint len] [zigzag varint seek] [len bytes] - old + bytes (mod 256)
+    INSERT  0x03 [varint len] [len bytes]            - bytes as is
+seek moves the old pointer before the command, COPY and ADD advance it by len.
+
+The old .bin must be exactly the image running on the device, otherwise the
+device rejects the result by CRC. Only the Python standard library is used.
+
+Examples:
+    python3 tools/ghdiff.py diff old.bin new.bin update.ghdp
+    python3 tools/ghdiff.py apply old.bin update.ghdp new.bin
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = b'GHDP'
+VERSION = 1
+COPY, ADD, INSERT = 1, 2, 3
+
+BLOCK = 8       # длина ключа индекса старой прошивки
+STEP = 4        # шаг индексации старой прошивки
+CANDIDATES = 8  # макс. позиций на ключ
+MIN_MATCH = 16  # мин. точное совпадение для начала блока
+SLACK = 16      # насколько может упасть счёт при приблизительном продолжении
+MIN_COPY = 8    # мин. точный участок внутри блока для COPY
+
+
+def varint(v):
+    out = bytearray()
+    while True:
+        b = v & 0x7f
+        v >>= 7
+        if v:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+
+def zigzag(v):
+    return (v << 1) if v >= 0 else ((-v) << 1) - 1
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def exact_len(old, o, new, n, limit):
+    """Длина точного совпадения old[o:] и new[n:]"""
+    limit = min(limit, len(old) - o, len(new) - n)
+    length, step = 0, 64
+    while length < limit:
+        k = min(step, limit - length)
+        if old[o + length:o + length + k] == new[n + length:n + length + k]:
+            length += k
+            step *= 2
+        elif k == 1:
+            break
+        else:
+            step = max(1, k // 2)
+    return length
+
+
+def approx_len(old, o, new, n, start):
+    """Продлить блок с несовпадениями, пока совпадений больше, чем отличий"""
+    end = min(len(old) - o, len(new) - n)
+    score = best = start
+    best_len = length = start
+    while length < end:
+        k = exact_len(old, o + length, new, n + length, end - length)
+        if k:
+            length += k
+            score += k
+        else:
+            length += 1
+            score -= 1
+        if score > best:
+            best, best_len = score, length
+        elif score < best - SLACK:
+            break
+    return best_len
+
+
+def build_index(old):
+    index = {}
+    for p in range(0, len(old) - BLOCK + 1, STEP):
+        lst = index.setdefault(old[p:p + BLOCK], [])
+        if len(lst) < CANDIDATES:
+            lst.append(p)
+    return index
+
+
+def diff(old, new):
+    index = build_index(old)
+    out = bytearray(MAGIC + bytes([VERSION, 0, 0, 0]))
+    out += struct.pack('<III', len(old), len(new), zlib.crc32(new))
+    sptr = 0   # указатель старой прошивки на устройстве
+    disp = 0   # смещение последнего блока: old = new + disp
+    lit = 0    # начало непереданных байт новой
+    i = 0
+
+    def emit(op, n_from, o_from, length):
+        nonlocal out, sptr, lit
+        if n_from > lit:
+            out += bytes([INSERT]) + varint(n_from - lit) + new[lit:n_from]
+        out += bytes([op]) + varint(length) + varint(zigzag(o_from - sptr))
+        if op == ADD:
+            out += bytes((new[n_from + k] - old[o_from + k]) & 0xff for k in range(length))
+        sptr = o_from + length
+        lit = n_from + length
+
+    def region(n_from, o_from, length):
+        # точные участки - COPY, отличия между ними - ADD
+        k, add = 0, -1
+        while k < length:
+            e = exact_len(old, o_from + k, new, n_from + k, length - k)
+            if e >= MIN_COPY:
+                if add >= 0:
+                    emit(ADD, n_from + add, o_from + add, k - add)
+                    add = -1
+                emit(COPY, n_from + k, o_from + k, e)
+                k += e
+            else:
+                if add < 0:
+                    add = k
+                k += max(e, 1)
+        if add >= 0:
+            emit(ADD, n_from + add, o_from + add, length - add)
+
+    while i + BLOCK <= len(new):
+        best_o, best_len = -1, 0
+        cands = index.get(new[i:i + BLOCK], [])
+        if 0 <= i + disp < len(old):
+            cands = [i + disp] + cands
+        for o in cands:
+            k = exact_len(old, o, new, i, len(new))
+            if k > best_len:
+                best_o, best_len = o, k
+        if best_len < MIN_MATCH and not (best_o == i + disp and best_len >= BLOCK):
+            i += 1
+            continue
+        # назад по непереданным байтам
+        while i > lit and best_o > 0 and new[i - 1] == old[best_o - 1]:
+            i -= 1
+            best_o -= 1
+            best_len += 1
+        length = approx_len(old, best_o, new, i, best_len)
+        region(i, best_o, length)
+        disp = best_o - i
+        i += length
+    if lit < len(new):
+        out += bytes([INSERT]) + varint(len(new) - lit) + new[lit:]
+    return bytes(out)
+
+
+def apply(old, patch):
+    """Эталонное применение патча, как на устройстве"""
+    if patch[:4] != MAGIC or patch[4] != VERSION:
+        raise ValueError('not a GHDP patch')
+    ssize, dsize, dcrc = struct.unpack('<III', patch[8:20])
+    if ssize != len(old):
+        raise ValueError('old image size %d, patch expects %d' % (len(old), ssize))
+    out = bytearray()
+    pos, sptr = 20, 0
+
+    def read_varint():
+        nonlocal pos
+        v, shift = 0, 0
+        while True:
+            b = patch[pos]
+            pos += 1
+            v |= (b & 0x7f) << shift
+            shift += 7
+            if not b & 0x80:
+                return v
+
+    while len(out) < dsize:
+        op = patch[pos]
+        pos += 1
+        length = read_varint()
+        if op == INSERT:
+            out += patch[pos:pos + length]
+            pos += length
+            continue
+        sptr += unzigzag(read_varint())
+        if sptr < 0 or sptr + length > ssize:
+            raise ValueError('source out of range')
+        src = old[sptr:sptr + length]
+        if op == COPY:
+            out += src
+        elif op == ADD:
+            out += bytes((a + b) & 0xff for a, b in zip(src, patch[pos:pos + length]))
+            pos += length
+        else:
+            raise ValueError('bad command %d' % op)
+        sptr += length
+    if pos != len(patch) or len(out) != dsize or zlib.crc32(out) != dcrc:
+        raise ValueError('patch does not match')
+    return bytes(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='GyverHub delta OTA patch tool')
+    sub = ap.add_subparsers(dest='cmd', required=True)
+    d = sub.add_parser('diff', help='make patch from old.bin to new.bin')
+    d.add_argument('old')
+    d.add_argument('new')
+    d.add_argument('patch')
+    a = sub.add_parser('apply', help='apply patch to old.bin (check)')
+    a.add_argument('old')
+    a.add_argument('patch')
+    a.add_argument('new')
+    args = ap.parse_args()
+
+    if args.cmd == 'diff':
+        old = open(args.old, 'rb').read()
+        new = open(args.new, 'rb').read()
+        patch = diff(old, new)
+        if apply(old, patch) != new:
+            sys.exit('self-check failed')
+        open(args.patch, 'wb').write(patch)
+        print('%s: %d bytes (%.1f%% of %d)' % (args.patch, len(patch), len(patch) * 100 / max(len(new), 1), len(new)))
+    else:
+        old = open(args.old, 'rb').read()
+        try:
+            new = apply(old, open(args.patch, 'rb').read())
+        except (ValueError, IndexError) as e:
+            sys.exit('error: %s' % e)
+        open(args.new, 'wb').write(new)
+        print('%s: %d bytes' % (args.new, len(new)))
+
+
+if __name__ == '__main__':
+    main()
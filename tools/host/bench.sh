@@ -0,0 +1,35 @@
+#!/bin/sh
+# Builder benchmark (builder_bench.cpp) on the linux build: code size and time per request.
+#     ARDUINO_API=/path/to/ArduinoCore-API tools/host/bench.sh [rev ...]
+# Without revisions measures the working tree, otherwise src/ of every git revision given
+# (e.g. "HEAD~1 HEAD"), so a change can be compared with its parent. The benchmark itself is
+# always taken from the working tree.
+# size: .text of the benchmark object at -Os. The builder is header-only, so this is the code
+# the sketch gets for its onBuild panel (host code, compare revisions rather than absolute bytes).
+set -e
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+: "${ARDUINO_API:?set ARDUINO_API to the ArduinoCore-API folder}"
+OUT=${OUT:-/tmp/gh_bench}
+CXX=${CXX:-g++}
+mkdir -p "$OUT"
+
+bench() {  # $1 - name, $2 - src folder
+    echo "== $1"
+    FLAGS="-std=gnu++17 -pthread -I$ARDUINO_API -I$2/posix -I$2"
+    $CXX $FLAGS -Os -c "$HERE/builder_bench.cpp" -o "$OUT/size.o"
+    size "$OUT/size.o" | awk 'NR == 2 { print "size       " $1 " bytes .text (-Os)" }'
+    $CXX $FLAGS -O2 -DNDEBUG "$HERE/builder_bench.cpp" "$2/posix/core.cpp" "$2"/utils/*.cpp "$ARDUINO_API"/api/*.cpp -o "$OUT/bench"
+    "$OUT/bench"
+}
+
+if [ $# -eq 0 ]; then
+    bench "working tree" "$ROOT/src"
+fi
+for rev in "$@"; do
+    dir="$OUT/src_$(echo "$rev" | tr -c 'A-Za-z0-9\n' '_')"
+    rm -rf "$dir"
+    mkdir -p "$dir"
+    git -C "$ROOT" archive "$rev" src | tar -x -C "$dir" --strip-components=1
+    bench "$rev" "$dir"
+done
@@ -0,0 +1,107 @@
+// Host benchmark of the component builder (src/builder.h) on the linux build: a panel with most
+// component kinds, F() and String names, then timing of the requests that walk it - {ui}
+// build, set hitting the last/a middle component, set missing every name, and a sendUpdate
+// list read. Prints best-of-7 time per request (and TSC cycles on x86).
+// Run through tools/host/bench.sh, which also reports code size and compares git revisions.
+#define GH_NO_WS
+#define GH_NO_HTTP
+#define GH_NO_MQTT
+#define GH_NO_UDP
+#include <GyverHub.h>
+
+#include <chrono>
+#include <cstdio>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_TSC
+#endif
+
+GyverHub hub("MyDevices", "Bench", "", 0x123456);
+static bool b1, sw = 1;
+static String inp_str = "text";
+static char inp_cstr[20] = "abc";
+static int16_t inp_int = -1234, sld = 20;
+static float inp_float = 3.14, sld_f = 20.5;
+static GHcolor col;
+static uint8_t sel = 1, tab;
+static GHflags flags;
+static GHpos pos;
+static size_t out = 0;
+
+static void build() {
+    hub.Button(String("rb"), &b1, String("R"));
+    hub.Input(String("rinp"), &inp_str, GH_STR, String("Rin"));
+    hub.Slider(String("rsl"), &sld, GH_INT16, String("Rs"));
+    hub.Label(String("rlb"), String("v"), String("RL"));
+    hub.BeginWidgets();
+    hub.Tabs(F("tabs"), &tab, F("Tab 1,Tab 2,Tab 3"));
+    hub.WidgetSize(25);
+    hub.Button(F("b1"), &b1, F("Button 1"));
+    hub.Button(F("b2"), &b1, F("Button 2"), GH_RED);
+    hub.WidgetSize(50);
+    hub.Label(F("lbl"), String("it's \"q\""), F("Label"));
+    hub.LED(F("led"), 0, F("Status"));
+    hub.Title(F("Inputs"));
+    hub.Input(F("inp_s"), &inp_str, GH_STR, F("String"), 0, F("^[A-Za-z]+$"));
+    hub.Input(F("inp_c"), &inp_cstr, GH_CSTR, F("cstring"), 10);
+    hub.Input(F("inp_i"), &inp_int, GH_INT16, F("int"));
+    hub.Input(F("inp_f"), &inp_float, GH_FLOAT, F("float"));
+    hub.Slider(F("sld1"), &sld, GH_INT16, F("Slider"));
+    hub.Slider(F("sld2"), &sld_f, GH_FLOAT, F("Slider F"), 10, 90, 0.5, GH_PINK);
+    hub.Gauge(F("ga"), -3, F("C"), F("Temp"), -5, 30, 0.1, GH_RED);
+    hub.Switch(F("sw"), &sw, F("Switch"));
+    hub.Color(F("color"), &col, F("Color"));
+    hub.Select(F("sel"), &sel, F("one,two,three"), F("Select"));
+    hub.Flags(F("flags"), &flags, F("a,b,c"), F("Flags"), GH_AQUA);
+    hub.Display(F("disp"), String("Hello\nWorld"), F(""), GH_BLUE);
+    hub.EndWidgets();
+    hub.Spinner(F("spn"), &sld, F("Spin"), 0, 100, 1);
+    hub.Canvas(F("cv"), 200, 100, nullptr, &pos, F("Canvas"));
+    hub.Joystick(F("joy"), &pos);
+    hub.Confirm(F("cf"), &b1);
+    hub.SwitchIcon(F("swi"), &sw, F(""), F("\xef\x80\x91"));
+}
+
+static void req(const char* url, const char* val = "") {
+    static char u[64], v[64];
+    strcpy(u, url);
+    strcpy(v, val);
+    hub.parse(u, v, GH_SERIAL, true);
+}
+
+template <typename F>
+static void run(const char* name, int n, F f) {
+    for (int i = 0; i < n / 10; i++) f();  // warm-up
+    double best = 1e18;
+    uint64_t cyc = ~0ull;
+    for (int r = 0; r < 7; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+#ifdef BENCH_TSC
+        uint64_t c0 = __rdtsc();
+#endif
+        for (int i = 0; i < n; i++) f();
+#ifdef BENCH_TSC
+        uint64_t c = (__rdtsc() - c0) / n;
+        if (c < cyc) cyc = c;
+#endif
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / n;
+        if (ns < best) best = ns;
+    }
+#ifdef BENCH_TSC
+    printf("%-10s %9.0f ns %9llu cycles\n", name, best, (unsigned long long)cyc);
+#else
+    printf("%-10s %9.0f ns\n", name, best);
+#endif
+}
+
+int main() {
+    hub.onManual([](String& s, GHconn_t, bool) { out += s.length(); });
+    hub.onBuild(build);
+    hub.begin();
+    run("ui", 20000, [] { req("MyDevices/123456/cl/focus"); });
+    run("set_last", 20000, [] { req("MyDevices/123456/cl/set/cf", "1"); });
+    run("set_mid", 20000, [] { req("MyDevices/123456/cl/set/inp_f", "1.5"); });
+    run("set_miss", 20000, [] { req("MyDevices/123456/cl/set/zzz", "1"); });
+    run("read", 20000, [] { hub.sendUpdate("rinp,rlb,inp_i,sld2,lbl"); });
+    return out ? 0 : 1;
+}
@@ -0,0 +1,335 @@
+// Host test of the delta OTA applier (src/utils/delta.h) against files, the way the device applies
+// a patch against its own flash. Patches come from tools/ghdiff.py (old/new images generated here)
+// and from a small encoder below that covers every command and negative seeks. Each patch is fed in
+// chunks of 1, 7, 200 and 4096 bytes and must give exactly the new image with end() true.
+// Corrupt, truncated and wrong-base patches must not pass end(). Needs python3 for the ghdiff.py
+// part (GHDIFF overrides the script path), the hand-made patches run without it.
+// Build and run: tools/host/run.sh delta_test
+#include <Arduino.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "utils/delta.h"
+
+static int fails = 0;
+#define CHECK(x)                                              \
+    do {                                                      \
+        if (!(x)) {                                           \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #x); \
+            fails++;                                          \
+        }                                                     \
+    } while (0)
+
+typedef std::string Bytes;
+
+// old image is read from this file, like GH_readSketch reads the flash
+static FILE* oldf = nullptr;
+
+static bool fileRead(uint32_t addr, uint8_t* buf, size_t len) {
+    return oldf && !fseek(oldf, addr, SEEK_SET) && fread(buf, 1, len, oldf) == len;
+}
+
+// new image sink, refuses to write past limit
+struct Sink : public Print {
+    Bytes data;
+    size_t limit = (size_t)-1;
+    size_t write(uint8_t c) {
+        return write(&c, 1);
+    }
+    size_t write(const uint8_t* p, size_t len) {
+        if (data.size() + len > limit) return 0;
+        data.append((const char*)p, len);
+        return len;
+    }
+};
+
+static Bytes tmpdir;
+
+static Bytes path(const char* name) {
+    return tmpdir + "/" + name;
+}
+
+static void save(const Bytes& file, const Bytes& data) {
+    FILE* f = fopen(file.c_str(), "wb");
+    fwrite(data.data(), 1, data.size(), f);
+    fclose(f);
+}
+
+static bool load(const Bytes& file, Bytes& data) {
+    FILE* f = fopen(file.c_str(), "rb");
+    if (!f) return 0;
+    char buf[4096];
+    size_t n;
+    data.clear();
+    while ((n = fread(buf, 1, sizeof(buf), f))) data.append(buf, n);
+    fclose(f);
+    return 1;
+}
+
+struct Result {
+    bool end, error;
+    Bytes out;
+};
+
+// apply patch to the old image in file base, feeding it chunk bytes at a time
+static Result apply(const Bytes& base, const Bytes& patch, size_t chunk, size_t limit = (size_t)-1) {
+    oldf = fopen(base.c_str(), "rb");
+    Sink sink;
+    sink.limit = limit;
+    GHdelta d(fileRead, sink);
+    for (size_t i = 0; i < patch.size(); i += chunk) {
+        size_t n = std::min(chunk, patch.size() - i);
+        if (d.write((const uint8_t*)patch.data() + i, n) != n) break;
+    }
+    fclose(oldf);
+    oldf = nullptr;
+    return {d.end(), d.error(), sink.data};
+}
+
+static const size_t chunks[] = {1, 7, 200, 4096};
+
+// patch must turn old into new at every chunk size
+static void checkPatch(const char* name, const Bytes& base, const Bytes& patch, const Bytes& expect) {
+    for (size_t c : chunks) {
+        Result r = apply(base, patch, c);
+        if (!r.end || r.error || r.out != expect) printf("  %s, chunk %zu: end %d error %d out %zu of %zu\n", name, c, r.end, r.error, r.out.size(), expect.size());
+        CHECK(r.end && !r.error && r.out == expect);
+    }
+}
+
+// patch must be rejected at every chunk size
+static void checkReject(const char* name, const Bytes& base, const Bytes& patch, const Bytes& expect) {
+    for (size_t c : chunks) {
+        Result r = apply(base, patch, c);
+        if (r.end) printf("  %s, chunk %zu: accepted\n", name, c);
+        CHECK(!r.end);
+        CHECK(r.out.size() <= expect.size());
+    }
+}
+
+// ======================== PATCH ENCODER ========================
+static void u32(Bytes& b, uint32_t v) {
+    for (int i = 0; i < 4; i++) b += (char)(v >> (i * 8));
+}
+
+static void varint(Bytes& b, uint32_t v) {
+    while (v >= 0x80) {
+        b += (char)(v | 0x80);
+        v >>= 7;
+    }
+    b += (char)v;
+}
+
+static Bytes header(uint32_t ssize, const Bytes& out) {
+    Bytes b("GHDP\x01\0\0\0", 8);
+    u32(b, ssize);
+    u32(b, out.size());
+    u32(b, GH_crc32(0, (const uint8_t*)out.data(), out.size()));
+    return b;
+}
+
+// builds the command list and, in parallel, the image it produces
+struct Encoder {
+    const Bytes& old;
+    Bytes cmds, out;
+    int32_t sptr = 0;
+
+    void copy(int32_t seek, uint32_t len) {
+        cmds += (char)1;
+        varint(cmds, len);
+        varint(cmds, seek >= 0 ? seek << 1 : ((-seek) << 1) - 1);
+        sptr += seek;
+        out += old.substr(sptr, len);
+        sptr += len;
+    }
+    void add(int32_t seek, const Bytes& diff) {
+        cmds += (char)2;
+        varint(cmds, diff.size());
+        varint(cmds, seek >= 0 ? seek << 1 : ((-seek) << 1) - 1);
+        cmds += diff;
+        sptr += seek;
+        for (size_t i = 0; i < diff.size(); i++) out += (char)(old[sptr + i] + diff[i]);
+        sptr += diff.size();
+    }
+    void insert(const Bytes& data) {
+        cmds += (char)3;
+        varint(cmds, data.size());
+        cmds += data;
+        out += data;
+    }
+    Bytes patch() {
+        return header(old.size(), out) + cmds;
+    }
+};
+
+// firmware-like image: runs of code-ish random bytes, repeated tables and zero padding
+static Bytes makeImage(size_t size, unsigned seed) {
+    Bytes b;
+    while (b.size() < size) {
+        unsigned kind = rand_r(&seed) % 8;
+        size_t n = 16 + rand_r(&seed) % 600;
+        if (kind == 0) b.append(n, '\0');
+        else if (kind == 1 && b.size() > 1024) b += b.substr(rand_r(&seed) % (b.size() - 512), 256);
+        else
+            for (size_t i = 0; i < n; i++) b += (char)(rand_r(&seed) & ((kind & 1) ? 0x3f : 0xff));
+    }
+    b.resize(size);
+    return b;
+}
+
+// next build: shifted code, changed constants, moved block, new tail
+static Bytes makeNext(const Bytes& old, unsigned seed) {
+    Bytes b = old.substr(0, 3000) + Bytes(37, 'N') + old.substr(3000);
+    for (size_t i = 5000; i < b.size(); i += 700 + rand_r(&seed) % 900) b[i] += 1 + rand_r(&seed) % 5;
+    b += old.substr(1000, 4000);
+    b += makeImage(3000, seed + 1);
+    return b;
+}
+
+// ======================== TESTS ========================
+static void handMade() {
+    Bytes old = makeImage(20000, 1);
+    Bytes obase = path("hand_old.bin");
+    save(obase, old);
+
+    Encoder e{old};
+    e.copy(0, 5000);                        // same start
+    e.insert(Bytes("inserted code", 13));   // new bytes
+    e.add(100, Bytes(300, '\x02'));         // changed constants after a skip
+    e.copy(-4000, 700);                     // block moved back
+    e.copy(8000, 6000);                     // long copy over several read windows
+    e.add(19990 - e.sptr, Bytes("\x01\xff", 2));    // last bytes of the old image
+    e.insert(Bytes(5000, 'T'));             // insert longer than a chunk
+    Bytes patch = e.patch();
+    printf("hand-made: old %zu new %zu patch %zu\n", old.size(), e.out.size(), patch.size());
+    checkPatch("hand-made", obase, patch, e.out);
+
+    // size() is known right after the header
+    {
+        Sink sink;
+        oldf = fopen(obase.c_str(), "rb");
+        GHdelta d(fileRead, sink);
+        d.write((const uint8_t*)patch.data(), GH_DELTA_HEAD);
+        CHECK(d.size() == e.out.size() && !d.end() && !d.error());
+        fclose(oldf);
+        oldf = nullptr;
+    }
+
+    // source outside the old image
+    {
+        Encoder b{old};
+        b.copy(0, 100);
+        Bytes p = b.patch();
+        p.back() = (char)0x7f;  // seek far past the end
+        Result r = apply(obase, p, 1);
+        CHECK(!r.end && r.error);
+    }
+
+    // unknown command
+    {
+        Bytes p = patch;
+        p[GH_DELTA_HEAD] = 9;
+        Result r = apply(obase, p, 7);
+        CHECK(!r.end && r.error && r.out.empty());
+    }
+
+    // zero length command
+    {
+        Bytes p = header(old.size(), Bytes("x", 1)) + Bytes("\x03\x00x", 3);
+        CHECK(apply(obase, p, 1).error);
+    }
+
+    // output that does not fit the OTA partition
+    {
+        Result r = apply(obase, patch, 200, 4000);
+        CHECK(!r.end && r.error);
+    }
+}
+
+static void ghdiff(const char* name, const Bytes& old, const Bytes& next, bool related = true) {
+    const char* script = getenv("GHDIFF");
+    Bytes gd = script ? Bytes(script) : Bytes(__FILE__).substr(0, Bytes(__FILE__).rfind('/')) + "/../ghdiff.py";
+    Bytes obase = path("old.bin"), nfile = path("new.bin"), pfile = path("update.ghdp");
+    save(obase, old);
+    save(nfile, next);
+    Bytes cmd = "python3 '" + gd + "' diff '" + obase + "' '" + nfile + "' '" + pfile + "' > /dev/null";
+    Bytes patch;
+    if (system(cmd.c_str()) || !load(pfile, patch)) {
+        printf("FAIL: %s\n", cmd.c_str());
+        fails++;
+        return;
+    }
+    printf("%s: old %zu new %zu patch %zu\n", name, old.size(), next.size(), patch.size());
+    checkPatch(name, obase, patch, next);
+
+    // CRC in the header does not match
+    {
+        Bytes p = patch;
+        p[16] ^= 1;
+        checkReject("bad crc", obase, p, next);
+    }
+
+    // wrong magic or version
+    {
+        Bytes p = patch;
+        p[0] = 'X';
+        CHECK(apply(obase, p, 1).error);
+        p = patch;
+        p[4] = 2;
+        CHECK(apply(obase, p, 4096).error);
+    }
+
+    // every byte flipped in turn at a few places: never accepted
+    for (size_t i = GH_DELTA_HEAD; i < patch.size(); i += patch.size() / 17 + 1) {
+        Bytes p = patch;
+        p[i] ^= 0x55;
+        checkReject("corrupt", obase, p, next);
+    }
+
+    // truncated patch
+    checkReject("truncated", obase, patch.substr(0, patch.size() - 1), next);
+    checkReject("half", obase, patch.substr(0, patch.size() / 2), next);
+
+    // trailing data after the end
+    {
+        Result r = apply(obase, patch + "x", 4096);
+        CHECK(!r.end && r.error);
+    }
+
+    // patch applied to another build: CRC mismatch
+    {
+        Bytes other = old;
+        for (size_t i = 0; i < other.size(); i += 997) other[i] ^= 0x20;
+        Bytes wrong = path("wrong.bin");
+        save(wrong, other);
+        checkReject("wrong base", wrong, patch, next);
+    }
+
+    // old image shorter than the patch expects: read fails (an unrelated build does not read old at all)
+    if (related) {
+        Bytes cut = path("cut.bin");
+        save(cut, old.substr(0, old.size() / 2));
+        checkReject("short base", cut, patch, next);
+    }
+}
+
+int main() {
+    char dir[] = "/tmp/gh_deltaXXXXXX";
+    if (!mkdtemp(dir)) return 1;
+    tmpdir = dir;
+
+    handMade();
+
+    Bytes old = makeImage(200000, 7);
+    ghdiff("ghdiff", old, makeNext(old, 8));
+    ghdiff("ghdiff same", old, old);
+    ghdiff("ghdiff unrelated", makeImage(30000, 9), makeImage(25000, 10), false);
+
+    system(("rm -rf '" + tmpdir + "'").c_str());
+    if (fails) return 1;
+    puts("OK");
+    return 0;
+}
@@ -0,0 +1,400 @@
+// Host test of the JSON -> MessagePack conversion (utils/msgpack.h) used for clients that sent
+// "mp" in focus. The answer is first built as JSON and then converted, so both texts are in RAM
+// for the duration of GH_toMsgpack. Every converted packet is decoded back and must give the same
+// data as the JSON (numbers compared as JSON.parse would see them); broken JSON must be refused
+// with the output left untouched. For {ui} of a growing panel prints JSON and MessagePack sizes,
+// heap peak above the finished JSON while converting and conversion time, and checks the size
+// ratio and that the peak stays within one JSON length.
+// Heap is counted by wrapping glibc malloc, skipped under sanitizers.
+// Build and run: tools/host/run.sh msgpack_test
+#define GH_NO_WS
+#define GH_NO_HTTP
+#define GH_NO_MQTT
+#define GH_NO_UDP
+#include <GyverHub.h>
+#include <malloc.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define MP_NO_HEAP
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer)
+#define MP_NO_HEAP
+#endif
+#endif
+
+static int fails = 0;
+#define CHECK(x)                                              \
+    do {                                                      \
+        if (!(x)) {                                           \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #x); \
+            fails++;                                          \
+        }                                                     \
+    } while (0)
+
+static size_t heap = 0, peak = 0;
+
+#ifndef MP_NO_HEAP
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void __libc_free(void*);
+
+static void* _track(void* p) {
+    if (p) {
+        heap += malloc_usable_size(p);
+        if (heap > peak) peak = heap;
+    }
+    return p;
+}
+extern "C" void* malloc(size_t n) {
+    return _track(__libc_malloc(n));
+}
+extern "C" void* calloc(size_t n, size_t s) {
+    return _track(__libc_calloc(n, s));
+}
+extern "C" void* realloc(void* p, size_t n) {
+    if (p) heap -= malloc_usable_size(p);
+    void* r = __libc_realloc(p, n);
+    if (!r && p) heap += malloc_usable_size(p);  // old block kept
+    return _track(r);
+}
+extern "C" void free(void* p) {
+    if (p) heap -= malloc_usable_size(p);
+    __libc_free(p);
+}
+#endif
+
+// ======================== CANONICAL FORM ========================
+// both JSON and MessagePack are reduced to one text: strings with only \" \\ and \u00XX escaped,
+// numbers as %.17g of the double JSON.parse would give, objects and arrays without spaces
+typedef std::string Str;
+
+static void canonStr(Str& out, const Str& s) {
+    out += '"';
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (c < 0x20) {
+            char b[8];
+            snprintf(b, sizeof(b), "\\u%04x", c);
+            out += b;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+static void canonNum(Str& out, double d) {
+    char b[32];
+    snprintf(b, sizeof(b), "%.17g", d);
+    out += b;
+}
+
+// reference JSON reader, independent from utils/msgpack.cpp
+struct Json {
+    const char* p;
+
+    void ws() {
+        while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t') p++;
+    }
+    static void utf8(Str& s, uint32_t c) {
+        if (c < 0x80) s += (char)c;
+        else if (c < 0x800) s += (char)(0xc0 | (c >> 6)), s += (char)(0x80 | (c & 0x3f));
+        else if (c < 0x10000) s += (char)(0xe0 | (c >> 12)), s += (char)(0x80 | ((c >> 6) & 0x3f)), s += (char)(0x80 | (c & 0x3f));
+        else s += (char)(0xf0 | (c >> 18)), s += (char)(0x80 | ((c >> 12) & 0x3f)), s += (char)(0x80 | ((c >> 6) & 0x3f)), s += (char)(0x80 | (c & 0x3f));
+    }
+    bool str(Str& s) {
+        if (*p++ != '"') return 0;
+        while (*p != '"') {
+            if (!*p) return 0;
+            if (*p != '\\') {
+                s += *p++;
+                continue;
+            }
+            p++;
+            char c = *p++;
+            switch (c) {
+                case 'n': s += '\n'; break;
+                case 'r': s += '\r'; break;
+                case 't': s += '\t'; break;
+                case 'b': s += '\b'; break;
+                case 'f': s += '\f'; break;
+                case '/':
+                case '\\':
+                case '"': s += c; break;
+                case 'u': {
+                    uint32_t code = strtoul(Str(p, 4).c_str(), nullptr, 16);
+                    p += 4;
+                    if (code >= 0xd800 && code < 0xdc00 && p[0] == '\\' && p[1] == 'u') {
+                        uint32_t low = strtoul(Str(p + 2, 4).c_str(), nullptr, 16);
+                        if (low >= 0xdc00 && low < 0xe000) {
+                            code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                            p += 6;
+                        }
+                    }
+                    utf8(s, code);
+                } break;
+                default: return 0;
+            }
+        }
+        p++;
+        return 1;
+    }
+    bool value(Str& out) {
+        ws();
+        if (*p == '{' || *p == '[') {
+            bool obj = (*p++ == '{');
+            out += obj ? '{' : '[';
+            ws();
+            bool first = 1;
+            while (*p != (obj ? '}' : ']')) {
+                if (!first) {
+                    if (*p++ != ',') return 0;
+                    out += ',';
+                }
+                first = 0;
+                if (obj) {
+                    ws();
+                    Str k;
+                    if (!str(k)) return 0;
+                    canonStr(out, k);
+                    ws();
+                    if (*p++ != ':') return 0;
+                    out += ':';
+                }
+                if (!value(out)) return 0;
+                ws();
+            }
+            p++;
+            out += obj ? '}' : ']';
+            return 1;
+        }
+        if (*p == '"') {
+            Str s;
+            if (!str(s)) return 0;
+            canonStr(out, s);
+            return 1;
+        }
+        for (const char* w : {"true", "false", "null"}) {
+            if (!strncmp(p, w, strlen(w))) {
+                p += strlen(w);
+                out += w;
+                return 1;
+            }
+        }
+        char* end;
+        double d = strtod(p, &end);
+        if (end == p) return 0;
+        p = end;
+        canonNum(out, d);
+        return 1;
+    }
+};
+
+static Str canonJson(const Str& text) {
+    Json j{text.c_str()};
+    Str out;
+    if (!j.value(out)) return "<bad json>";
+    j.ws();
+    return *j.p ? "<bad json>" : out;
+}
+
+// MessagePack reader
+struct Mp {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    uint64_t be(uint8_t n) {
+        uint64_t v = 0;
+        while (n--) v = (v << 8) | *p++;
+        return v;
+    }
+    bool value(Str& out) {
+        if (p >= end) return 0;
+        uint8_t c = *p++;
+        uint32_t n;
+        if (c <= 0x7f) return canonNum(out, c), 1;
+        if (c >= 0xe0) return canonNum(out, (int8_t)c), 1;
+        if ((c & 0xf0) == 0x80) return list(out, c & 0x0f, 1);
+        if ((c & 0xf0) == 0x90) return list(out, c & 0x0f, 0);
+        if ((c & 0xe0) == 0xa0) return str(out, c & 0x1f);
+        switch (c) {
+            case 0xc0: out += "null"; return 1;
+            case 0xc2: out += "false"; return 1;
+            case 0xc3: out += "true"; return 1;
+            case 0xca: {
+                uint32_t b = be(4);
+                float f;
+                memcpy(&f, &b, 4);
+                canonNum(out, f);
+            } return 1;
+            case 0xcb: {
+                uint64_t b = be(8);
+                double d;
+                memcpy(&d, &b, 8);
+                canonNum(out, d);
+            } return 1;
+            case 0xcc: canonNum(out, be(1)); return 1;
+            case 0xcd: canonNum(out, be(2)); return 1;
+            case 0xce: canonNum(out, be(4)); return 1;
+            case 0xcf: canonNum(out, be(8)); return 1;
+            case 0xd0: canonNum(out, (int8_t)be(1)); return 1;
+            case 0xd1: canonNum(out, (int16_t)be(2)); return 1;
+            case 0xd2: canonNum(out, (int32_t)be(4)); return 1;
+            case 0xd3: canonNum(out, (int64_t)be(8)); return 1;
+            case 0xd9: n = be(1); return str(out, n);
+            case 0xda: n = be(2); return str(out, n);
+            case 0xdb: n = be(4); return str(out, n);
+            case 0xdc: n = be(2); return list(out, n, 0);
+            case 0xdd: n = be(4); return list(out, n, 0);
+            case 0xde: n = be(2); return list(out, n, 1);
+            case 0xdf: n = be(4); return list(out, n, 1);
+        }
+        return 0;
+    }
+    bool str(Str& out, uint32_t n) {
+        if ((size_t)(end - p) < n) return 0;
+        canonStr(out, Str((const char*)p, n));
+        p += n;
+        return 1;
+    }
+    bool list(Str& out, uint32_t n, bool obj) {
+        out += obj ? '{' : '[';
+        for (uint32_t i = 0; i < n; i++) {
+            if (i) out += ',';
+            if (obj) {
+                if (p >= end || (*p & 0xe0) != 0xa0 && *p != 0xd9 && *p != 0xda && *p != 0xdb) return 0;  // ключи - строки
+                if (!value(out)) return 0;
+                out += ':';
+            }
+            if (!value(out)) return 0;
+        }
+        out += obj ? '}' : ']';
+        return 1;
+    }
+};
+
+static Str canonMp(const String& mp) {
+    Mp m{(const uint8_t*)mp.c_str(), (const uint8_t*)mp.c_str() + mp.length()};
+    Str out;
+    if (!m.value(out) || m.p != m.end) return "<bad msgpack>";
+    return out;
+}
+
+// convert and compare with the JSON
+static void checkSame(const String& json) {
+    String mp;
+    CHECK(GH_toMsgpack(json, mp));
+    Str a = canonJson(json.c_str()), b = canonMp(mp);
+    if (a != b) printf("  json: %.200s\n  mp:   %.200s\n", a.c_str(), b.c_str());
+    CHECK(a == b);
+}
+
+// ======================== PANEL ========================
+GyverHub hub("MyDevices", "Host", "", 0x123456);
+static uint16_t widgets = 0;
+static String last;
+
+static void build() {
+    static float f = 1.5;
+    static bool b = 1;
+    static int32_t i = -42;
+    for (uint16_t k = 0; k < widgets; k++) {
+        String n(k);
+        switch (k % 5) {
+            case 0: hub.Slider(String("sld") + n, &f, String("Slider ") + n, 0, 255, 0.5); break;
+            case 1: hub.Switch(String("sw") + n, &b, String("Switch ") + n); break;
+            case 2: hub.Label(String("lbl") + n, String("value \"") + n + '"', String("Label ") + n); break;
+            case 3: hub.Input(String("in") + n, &i, String("Input ") + n); break;
+            case 4: hub.Button(String("btn") + n, nullptr, String("Button ") + n, GH_RED); break;
+        }
+    }
+}
+
+int main() {
+    // value kinds and sizes at every format boundary
+    const char* cases[] = {
+        "{}",
+        "[]",
+        "{\"a\":[],\"b\":{},\"c\":[[[]]]}",
+        "{\"t\":true,\"f\":false,\"n\":null}",
+        "[0,1,127,128,255,256,65535,65536,4294967295,4294967296,18446744073709551615]",
+        "[-1,-32,-33,-128,-129,-32768,-32769,-2147483648,-2147483649,-9223372036854775807]",
+        "[0.5,-0.5,100.00,-3.00,0.1,3.14159265358979,1e3,2.5E-3,-0.0,1e300,123456789012345678901234]",
+        "{\"s\":\"q\\\"b\\\\s\\/n\\nr\\rt\\tb\\bf\\f\",\"u\":\"\\u0027\\u00e9\\u20ac\\ud83d\\ude00\"}",
+        "{\"utf\":\"Привет, мир\",\"key with spaces\" : [ 1 , 2 ]}",
+        " \n{ \"ws\" :\t[ true ,false ] }\r\n",
+    };
+    for (const char* c : cases) checkSame(c);
+
+    // strings and containers across fix/8/16/32 bit headers
+    for (size_t n : {31, 32, 255, 256, 65535, 65536}) {
+        String s = "{\"s\":\"";
+        for (size_t i = 0; i < n; i++) s += (char)('a' + i % 26);
+        s += "\"}";
+        checkSame(s);
+    }
+    for (size_t n : {15, 16, 65535, 65536}) {
+        String a = "[", o = "{";
+        for (size_t i = 0; i < n; i++) {
+            if (i) a += ',', o += ',';
+            a += (int)(i & 0x7f);
+            o += "\"k";
+            o += (unsigned)i;
+            o += "\":1";
+        }
+        a += ']';
+        o += '}';
+        checkSame(a);
+        checkSame(o);
+    }
+
+    // broken JSON: refused, output untouched
+    const char* bad[] = {"", "{", "{\"a\":}", "{\"a\" 1}", "[1,]", "[1 2]", "{\"a\":tru}", "\"open", "{\"s\":\"\\x\"}",
+                         "{\"u\":\"\\u12\"}", "[1]x", "-", "1.", "1e", "[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]"};
+    for (const char* b : bad) {
+        String out = "keep";
+        if (GH_toMsgpack(b, out)) printf("  accepted: %s\n", b);
+        CHECK(out == "keep");
+    }
+
+    // {ui} of a growing panel
+    hub.onBuild(build);
+    hub.onManual([](String& s, GHconn_t, bool) { last = s; });
+    hub.begin();
+    printf("%8s %8s %8s %6s %10s %8s\n", "widgets", "json", "mp", "mp/js", "peak+", "us");
+    for (uint16_t n : {1, 10, 25, 50, 100, 200}) {
+        widgets = n;
+        char url[] = "MyDevices/123456/cl/focus";
+        char val[] = "";
+        hub.parse(url, val, GH_SERIAL, true);
+        String json = last;
+        last = "";
+
+        String mp;
+        size_t base = heap;
+        peak = heap;
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = GH_toMsgpack(json, mp);
+        auto t1 = std::chrono::steady_clock::now();
+        CHECK(ok);
+        size_t over = peak - base;
+        long us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+        printf("%8u %8u %8u %5u%% %10u %8ld\n", n, json.length(), mp.length(), mp.length() * 100 / json.length(), (unsigned)over, us);
+        checkSame(json);
+        if (n >= 10) CHECK(mp.length() * 100 / json.length() < 80);
+#ifndef MP_NO_HEAP
+        CHECK(over <= json.length() + 64);  // only the MessagePack buffer, reserved by JSON length
+#endif
+    }
+
+    if (fails) return 1;
+    puts("OK");
+    return 0;
+}
@@ -0,0 +1,24 @@
+#!/bin/sh
+# Build and run host tests against the Linux build of the library (GH_POSIX_BUILD).
+# Needs ArduinoCore-API (https://github.com/arduino/ArduinoCore-API), same as the Linux build:
+#     ARDUINO_API=/path/to/ArduinoCore-API tools/host/run.sh [test ...]
+# Without arguments runs every *_test.cpp / *_stress.cpp here. Extra compiler flags: CXXFLAGS
+# (e.g. CXXFLAGS="-fsanitize=thread" for the stress tests).
+set -e
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+: "${ARDUINO_API:?set ARDUINO_API to the ArduinoCore-API folder}"
+OUT=${OUT:-/tmp/gh_host}
+mkdir -p "$OUT"
+
+if [ $# -eq 0 ]; then
+    set -- $(cd "$HERE" && ls *_test.cpp *_stress.cpp 2>/dev/null | sed 's/\.cpp$//')
+fi
+
+SRCS="$ROOT/src/posix/core.cpp $(ls "$ROOT"/src/utils/*.cpp) $(ls "$ARDUINO_API"/api/*.cpp)"
+for t in "$@"; do
+    echo "== $t"
+    ${CXX:-g++} -std=gnu++17 -O1 -g -pthread $CXXFLAGS -I"$ARDUINO_API" -I"$ROOT/src/posix" -I"$ROOT/src" \
+        "$HERE/$t.cpp" $SRCS -o "$OUT/$t"
+    "$OUT/$t"
+done
@@ -0,0 +1,184 @@
+// Host test of the MJPEG stream sender (src/utils/frames.h), no sockets involved.
+// A producer publishes a frame every tick while simulated viewers accept only a few
+// bytes per tick (slow) or nothing at all (stalled). Checks that the sender never
+// waits for the socket, a lagging viewer skips frames without holding back the
+// fast one, a stalled viewer times out, and every delivered part is a well-formed
+// multipart chunk with an intact frame of increasing number.
+// Build and run: tools/host/run.sh stream_test
+#include <Arduino.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "utils/frames.h"
+
+static int fails = 0;
+#define CHECK(x)                                              \
+    do {                                                      \
+        if (!(x)) {                                           \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #x); \
+            fails++;                                          \
+        }                                                     \
+    } while (0)
+
+// simulated socket: accepts up to room bytes per tick
+struct Sock {
+    std::string data;
+    size_t room = 0;
+    size_t calls = 0;
+};
+
+static size_t sockWrite(void* arg, const uint8_t* p, size_t len) {
+    Sock& s = *(Sock*)arg;
+    s.calls++;
+    size_t w = len < s.room ? len : s.room;
+    s.data.append((const char*)p, w);
+    s.room -= w;
+    return w;
+}
+
+// frame n: n % 200 + 1 bytes of value n & 0xff
+static size_t makeFrame(uint32_t n, uint8_t* buf) {
+    size_t len = n % 200 + 1;
+    memset(buf, n & 0xff, len);
+    return len;
+}
+
+// parse received multipart, return number of complete frames or -1 on error
+static int parseParts(const std::string& d, const char* mime) {
+    size_t pos = 0;
+    int frames = 0;
+    int last = -1;
+    char head[96];
+    while (pos < d.size()) {
+        size_t hend = d.find("\r\n\r\n", pos);
+        if (hend == std::string::npos) break;  // incomplete part at the end
+        unsigned len = 0;
+        std::string h = d.substr(pos, hend + 4 - pos);
+        if (sscanf(h.c_str(), "--ghframe\r\nContent-Type: %*[^\r]\r\nContent-Length: %u\r\n\r\n", &len) != 1) return -1;
+        snprintf(head, sizeof(head), "--ghframe\r\nContent-Type: %s\r\nContent-Length: %u\r\n\r\n", mime, len);
+        if (h != head) return -1;
+        size_t body = hend + 4;
+        if (body + len + 2 > d.size()) break;
+        uint8_t v = d[body];
+        for (size_t i = 0; i < len; i++) {
+            if ((uint8_t)d[body + i] != v) return -1;
+        }
+        if (d.compare(body + len, 2, "\r\n")) return -1;
+        // frame number: value byte is n & 0xff and length is n % 200 + 1
+        int n = -1;
+        for (int k = last + 1; k < last + 1 + 100000; k++) {
+            if ((k & 0xff) == v && (size_t)(k % 200 + 1) == len) {
+                n = k;
+                break;
+            }
+        }
+        if (n < 0) return -1;
+        last = n;
+        frames++;
+        pos = body + len + 2;
+    }
+    return frames;
+}
+
+struct Viewer {
+    Sock sock;
+    GHframeSender out;
+    size_t room;   // bytes accepted per tick
+    uint8_t every; // ticks between accepted writes
+};
+
+// tick producer and viewers, return frames published
+static uint32_t run(GHframes& frames, Viewer* v, uint8_t n, uint32_t ticks, uint32_t& pushed) {
+    uint8_t buf[256];
+    uint32_t published = 0;
+    for (uint32_t t = 0; t < ticks; t++) {
+        size_t len = makeFrame(pushed++, buf);
+        if (frames.push(buf, len)) published++;
+        for (uint8_t i = 0; i < n; i++) {
+            v[i].sock.room = (t % v[i].every == 0) ? v[i].room : 0;
+            size_t calls = v[i].sock.calls;
+            size_t w = v[i].out.send(frames, "image/jpeg", 1436, sockWrite, &v[i].sock);
+            CHECK(w <= 1436);
+            if (!v[i].room) {
+                CHECK(w == 0);
+                CHECK(v[i].sock.calls - calls <= 1);  // one refused write per tick, no retries
+            }
+        }
+    }
+    for (uint8_t i = 0; i < n; i++) v[i].out.reset(frames);
+    return published;
+}
+
+int main() {
+    GHframes frames;
+    CHECK(frames.begin(256));
+    uint32_t pushed = 0, published;
+    int nf, ns;
+
+    // one fast viewer gets every frame
+    {
+        Viewer v[1] = {{{}, {}, 4096, 1}};
+        published = run(frames, v, 1, 1000, pushed);
+        nf = parseParts(v[0].sock.data, "image/jpeg");
+        printf("fast: published %u of 1000, received %d\n", published, nf);
+        CHECK(published == 1000);
+        CHECK(nf == 1000);
+    }
+
+    // a slow viewer skips frames, nobody waits, the fast viewer still gets every frame
+    {
+        Viewer v[2] = {{{}, {}, 4096, 1}, {{}, {}, 23, 7}};
+        uint32_t d = frames.dropped;
+        published = run(frames, v, 2, 20000, pushed);
+        nf = parseParts(v[0].sock.data, "image/jpeg");
+        ns = parseParts(v[1].sock.data, "image/jpeg");
+        printf("fast+slow: published %u of 20000, dropped %u, fast %d, slow %d\n", published, frames.dropped - d, nf, ns);
+        CHECK(published == 20000 && frames.dropped == d);
+        CHECK(nf == 20000);
+        CHECK(ns > 0 && ns < nf);
+    }
+
+    // a stalled viewer never gets data and the sender never retries, the fast viewer gets every frame;
+    // after it leaves the stream goes on
+    {
+        Viewer v[2] = {{{}, {}, 4096, 1}, {{}, {}, 0, 1}};
+        published = run(frames, v, 2, 1000, pushed);
+        nf = parseParts(v[0].sock.data, "image/jpeg");
+        printf("fast+stalled: published %u of 1000, fast %d\n", published, nf);
+        CHECK(published == 1000 && nf == 1000);
+        CHECK(v[1].sock.data.empty());
+        Viewer f[1] = {{{}, {}, 4096, 1}};
+        published = run(frames, f, 1, 100, pushed);
+        nf = parseParts(f[0].sock.data, "image/jpeg");
+        printf("after stalled: published %u of 100, received %d\n", published, nf);
+        CHECK(published == 100 && nf == 100);
+    }
+
+    // a viewer that holds a frame without taking a byte is reported stalled after the timeout
+    {
+        Viewer v[1] = {{{}, {}, 0, 1}};
+        uint8_t buf[256];
+        CHECK(frames.push(buf, makeFrame(pushed++, buf)));
+        CHECK(v[0].out.send(frames, "image/jpeg", 1436, sockWrite, &v[0].sock) == 0);
+        CHECK(v[0].out.busy() && !v[0].out.stalled(50));
+        delay(60);
+        CHECK(v[0].out.stalled(50));
+        v[0].sock.room = 10;
+        CHECK(v[0].out.send(frames, "image/jpeg", 1436, sockWrite, &v[0].sock) == 10);
+        CHECK(!v[0].out.stalled(50));  // any progress restarts the timeout
+        v[0].out.reset(frames);
+        CHECK(!v[0].out.stalled(0));
+    }
+
+    // a frame larger than the buffer is dropped
+    uint8_t big[300] = {0};
+    uint32_t d = frames.dropped;
+    CHECK(!frames.push(big, sizeof(big)));
+    CHECK(frames.dropped == d + 1);
+
+    if (fails) return 1;
+    puts("OK");
+    return 0;
+}
@@ -0,0 +1,66 @@
+// Stress test of the send worker (src/utils/worker.h) on a std::thread. The main thread plays
+// loop(): claims, fills and commits jobs as fast as it can, with and without the out stage.
+// claim() must never wait: a full queue drops the job. Every accepted job must pass work (and out)
+// exactly once and in order, and accepted + dropped must cover all jobs.
+// Build and run: tools/host/run.sh worker_stress (CXXFLAGS="-fsanitize=thread" for races)
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "utils/worker.h"
+
+static std::atomic<bool> out_mode;
+static long worked, sent, last_w, last_s;
+static int err = 0;
+
+static void work(void*, GHjob& j) {
+    long n = atol(j.data.c_str());
+    if (n <= last_w) err++;
+    last_w = n;
+    worked++;
+    j.data += 'w';
+    j.flags |= GH_JOB_BIN;
+    if (!out_mode) sent++;
+}
+
+static void out(void*, GHjob& j) {
+    long n = atol(j.data.c_str());
+    if (n <= last_s || !(j.flags & GH_JOB_BIN) || !j.data.endsWith("w")) err++;
+    last_s = n;
+    sent++;
+}
+
+int main() {
+    for (int mode = 0; mode < 2; mode++) {
+        for (int r = 0; r < 5; r++) {
+            out_mode = mode;
+            worked = sent = 0;
+            last_w = last_s = -1;
+            GHworker w;
+            w.begin(work, mode ? out : nullptr, nullptr);
+            const long N = 100000;
+            long accepted = 0;
+            auto slow = std::chrono::microseconds(0);
+            for (long i = 0; i < N; i++) {
+                auto t0 = std::chrono::steady_clock::now();
+                GHjob* j = w.claim();
+                auto dt = std::chrono::steady_clock::now() - t0;
+                if (dt > slow) slow = std::chrono::duration_cast<std::chrono::microseconds>(dt);
+                if (j) {
+                    j->data = String(i);
+                    j->flags = 0;
+                    w.commit();
+                    accepted++;
+                }
+                if (mode && i % 37 == 0) w.flush();
+            }
+            w.end();
+            printf("mode %d: accepted %ld dropped %u worked %ld sent %ld err %d, slowest claim %ld us\n", mode, accepted,
+                   w.dropped(), worked, sent, err, (long)slow.count());
+            if (err || worked != accepted || sent != accepted || accepted + (long)w.dropped() != N) return 1;
+        }
+    }
+    puts("OK");
+    return 0;
+}
@@ -0,0 +1,503 @@
+#!/usr/bin/env python3
+"""GyverHub load generator.
+
+Opens N simulated app clients against one device (ESP or the Linux build) over
+WebSocket or MQTT and speaks the same text protocol as web/src/include/connection.js:
+discover, focus, then a weighted mix of ping / set / click / fetch_chunk.
+
+Reports per-command latency (p50/p99/max), error and timeout rates and bytes on wire.
+Only the Python standard library is used.
+
+Examples:
+    python3 tools/loadgen.py --ws 192.168.1.10 -n 8 -t 60
+    python3 tools/loadgen.py --mqtt localhost:1883 --prefix MyDevices --id 1a2b3c -n 200
+    python3 tools/loadgen.py --ws 192.168.1.10 --mix ping:4,set:2,click:1,fetch:1 --fetch /data.txt
+"""
+
+import argparse
+import asyncio
+import base64
+import json
+import os
+import random
+import re
+import struct
+import sys
+import time
+
+WS_PORT = 81
+MQTT_PORT = 1883
+TOUT = 2.8  # tout_prd приложения, с
+
+# JSON; одинарные кавычки - прошивки до перехода на строгий JSON
+RE_TYPE = re.compile(r"[\"']type[\"']:[\"']([^\"']*)[\"']")
+RE_ID = re.compile(r"[\"']id[\"']:[\"']([^\"']*)[\"']")
+RE_CHUNK = re.compile(r"[\"']chunk[\"']:(\d+)")
+RE_AMOUNT = re.compile(r"[\"']amount[\"']:(\d+)")
+
+# ожидаемые типы ответов на команду
+EXPECT = {
+    'discover': {'discover'},
+    'focus': {'ui'},
+    'ping': {'OK'},
+    'set': {'OK', 'ui', 'update'},
+    'click': {'OK', 'ui', 'update'},
+    'fetch': {'fetch_start'},
+    'fetch_chunk': {'fetch_next_chunk'},
+    'unfocus': set(),
+}
+ERRORS = {'ERR', 'fetch_err'}
+
+
+# ============================== STATS ==============================
+class Stats:
+    def __init__(self):
+        self.lat = {}
+        self.err = {}
+        self.tout = {}
+        self.tx = 0
+        self.rx = 0
+        self.conn_ok = 0
+        self.conn_fail = 0
+
+    def ok(self, cmd, ms):
+        self.lat.setdefault(cmd, []).append(ms)
+
+    def error(self, cmd):
+        self.err[cmd] = self.err.get(cmd, 0) + 1
+
+    def timeout(self, cmd):
+        self.tout[cmd] = self.tout.get(cmd, 0) + 1
+
+    @staticmethod
+    def _pct(vals, p):
+        if not vals:
+            return 0.0
+        vals = sorted(vals)
+        k = min(len(vals) - 1, max(0, int(round(p / 100.0 * len(vals) + 0.5)) - 1))
+        return vals[k]
+
+    def summary(self, elapsed):
+        cmds = sorted(set(self.lat) | set(self.err) | set(self.tout))
+        rows = []
+        for c in cmds:
+            lat = self.lat.get(c, [])
+            n = len(lat) + self.err.get(c, 0) + self.tout.get(c, 0)
+            rows.append({
+                'cmd': c,
+                'sent': n,
+                'ok': len(lat),
+                'err': self.err.get(c, 0),
+                'timeout': self.tout.get(c, 0),
+                'err_rate': (self.err.get(c, 0) + self.tout.get(c, 0)) / n if n else 0,
+                'p50_ms': round(self._pct(lat, 50), 2),
+                'p99_ms': round(self._pct(lat, 99), 2),
+                'max_ms': round(max(lat), 2) if lat else 0,
+                'rps': round(n / elapsed, 2) if elapsed else 0,
+            })
+        return {
+            'elapsed_s': round(elapsed, 2),
+            'clients_ok': self.conn_ok,
+            'clients_failed': self.conn_fail,
+            'bytes_tx': self.tx,
+            'bytes_rx': self.rx,
+            'commands': rows,
+        }
+
+
+def print_summary(s):
+    print('elapsed %.1f s, clients %d ok / %d failed, tx %d B (%.1f kB/s), rx %d B (%.1f kB/s)' % (
+        s['elapsed_s'], s['clients_ok'], s['clients_failed'],
+        s['bytes_tx'], s['bytes_tx'] / 1000.0 / max(s['elapsed_s'], 0.001),
+        s['bytes_rx'], s['bytes_rx'] / 1000.0 / max(s['elapsed_s'], 0.001)))
+    print('%-12s %7s %7s %6s %6s %7s %8s %8s %8s %7s' % ('cmd', 'sent', 'ok', 'err', 'tout', 'fail%', 'p50ms', 'p99ms', 'maxms', 'rps'))
+    for r in s['commands']:
+        print('%-12s %7d %7d %6d %6d %6.2f%% %8.2f %8.2f %8.2f %7.2f' % (
+            r['cmd'], r['sent'], r['ok'], r['err'], r['timeout'], r['err_rate'] * 100,
+            r['p50_ms'], r['p99_ms'], r['max_ms'], r['rps']))
+
+
+# ============================== TRANSPORT ==============================
+class Transport:
+    """Сообщения устройства складываются в очередь целиком (части UI склеиваются как в приложении)"""
+
+    def __init__(self, stats):
+        self.stats = stats
+        self.queue = asyncio.Queue()
+        self.buffer = ''
+
+    def _message(self, text):
+        st = text.startswith('\n{')
+        end = text.endswith('}\n')
+        if st and end:
+            self.queue.put_nowait(text)
+        elif st:
+            self.buffer = text
+        elif end:
+            self.queue.put_nowait(self.buffer + text)
+            self.buffer = ''
+        else:
+            self.buffer += text
+
+
+class WSClient(Transport):
+    def __init__(self, stats, host, port):
+        super().__init__(stats)
+        self.host = host
+        self.port = port
+
+    async def connect(self):
+        self.r, self.w = await asyncio.open_connection(self.host, self.port)
+        key = base64.b64encode(os.urandom(16)).decode()
+        req = ('GET / HTTP/1.1\r\nHost: %s:%d\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n'
+               'Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\nSec-WebSocket-Protocol: hub\r\n\r\n'
+               % (self.host, self.port, key)).encode()
+        self.w.write(req)
+        self.stats.tx += len(req)
+        hdr = await self.r.readuntil(b'\r\n\r\n')
+        self.stats.rx += len(hdr)
+        if b' 101 ' not in hdr.split(b'\r\n')[0]:
+            raise ConnectionError('handshake failed')
+        self.task = asyncio.ensure_future(self._reader())
+
+    async def _reader(self):
+        msg = b''
+        try:
+            while True:
+                h = await self.r.readexactly(2)
+                n = h[1] & 0x7f
+                extra = 0
+                if n == 126:
+                    n = struct.unpack('>H', await self.r.readexactly(2))[0]
+                    extra = 2
+                elif n == 127:
+                    n = struct.unpack('>Q', await self.r.readexactly(8))[0]
+                    extra = 8
+                data = await self.r.readexactly(n) if n else b''
+                self.stats.rx += 2 + extra + n
+                op = h[0] & 0x0f
+                if op in (0, 1):
+                    msg += data
+                    if h[0] & 0x80:
+                        self._message(msg.decode('utf-8', 'replace'))
+                        msg = b''
+                elif op == 9:
+                    self._frame(0xA, data)
+                elif op == 8:
+                    break
+        except (asyncio.IncompleteReadError, ConnectionError, OSError):
+            pass
+        self.queue.put_nowait(None)
+
+    def _frame(self, op, data):
+        mask = os.urandom(4)
+        n = len(data)
+        if n < 126:
+            hdr = struct.pack('>BB', 0x80 | op, 0x80 | n)
+        elif n < 65536:
+            hdr = struct.pack('>BBH', 0x80 | op, 0x80 | 126, n)
+        else:
+            hdr = struct.pack('>BBQ', 0x80 | op, 0x80 | 127, n)
+        body = bytes(b ^ mask[i & 3] for i, b in enumerate(data))
+        self.w.write(hdr + mask + body)
+        self.stats.tx += len(hdr) + 4 + n
+
+    def send(self, uri, name, value):
+        if name:
+            uri += '/' + name
+        if value != '':
+            uri += '=' + str(value)
+        self._frame(0x1, uri.encode())
+
+    async def close(self):
+        try:
+            self._frame(0x8, b'\x03\xe8')
+            self.w.close()
+        except Exception:
+            pass
+
+
+class MQTTClient(Transport):
+    def __init__(self, stats, host, port, sub, login=None, password=None):
+        super().__init__(stats)
+        self.host = host
+        self.port = port
+        self.sub = sub
+        self.login = login
+        self.password = password
+        self.pid = 0
+
+    @staticmethod
+    def _len(n):
+        out = b''
+        while True:
+            b = n & 0x7f
+            n >>= 7
+            out += bytes([b | (0x80 if n else 0)])
+            if not n:
+                return out
+
+    @staticmethod
+    def _str(s):
+        s = s.encode() if isinstance(s, str) else s
+        return struct.pack('>H', len(s)) + s
+
+    def _packet(self, t, body):
+        p = bytes([t]) + self._len(len(body)) + body
+        self.w.write(p)
+        self.stats.tx += len(p)
+
+    async def _read_packet(self):
+        t = (await self.r.readexactly(1))[0]
+        n = mult = 0
+        cnt = 1
+        while True:
+            b = (await self.r.readexactly(1))[0]
+            cnt += 1
+            n |= (b & 0x7f) << mult
+            mult += 7
+            if not b & 0x80:
+                break
+        body = await self.r.readexactly(n) if n else b''
+        self.stats.rx += cnt + n
+        return t, body
+
+    async def connect(self):
+        self.r, self.w = await asyncio.open_connection(self.host, self.port)
+        flags = 0x02
+        payload = self._str('HUB-%08x' % random.getrandbits(32))
+        if self.login:
+            flags |= 0x80
+            payload += self._str(self.login)
+            if self.password:
+                flags |= 0x40
+                payload += self._str(self.password)
+        self._packet(0x10, self._str('MQTT') + bytes([4, flags]) + struct.pack('>H', 60) + payload)
+        t, body = await self._read_packet()
+        if t >> 4 != 2 or len(body) < 2 or body[1]:
+            raise ConnectionError('CONNACK refused')
+        self.pid += 1
+        self._packet(0x82, struct.pack('>H', self.pid) + self._str(self.sub) + b'\x00')
+        self.task = asyncio.ensure_future(self._reader())
+        self.ping = asyncio.ensure_future(self._pinger())
+
+    async def _pinger(self):
+        while True:
+            await asyncio.sleep(30)
+            self._packet(0xC0, b'')
+
+    async def _reader(self):
+        try:
+            while True:
+                t, body = await self._read_packet()
+                if t >> 4 == 3:
+                    qos = (t >> 1) & 3
+                    tl = struct.unpack('>H', body[:2])[0]
+                    off = 2 + tl + (2 if qos else 0)
+                    if qos == 1:
+                        self._packet(0x40, body[2 + tl:off])
+                    self._message(body[off:].decode('utf-8', 'replace'))
+        except (asyncio.IncompleteReadError, ConnectionError, OSError):
+            pass
+        self.queue.put_nowait(None)
+
+    def publish(self, topic, payload):
+        self._packet(0x30, self._str(topic) + str(payload).encode())
+
+    def send(self, uri, name, value):
+        if name:
+            uri += '/' + name
+        self.publish(uri, value)
+
+    async def close(self):
+        try:
+            self.ping.cancel()
+            self._packet(0xE0, b'')
+            self.w.close()
+        except Exception:
+            pass
+
+
+# ============================== CLIENT ==============================
+class Client:
+    def __init__(self, args, stats, num):
+        self.args = args
+        self.stats = stats
+        self.hub_id = 'LG%06x' % ((os.getpid() * 1000 + num) & 0xffffff)
+        self.dev = args.id
+        self.tr = None
+
+    def _transport(self):
+        a = self.args
+        if a.ws:
+            return WSClient(self.stats, a.host, a.port)
+        sub = '%s/hub/%s/#' % (a.prefix, self.hub_id)
+        return MQTTClient(self.stats, a.host, a.port, sub, a.login, a.password)
+
+    async def request(self, cmd, name='', value='', track=True):
+        """Отправить команду и дождаться ответа ожидаемого типа. Вернёт текст ответа или None"""
+        if cmd == 'discover':
+            if self.args.ws:
+                uri = self.args.prefix + ('/' + self.dev if self.dev else '')
+                self.tr.send(uri, '', '')
+            else:
+                self.tr.publish(self.args.prefix + ('/' + self.dev if self.dev else ''), self.hub_id)
+        else:
+            uri = '%s/%s/%s/%s' % (self.args.prefix, self.dev, self.hub_id, cmd)
+            self.tr.send(uri, name, value)
+
+        expect = EXPECT.get(cmd, {'OK'})
+        t0 = time.perf_counter()
+        deadline = t0 + self.args.timeout
+        while True:
+            left = deadline - time.perf_counter()
+            if left <= 0:
+                if track:
+                    self.stats.timeout(cmd)
+                return None
+            try:
+                msg = await asyncio.wait_for(self.tr.queue.get(), left)
+            except asyncio.TimeoutError:
+                continue
+            if msg is None:
+                raise ConnectionError('closed')
+            m = RE_TYPE.findall(msg)  # тип пакета - последний, в UI до него идут типы компонентов
+            mtype = m[-1] if m else ''
+            if mtype in expect:
+                if cmd == 'discover' and not self.dev:
+                    self.dev = RE_ID.search(msg).group(1)
+                if track:
+                    self.stats.ok(cmd, (time.perf_counter() - t0) * 1000.0)
+                return msg
+            if mtype in ERRORS:
+                if track:
+                    self.stats.error(cmd)
+                return None
+            # прочие сообщения (update, print, ответы другим командам) пропускаются
+
+    async def fetch(self):
+        if await self.request('fetch', self.args.fetch) is None:
+            return
+        while True:
+            msg = await self.request('fetch_chunk')
+            if msg is None:
+                return
+            m1, m2 = RE_CHUNK.search(msg), RE_AMOUNT.search(msg)
+            if not m1 or not m2 or int(m1.group(1)) + 1 >= int(m2.group(1)):
+                return
+
+    async def run(self, stop_at, mix):
+        self.tr = self._transport()
+        try:
+            await asyncio.wait_for(self.tr.connect(), self.args.timeout)
+        except Exception:
+            self.stats.conn_fail += 1
+            return
+        self.stats.conn_ok += 1
+        try:
+            await self.request('discover')
+            if not self.dev:
+                return
+            await self.request('focus')
+            cmds, weights = zip(*mix)
+            press = 0
+            while time.monotonic() < stop_at:
+                await asyncio.sleep(self.args.period / 1000.0 * random.uniform(0.8, 1.2))
+                cmd = random.choices(cmds, weights)[0]
+                if cmd == 'ping':
+                    await self.request('ping')
+                elif cmd == 'set':
+                    await self.request('set', self.args.name, self.args.value or random.randint(0, 100))
+                elif cmd == 'click':
+                    press ^= 1
+                    await self.request('click', self.args.name, press)
+                elif cmd == 'focus':
+                    await self.request('focus')
+                elif cmd == 'fetch' and self.args.fetch:
+                    await self.fetch()
+            self.tr.send('%s/%s/%s/unfocus' % (self.args.prefix, self.dev, self.hub_id), '', '')
+        except ConnectionError:
+            self.stats.conn_fail += 1
+        finally:
+            await self.tr.close()
+
+
+# ============================== MAIN ==============================
+def parse_mix(s):
+    mix = []
+    for part in s.split(','):
+        if not part:
+            continue
+        name, _, w = part.partition(':')
+        if name not in ('ping', 'set', 'click', 'focus', 'fetch'):
+            raise SystemExit('unknown command in --mix: ' + name)
+        mix.append((name, float(w or 1)))
+    if not mix:
+        raise SystemExit('empty --mix')
+    return mix
+
+
+async def main_async(args):
+    stats = Stats()
+    mix = parse_mix(args.mix)
+    if not args.id:
+        # узнать ID устройства одним клиентом
+        probe = Client(args, Stats(), 0)
+        probe.tr = probe._transport()
+        await probe.tr.connect()
+        await probe.request('discover', track=False)
+        await probe.tr.close()
+        if not probe.dev:
+            raise SystemExit('device not found')
+        args.id = probe.dev
+        print('device id: ' + args.id, file=sys.stderr)
+
+    start = time.monotonic()
+    stop_at = start + args.duration
+    tasks = []
+    for i in range(args.clients):
+        tasks.append(asyncio.ensure_future(Client(args, stats, i + 1).run(stop_at, mix)))
+        if args.ramp:
+            await asyncio.sleep(args.ramp / 1000.0)
+    await asyncio.gather(*tasks)
+    return stats.summary(time.monotonic() - start)
+
+
+def main():
+    p = argparse.ArgumentParser(description='GyverHub load generator')
+    g = p.add_mutually_exclusive_group(required=True)
+    g.add_argument('--ws', metavar='HOST[:PORT]', help='device address, WebSocket (port %d)' % WS_PORT)
+    g.add_argument('--mqtt', metavar='HOST[:PORT]', help='broker address (port %d)' % MQTT_PORT)
+    p.add_argument('--prefix', default='MyDevices', help='network prefix')
+    p.add_argument('--id', help='device ID (found by discover if omitted)')
+    p.add_argument('--login', help='MQTT login')
+    p.add_argument('--password', help='MQTT password')
+    p.add_argument('-n', '--clients', type=int, default=4, help='simulated clients')
+    p.add_argument('-t', '--duration', type=float, default=30, help='test duration, s')
+    p.add_argument('--period', type=float, default=1000, help='mean delay between commands per client, ms')
+    p.add_argument('--ramp', type=float, default=50, help='delay between client starts, ms')
+    p.add_argument('--timeout', type=float, default=TOUT, help='answer timeout, s')
+    p.add_argument('--mix', default='ping:5,set:2,click:1', help='command weights: ping,set,click,focus,fetch')
+    p.add_argument('--name', default='', help='component name for set/click')
+    p.add_argument('--value', default='', help='value for set (random 0..100 if omitted)')
+    p.add_argument('--fetch', help='file path for fetch/fetch_chunk')
+    p.add_argument('--json', action='store_true', help='print summary as JSON')
+    args = p.parse_args()
+
+    addr = args.ws or args.mqtt
+    host, _, port = addr.partition(':')
+    args.host = host
+    args.port = int(port) if port else (WS_PORT if args.ws else MQTT_PORT)
+
+    try:
+        summary = asyncio.run(main_async(args))
+    except KeyboardInterrupt:
+        return
+    if args.json:
+        print(json.dumps(summary, indent=2))
+    else:
+        print_summary(summary)
+
+
+if __name__ == '__main__':
+    main()
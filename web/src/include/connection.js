@@ -1,5 +1,6 @@
 const http_port = 80;
 const ws_port = 81;
+const stream_port = 82;
 const tout_prd = 2800;
 const ping_prd = 3000;
 const oninput_prd = 100;
@@ -59,6 +60,10 @@ function post(cmd, name = '', value = '') {
   reset_tout();
   log('Post to #' + id + ' via ' + ConnNames[devices_t[id].conn] + ', cmd=' + cmd + (name ? (', name=' + name) : '') + (value ? (', value=' + value) : ''))
 }
+// client capabilities: def - default values, sk - short keys, lz - compression, mp - MessagePack
+function post_focus() {
+  post('focus', '', (devices[focused].bin == 'mp') ? 'def,sk,lz,mp' : 'def,sk,lz');
+}
 function release_all() {
   if (pressId) post('click', pressId, 0);
   pressId = null;
@@ -122,7 +127,7 @@ function reset_ping() {
   ping_interval = setInterval(() => {
     if (refresh_ui) {
       refresh_ui = false;
-      post('focus');
+      post_focus();
     } else {
       post('ping');
     }
@@ -196,6 +201,7 @@ function mq_start() {
 
   mq_client.on('message', function (topic, text) {
     topic = topic.toString();
+    let raw = text;
     text = text.toString();
     for (pref of mq_pref_list) {
       // prefix/hub
@@ -209,6 +215,10 @@ function mq_start() {
           parseDevice(id, text, Conn.MQTT);
           return;
         }
+        if (binIs(raw)) {
+          parseDevice(id, raw, Conn.MQTT);
+          return;
+        }
 
         let st = text.startsWith('\n{');
         let end = text.endsWith('}\n');
@@ -274,12 +284,13 @@ function ws_start(id) {
   log(`WS ${id} open...`);
 
   devices_t[id].ws = new WebSocket(`ws://${devices[id].ip}:${ws_port}/`, ['hub']);
+  devices_t[id].ws.binaryType = 'arraybuffer';
 
   devices_t[id].ws.onopen = function () {
     log(`WS ${id} opened`);
     if (ws_focus_flag) {
       ws_focus_flag = false;
-      post('focus');
+      post_focus();
     }
     if (id != focused) devices_t[id].ws.close();
   };
@@ -297,6 +308,10 @@ function ws_start(id) {
 
   devices_t[id].ws.onmessage = function (event) {
     reset_tout();
+    if (typeof event.data != 'string') {
+      parseDevice(id, new Uint8Array(event.data), Conn.WS);
+      return;
+    }
     let st = event.data.startsWith('\n{');
     let end = event.data.endsWith('}\n');
     if (st && end) parseDevice(id, event.data, Conn.WS);
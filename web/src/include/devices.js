@@ -7,11 +7,13 @@ let touch = 0;
 let pressId = null;
 let dup_names = [];
 let gauges = {};
+let charts = {};
 let canvases = {};
 let pickers = {};
 let joys = {};
 let prompts = {};
 let confirms = {};
+let logs = {};
 
 let wid_row_id = null;
 let wid_row_count = 0;
@@ -590,7 +592,8 @@ function addLog(ctrl) {
   if (checkDup(ctrl)) return;
   checkWidget(ctrl);
   endButtons();
-  if (ctrl.text.endsWith('\n')) ctrl.text = ctrl.text.slice(0, -1);
+  logs[ctrl.name] = { seq: ctrl.seq, tail: '' };
+  if (ctrl.text.endsWith('\n')) ctrl.text = ctrl.text.slice(0, -1), logs[ctrl.name].tail = '\n';
   if (wid_row_id) {
     let inner = `
     <textarea id="#${ctrl.name}" title='${ctrl.name}' class="cfg_inp c_log text_t" readonly>${ctrl.text}</textarea>
@@ -675,6 +678,25 @@ function addGauge(ctrl) {
   }
   gauges[ctrl.name] = { perc: null, name: ctrl.name, value: Number(ctrl.value), min: Number(ctrl.min), max: Number(ctrl.max), step: Number(ctrl.step), text: ctrl.text, color: ctrl.color };
 }
+function addChart(ctrl) {
+  if (checkDup(ctrl)) return;
+  checkWidget(ctrl);
+  endButtons();
+  if (wid_row_id) {
+    let inner = `
+    <canvas class="chart_t" id="#${ctrl.name}"></canvas>
+    `;
+    addWidget(ctrl.tab_w, ctrl.name, ctrl.wlabel, inner);
+  } else {
+    EL('controls').innerHTML += `
+    <div class="cv_block cv_block_back">
+      <canvas class="chart_t" id="#${ctrl.name}"></canvas>
+    </div>
+    `;
+  }
+  charts[ctrl.name] = { name: ctrl.name, size: Number(ctrl.size), color: ctrl.color, points: [] };
+  appendChart(charts[ctrl.name], ctrl.value);
+}
 function addImage(ctrl) {
   checkWidget(ctrl);
   endButtons();
@@ -694,15 +716,16 @@ function addImage(ctrl) {
 function addStream(ctrl) {
   checkWidget(ctrl);
   endButtons();
+  let src = (devices[focused].ip != 'unset') ? `http://${devices[focused].ip}:${ctrl.port ? ctrl.port : stream_port}/` : '';
   if (wid_row_id) {
     let inner = `
-    
+    <img src="${src}" style="width: 100%">
     `;
     addWidget(ctrl.tab_w, '', ctrl.wlabel, inner);
   } else {
     EL('controls').innerHTML += `
     <div class="cv_block cv_block_back">
-      
+      <img src="${src}" style="width: 100%">
     </div>
     `;
   }
@@ -993,6 +1016,65 @@ function drawGauge(g) {
   cx.fillText(g.min, cx.lineWidth, cv.height * 0.92);
   cx.fillText(g.max, cv.width - cx.lineWidth, cv.height * 0.92);
 }
+function appendChart(c, text) {
+  let last = c.points.length ? c.points[c.points.length - 1][0] : -1;
+  text.split(';').forEach(p => {
+    if (!p) return;
+    let tv = p.split(',');
+    let t = Number(tv[0]);
+    if (t > last) c.points.push([t, Number(tv[1])]), last = t;   // точки из интерфейса не дублируются
+  });
+  if (c.points.length > c.size) c.points.splice(0, c.points.length - c.size);
+}
+function drawChart(c) {
+  let cv = EL('#' + c.name);
+  if (!cv || !cv.parentNode.clientWidth) return;
+  let cx = cv.getContext("2d");
+  let v = themes[cfg.theme];
+  let col = c.color == null ? intToCol(colors[cfg.maincolor]) : intToCol(c.color);
+  let rw = cv.parentNode.clientWidth;
+  let rh = Math.floor(rw * 0.5);
+  cv.style.width = rw + 'px';
+  cv.style.height = rh + 'px';
+  cv.width = Math.floor(rw * ratio());
+  cv.height = Math.floor(rh * ratio());
+  cx.clearRect(0, 0, cv.width, cv.height);
+  if (!c.points.length) return;
+
+  let t0 = c.points[0][0], t1 = c.points[c.points.length - 1][0];
+  let min = Infinity, max = -Infinity;
+  c.points.forEach(p => { min = Math.min(min, p[1]); max = Math.max(max, p[1]); });
+  if (min == max) min -= 1, max += 1;
+
+  let font = cfg.font;
+  /*NON-ESP*/
+  font = 'PTSans Narrow';
+  /*/NON-ESP*/
+  let fs = 12 * ratio();
+  let pad = fs;
+  let w = cv.width, h = cv.height - pad * 2;
+  let x = (t) => (t1 == t0) ? w : (t - t0) * w / (t1 - t0);
+  let y = (val) => pad + h - (val - min) * h / (max - min);
+
+  cx.lineWidth = 2 * ratio();
+  cx.strokeStyle = col;
+  cx.beginPath();
+  c.points.forEach((p, i) => i ? cx.lineTo(x(p[0]), y(p[1])) : cx.moveTo(x(p[0]), y(p[1])));
+  cx.stroke();
+
+  cx.fillStyle = theme_cols[v][3];
+  cx.font = fs + 'px ' + font;
+  cx.textAlign = "left";
+  cx.fillText(Math.round(max * 100) / 100, 0, fs * 0.9);
+  cx.fillText(Math.round(min * 100) / 100, 0, cv.height - fs * 0.1);
+  cx.textAlign = "right";
+  cx.fillText(Math.round(c.points[c.points.length - 1][1] * 100) / 100, w, fs * 0.9);
+}
+function showCharts() {
+  Object.values(charts).forEach(chart => {
+    drawChart(chart);
+  });
+}
 function showGauges() {
   Object.values(gauges).forEach(gauge => {
     drawGauge(gauge);
@@ -3,21 +3,32 @@ let fs_arr = [];
 let fetching = null;
 let fetch_name;
 let fetch_index;
+let fetch_path;
 let fetch_file = '';
+let fetch_lz = null;
 let fetch_tout;
 
 let uploading = null;
 let upload_tout;
-let upload_bytes = [];
+let upload_all = [];
+let upload_pos = 0;
 let upload_size;
+let upload_path;
+let upload_token;
+let upload_lz = null;
 let ota_tout;
 
+const fs_retries = 3;
+let fs_retry = 0;
+
 // ============ TIMEOUT ============
 function stopFS() {
   stop_fetch_tout();
   stop_upload_tout();
   stop_ota_tout();
-  upload_bytes = [];
+  upload_all = [];
+  upload_lz = null;
+  fetch_lz = null;
   fetching = null;
   uploading = null;
 }
@@ -27,6 +38,11 @@ function stop_fetch_tout() {
 function reset_fetch_tout() {
   stop_fetch_tout();
   fetch_tout = setTimeout(() => {
+    if (fs_retry++ < fs_retries) {  // resume from received bytes
+      post('fetch', fetch_path, fetch_file.length + ',lz');
+      reset_fetch_tout();
+      return;
+    }
     stopFS();
     EL('process#' + fetch_index).innerHTML = 'Error!';
   }, tout_prd);
@@ -37,6 +53,11 @@ function stop_upload_tout() {
 function reset_upload_tout() {
   stop_upload_tout();
   upload_tout = setTimeout(() => {
+    if (upload_token && fs_retry++ < fs_retries) {  // resume the session, device replies with offset
+      post('upload', upload_path, upload_token + ',lz');
+      reset_upload_tout();
+      return;
+    }
     stopFS();
     EL('file_upload_btn').innerHTML = 'Error!';
     setTimeout(() => EL('file_upload_btn').innerHTML = 'Upload', 2000);
@@ -119,7 +140,10 @@ function fetchFile(i) {
   let path = fs_arr[i];
   fetch_index = i;
   fetch_name = path.split('/').pop();
-  post('fetch', path);
+  fetch_path = path;
+  fetch_file = '';
+  fs_retry = 0;
+  post('fetch', path, '0,lz');
 }
 function openFile(src) {
   let w = window.open();
@@ -141,26 +165,36 @@ function uploadFile(arg) {
     if (!e.target.result) return;
     let buffer = new Uint8Array(e.target.result);
     if (!confirm('Upload ' + file_upload_path.value + arg.files[0].name + ' (' + buffer.length + ' bytes)?')) return;
-    upload_bytes = [];
-    for (b of buffer) upload_bytes.push(b);
-    upload_size = upload_bytes.length;
-    post('upload', file_upload_path.value + arg.files[0].name);
+    upload_all = buffer;
+    upload_size = upload_all.length;
+    upload_path = file_upload_path.value + arg.files[0].name;
+    upload_token = null;
+    fs_retry = 0;
+    post('upload', upload_path, ',lz');
     arg.value = null;
   }
 
   reader.readAsArrayBuffer(arg.files[0]);
 }
-function uploadNextChunk() {
-  let i = 0;
+function startUpload(device) {
+  upload_pos = device.offset || 0;
+  upload_lz = (device.comp == 'lz') ? lzEncoder(upload_all, upload_pos) : null;
+}
+function nextUploadChunk() {
+  let max = Math.ceil(devices[focused].max_upl * 3 / 4);
   let data = '';
-  while (true) {
-    if (!upload_bytes.length) break;
-    i++;
-    data += String.fromCharCode(upload_bytes.shift());
-    if (i >= devices[focused].max_upl * 3 / 4) break;
+  if (upload_lz) {
+    [data, upload_pos] = lzEncode(upload_lz, upload_pos, max);
+  } else {
+    let end = Math.min(upload_pos + max, upload_size);
+    while (upload_pos < end) data += String.fromCharCode(upload_all[upload_pos++]);
   }
-  EL('file_upload_btn').innerHTML = Math.round((upload_size - upload_bytes.length) / upload_size * 100) + '%';
-  post('upload_chunk', (upload_bytes.length) ? 'next' : 'last', window.btoa(data));
+  return window.btoa(data);
+}
+function uploadNextChunk() {
+  let data = nextUploadChunk();
+  EL('file_upload_btn').innerHTML = Math.round(upload_pos / upload_size * 100) + '%';
+  post('upload_chunk', (upload_pos < upload_size) ? 'next' : 'last', data);
 }
 
 // ============== OTA ==============
@@ -174,29 +208,136 @@ function uploadOta(arg, type) {
 
   reader.onload = function (e) {
     if (!e.target.result) return;
-    let buffer = new Uint8Array(e.target.result);
-    upload_bytes = [];
-    for (b of buffer) upload_bytes.push(b);
-    upload_size = upload_bytes.length;
-    post('ota', type);
+    upload_all = new Uint8Array(e.target.result);
+    upload_size = upload_all.length;
+    post('ota', type, 'lz');
     arg.value = null;
   }
 
   reader.readAsArrayBuffer(arg.files[0]);
 }
 function otaNextChunk() {
-  let i = 0;
-  let data = '';
-  while (true) {
-    if (!upload_bytes.length) break;
-    i++;
-    data += String.fromCharCode(upload_bytes.shift());
-    if (i >= devices[focused].max_upl * 3 / 4) break;
-  }
-  EL('ota_label').innerHTML = Math.round((upload_size - upload_bytes.length) / upload_size * 100) + '%';
-  post('ota_chunk', (upload_bytes.length) ? 'next' : 'last', window.btoa(data));
+  let data = nextUploadChunk();
+  EL('ota_label').innerHTML = Math.round(upload_pos / upload_size * 100) + '%';
+  post('ota_chunk', (upload_pos < upload_size) ? 'next' : 'last', data);
 }
 function otaUrl(url, type) {
   post('ota_url', type, url);
   showPopup('OTA start');
-}
\ No newline at end of file
+}
+
+// ============== LZ ===============
+// LZSS as in utils/lz.h: flag byte (LSB first, 1 = literal) + up to 8 items,
+// reference = 2 bytes: 10 bit distance-1, 6 bit length-3. A chunk ends with a whole group
+const lz_win = 1024;
+const lz_min = 3;
+const lz_max = 66;
+
+function lzEncoder(src, base) {
+  return { src: src, base: base, head: new Int32Array(4096).fill(-1), prev: new Int32Array(src.length) };
+}
+function lzEncode(st, pos, limit) {
+  let s = st.src;
+  let out = '';
+  let grp = [0];
+  let bits = 0;
+  let put = (p) => {
+    if (p + 2 >= s.length) return;
+    let h = ((s[p] << 4) ^ (s[p + 1] << 2) ^ s[p + 2]) & 4095;
+    st.prev[p] = st.head[h];
+    st.head[h] = p;
+  }
+  while (pos < s.length && out.length + grp.length + 3 <= limit) {
+    let best = 0, dist = 0;
+    if (pos + 2 < s.length) {
+      let maxl = Math.min(s.length - pos, lz_max);
+      let cand = st.head[((s[pos] << 4) ^ (s[pos + 1] << 2) ^ s[pos + 2]) & 4095];
+      for (let n = 0; n < 8 && cand >= st.base && pos - cand <= lz_win; n++) {
+        let l = 0;
+        while (l < maxl && s[cand + l] == s[pos + l]) l++;
+        if (l > best) {
+          best = l;
+          dist = pos - cand;
+          if (l == maxl) break;
+        }
+        cand = st.prev[cand];
+      }
+    }
+    if (best >= lz_min) {
+      grp.push((dist - 1) & 0xff, (((dist - 1) >> 8) << 6) | (best - lz_min));
+      for (let k = 0; k < best; k++) put(pos++);
+    } else {
+      grp[0] |= 1 << bits;
+      grp.push(s[pos]);
+      put(pos++);
+    }
+    if (++bits == 8) {
+      out += String.fromCharCode(...grp);
+      grp = [0];
+      bits = 0;
+    }
+  }
+  if (bits) out += String.fromCharCode(...grp);
+  return [out, pos];
+}
+function lzDecoder() {
+  return { win: new Uint8Array(lz_win), pos: 0 };
+}
+function lzDecode(st, data) {
+  let out = '';
+  let flags = 0, bits = 0;
+  let put = (c) => {
+    st.win[st.pos++ % lz_win] = c;
+    out += String.fromCharCode(c);
+  }
+  for (let i = 0; i < data.length;) {
+    if (!bits) {
+      flags = data.charCodeAt(i++);
+      bits = 8;
+      continue;
+    }
+    if (flags & 1) put(data.charCodeAt(i++));
+    else {
+      let b1 = data.charCodeAt(i + 1);
+      let dist = (data.charCodeAt(i) | ((b1 >> 6) << 8)) + 1;
+      let len = (b1 & 0x3f) + lz_min;
+      i += 2;
+      while (len--) put(st.win[(st.pos - dist) % lz_win]);
+    }
+    flags >>= 1;
+    bits--;
+  }
+  return out;
+}
+// whole answer packed by GH_lzPack (without the frame byte) -> bytes
+function lzUnpack(data) {
+  let out = new Uint8Array(data.length * 4);
+  let len = 0;
+  let flags = 0, bits = 0;
+  let put = (c) => {
+    if (len == out.length) {
+      let grow = new Uint8Array(out.length * 2);
+      grow.set(out);
+      out = grow;
+    }
+    out[len++] = c;
+  }
+  for (let i = 0; i < data.length;) {
+    if (!bits) {
+      flags = data[i++];
+      bits = 8;
+      continue;
+    }
+    if (flags & 1) put(data[i++]);
+    else {
+      let dist = (data[i] | ((data[i + 1] >> 6) << 8)) + 1;
+      let n = (data[i + 1] & 0x3f) + lz_min;
+      i += 2;
+      if (dist > len) throw 'lz';
+      while (n--) put(out[len - dist]);
+    }
+    flags >>= 1;
+    bits--;
+  }
+  return out.subarray(0, len);
+}
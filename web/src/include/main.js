@@ -150,6 +150,8 @@ function render_main(v) {
             <button onclick="ota_upload.click()" class="c_btn btn_mini">Flash</button>
             <input type="file" id="ota_upload_fs" style="display:none" onchange="uploadOta(this, 'fs')">
             <button onclick="ota_upload_fs.click()" class="c_btn btn_mini">Filesystem</button>
+            <input type="file" id="ota_upload_delta" accept=".ghdp" style="display:none" onchange="uploadOta(this, 'delta')">
+            <button onclick="ota_upload_delta.click()" class="c_btn btn_mini">Delta</button>
           </div>
           <label style="font-size:18px" id="ota_label">IDLE</label>
         </div>
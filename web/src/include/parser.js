@@ -20,7 +20,8 @@ function applyUpdate(name, value) {
   let el = EL('#' + name);
   if (!el) return;
   cl = el.classList;
-  if (cl.contains('icon_t')) el.style.color = value;
+  if (cl.contains('c_log') && typeof value === 'object') appendLog(el, name, value);
+  else if (cl.contains('icon_t')) el.style.color = value;
   else if (cl.contains('text_t')) el.innerHTML = value;
   else if (cl.contains('input_t')) el.value = value;
   else if (cl.contains('date_t')) el.value = new Date(ctrl.value * 1000).toISOString().split('T')[0];
@@ -37,6 +38,12 @@ function applyUpdate(name, value) {
       }
     }
   }
+  else if (cl.contains('chart_t')) {
+    if (name in charts) {
+      appendChart(charts[name], value);
+      drawChart(charts[name]);
+    }
+  }
   else if (cl.contains('gauge_t')) {
     if (name in gauges) {
       gauges[name].value = Number(value);
@@ -52,6 +59,21 @@ function applyUpdate(name, value) {
     }
   }
 }
+function appendLog(el, name, upd) {
+  let log = logs[name];
+  if (!log || upd.to <= log.seq) return;
+  let text = upd.add;
+  if (upd.from < log.seq) {   // часть строк уже пришла в интерфейсе
+    let bytes = new TextEncoder().encode(text);
+    text = new TextDecoder().decode(bytes.slice(log.seq - upd.from));
+  }
+  log.seq = upd.to;
+  text = log.tail + text;
+  log.tail = '';
+  if (text.endsWith('\n')) text = text.slice(0, -1), log.tail = '\n';
+  el.textContent += text;
+  el.scrollTop = el.scrollHeight;
+}
 function updateDevice(mem, dev) {
   mem.id = dev.id;
   mem.name = dev.name;
@@ -60,6 +82,7 @@ function updateDevice(mem, dev) {
   mem.version = dev.version;
   mem.max_upl = dev.max_upl;
   mem.esp = dev.esp;
+  mem.bin = dev.bin;
   save_devices();
 }
 function compareDevice(mem, dev) {
@@ -69,15 +92,101 @@ function compareDevice(mem, dev) {
     mem.PIN != dev.PIN ||
     mem.version != dev.version ||
     mem.max_upl != dev.max_upl ||
-    mem.esp != dev.esp;
+    mem.esp != dev.esp ||
+    mem.bin != dev.bin;
+}
+// ============ MSGPACK ============
+// binary packets (utils/msgpack.h), requested by focus=mp if discover has bin:'mp'
+// LZ frame (0xc1) or MessagePack
+function binIs(buf) {
+  return (typeof buf != 'string') && buf.length && (buf[0] == 0xc1 || mpIs(buf));
+}
+function mpIs(buf) {
+  return (typeof buf != 'string') && buf.length && ((buf[0] & 0xf0) == 0x80 || buf[0] == 0xde || buf[0] == 0xdf);
 }
+function mpDecode(buf) {
+  let view = new DataView(buf.buffer, buf.byteOffset, buf.byteLength);
+  let dec = new TextDecoder();
+  let pos = 0;
+  function num(get, len) {
+    let v = view[get](pos);
+    pos += len;
+    return Number(v);
+  }
+  function str(len) {
+    let v = dec.decode(buf.subarray(pos, pos + len));
+    pos += len;
+    return v;
+  }
+  function arr(len) {
+    let v = [];
+    while (len--) v.push(val());
+    return v;
+  }
+  function map(len) {
+    let v = {};
+    while (len--) {
+      let key = val();
+      v[key] = val();
+    }
+    return v;
+  }
+  function val() {
+    if (pos >= buf.length) throw 'msgpack';
+    let b = buf[pos++];
+    if (b < 0x80) return b;
+    if (b < 0x90) return map(b & 0xf);
+    if (b < 0xa0) return arr(b & 0xf);
+    if (b < 0xc0) return str(b & 0x1f);
+    if (b >= 0xe0) return b - 0x100;
+    switch (b) {
+      case 0xc0: return null;
+      case 0xc2: return false;
+      case 0xc3: return true;
+      case 0xca: return num('getFloat32', 4);
+      case 0xcb: return num('getFloat64', 8);
+      case 0xcc: return num('getUint8', 1);
+      case 0xcd: return num('getUint16', 2);
+      case 0xce: return num('getUint32', 4);
+      case 0xcf: return num('getBigUint64', 8);
+      case 0xd0: return num('getInt8', 1);
+      case 0xd1: return num('getInt16', 2);
+      case 0xd2: return num('getInt32', 4);
+      case 0xd3: return num('getBigInt64', 8);
+      case 0xd9: return str(num('getUint8', 1));
+      case 0xda: return str(num('getUint16', 2));
+      case 0xdb: return str(num('getUint32', 4));
+      case 0xdc: return arr(num('getUint16', 2));
+      case 0xdd: return arr(num('getUint32', 4));
+      case 0xde: return map(num('getUint16', 2));
+      case 0xdf: return map(num('getUint32', 4));
+    }
+    throw 'msgpack';
+  }
+  let v = val();
+  if (pos != buf.length) throw 'msgpack';
+  return v;
+}
+
+// firmware before strict JSON sends single quotes
+function parseLegacy(text) {
+  try {
+    return JSON.parse(text.replaceAll("\'", "\""));
+  } catch (e) {
+    return null;
+  }
+}
+
+// text: JSON string, MessagePack bytes or LZ frame with one of them
 function parseDevice(fromID, text, conn, ip = 'unset') {
   let device;
   try {
-    device = JSON.parse(text.replaceAll("\'", "\""));
+    if (typeof text != 'string' && text[0] == 0xc1) text = lzUnpack(text.subarray(1));
+    if (mpIs(text)) device = mpDecode(text);
+    else device = JSON.parse((typeof text == 'string') ? text : new TextDecoder().decode(text));
   } catch (e) {
-    log('Wrong packet (JSON)');
-    return;
+    device = (typeof text == 'string') ? parseLegacy(text) : null;
+    if (!device) return log('Wrong packet (JSON)');
   }
 
   let id = device.id;
@@ -165,8 +274,8 @@ function parseDevice(fromID, text, conn, ip = 'unset') {
 
     case 'ui':
       if (id != focused) return;
-      devices_t[id].controls = device.controls;
-      showControls(device.controls, id);
+      devices_t[id].controls = expandControls(device.controls);
+      showControls(devices_t[id].controls, id);
       break;
 
     case 'info':
@@ -206,7 +315,8 @@ function parseDevice(fromID, text, conn, ip = 'unset') {
       if (id != focused) return;
 
       fetching = focused;
-      fetch_file = '';
+      fetch_file = fetch_file.slice(0, device.offset || 0);
+      fetch_lz = (device.comp == 'lz') ? lzDecoder() : null;
       post('fetch_chunk');
       reset_fetch_tout();
       break;
@@ -214,10 +324,12 @@ function parseDevice(fromID, text, conn, ip = 'unset') {
     case 'fetch_next_chunk':
       if (id != fetching) return;
 
-      fetch_file += device.data;
+      if ('offset' in device) fetch_file = fetch_file.slice(0, device.offset);
+      fetch_file += fetch_lz ? lzDecode(fetch_lz, atob(device.data)) : atob(device.data);
+      fs_retry = 0;
       if (device.chunk == device.amount - 1) {
         EL('download#' + fetch_index).style.display = 'unset';
-        EL('download#' + fetch_index).href = 'data:' + getMime(fetch_name) + ';base64,' + fetch_file;
+        EL('download#' + fetch_index).href = 'data:' + getMime(fetch_name) + ';base64,' + btoa(fetch_file);
         EL('download#' + fetch_index).download = fetch_name;
         EL('open#' + fetch_index).style.display = 'unset';
         EL('process#' + fetch_index).style.display = 'none';
@@ -240,12 +352,15 @@ function parseDevice(fromID, text, conn, ip = 'unset') {
     case 'upload_start':
       if (id != focused) return;
       uploading = focused;
+      if (device.token) upload_token = device.token;
+      startUpload(device);
       uploadNextChunk();
       reset_upload_tout();
       break;
 
     case 'upload_next_chunk':
       if (id != uploading) return;
+      fs_retry = 0;
       uploadNextChunk();
       reset_upload_tout();
       break;
@@ -269,6 +384,7 @@ function parseDevice(fromID, text, conn, ip = 'unset') {
     case 'ota_start':
       if (id != focused) return;
       uploading = focused;
+      startUpload(device);
       otaNextChunk();
       reset_ota_tout();
       break;
@@ -297,16 +413,46 @@ function parseDevice(fromID, text, conn, ip = 'unset') {
       break;
   }
 }
+// short keys (focus capability 'sk')
+const ctrl_keys = {
+  t: 'type', n: 'name', v: 'value', l: 'label', x: 'text', c: 'color', s: 'size', mn: 'min', mx: 'max', st: 'step',
+  w: 'tab_w', r: 'rows', re: 'regex', q: 'seq', h: 'height', wd: 'width', ac: 'active', p: 'prd', pt: 'port', au: 'auto', e: 'exp',
+};
+// fields the device omits when equal to these (focus capability 'def'), must match builder.h
+const ctrl_defaults = { value: '', label: '', text: '', regex: '', height: 0, prd: 0, auto: 1, exp: 0 };
+const ctrl_type_defaults = {
+  button: { size: 22 },
+  button_i: { size: 50 },
+  label: { size: 40 },
+  display: { size: 40, rows: 2 },
+  slider: { min: 0, max: 100, step: 1 },
+  spinner: { min: 0, max: 100, step: 1 },
+  gauge: { min: 0, max: 100, step: 1 },
+  canvas: { width: 400, height: 300 },
+};
+function expandControls(controls) {
+  if (!controls) return controls;
+  return controls.map(c => {
+    let ctrl = {};
+    for (let k in c) ctrl[(k in ctrl_keys) ? ctrl_keys[k] : k] = c[k];
+    let def = Object.assign({}, ctrl_defaults, ctrl_type_defaults[ctrl.type]);
+    for (let k in def) if (!(k in ctrl)) ctrl[k] = def[k];
+    return ctrl;
+  });
+}
+
 function showControls(controls) {
   EL('controls').style.visibility = 'hidden';
   EL('controls').innerHTML = '';
   if (!controls) return;
   gauges = {};
+  charts = {};
   canvases = {};
   pickers = {};
   joys = {};
   prompts = {};
   confirms = {};
+  logs = {};
   dup_names = [];
   wid_row_count = 0;
   btn_row_count = 0;
@@ -350,6 +496,7 @@ function showControls(controls) {
       case 'widget_e': endWidgets(); break;
       case 'canvas': addCanvas(ctrl); break;
       case 'gauge': addGauge(ctrl); break;
+      case 'chart': addChart(ctrl); break;
       case 'image': addImage(ctrl); break;
       case 'stream': addStream(ctrl); break;
       case 'joy': addJoy(ctrl); break;
@@ -373,6 +520,7 @@ function showControls(controls) {
     if (dup_names.length) showPopupError('Duplicated names: ' + dup_names);
     showCanvases();
     showGauges();
+    showCharts();
     showPickers();
     showJoys();
     EL('controls').style.visibility = 'visible';
@@ -290,7 +290,7 @@ function projects_h() {
   loadProjects();
 }
 function refresh_h() {
-  if (screen == 'device') post('focus');
+  if (screen == 'device') post_focus();
   else if (screen == 'info') post('info');
   else if (screen == 'fsbr') post('fsbr');
   else discover();
@@ -390,7 +390,7 @@ function open_device(id) {
       break;
 
     case Conn.MQTT:
-      post('focus');
+      post_focus();
       break;
   }
   log('Open device #' + id + ' via ' + ConnNames[devices_t[id].conn]);
@@ -178,6 +178,7 @@ function ratio() {
 
 function resize_h() {
   showGauges();
+  showCharts();
 }
 
 // ========== POPUP ==============